@@ -5,11 +5,12 @@
 
 import os
 import sys
+import time
 
 from .buildable import BuildableBindings
 from .configurable import Configurable, Option
 from .exceptions import UserException
-from .generator import parse, resolve
+from .generator import ParseCache, parse, resolve
 from .generator.outputs import (output_api, output_code, output_extract,
         output_pyi)
 from .installable import Installable
@@ -54,6 +55,9 @@ class Bindings(Configurable):
         # .sip, .pyi or .api files installed.
         Option('internal', option_type=bool),
 
+        # Set to create the Python type objects when they are first needed.
+        Option('lazy_types', option_type=bool),
+
         # The list of library names to link against.
         Option('libraries', option_type=list),
 
@@ -93,6 +97,8 @@ class Bindings(Configurable):
                 help="disable the generation of docstrings"),
         Option('pep484_pyi', option_type=bool,
                 help="enable the generation of PEP 484 .pyi files"),
+        Option('precompiled_header', option_type=bool,
+                help="precompile the internal API header"),
         Option('protected_is_public', option_type=bool,
                 help="enable the protected/public hack (default on non-Windows)"),
         Option('protected_is_public', option_type=bool, inverted=True,
@@ -145,10 +151,28 @@ class Bindings(Configurable):
         encoding = 'UTF-8'
 
         # Parse the input file.
+        if project.parse_cache_dir:
+            parse_cache = ParseCache(project.parse_cache_dir)
+        else:
+            parse_cache = None
+
+        start_time = time.perf_counter()
+
         spec, modules, sip_files = parse(self.sip_file, SIP_VERSION, encoding,
                 project.abi_version, self.tags, self.disabled_features,
                 self.protected_is_public, self._sip_include_dirs,
-                project.sip_module)
+                project.sip_module, cache=parse_cache)
+
+        if parse_cache is not None and project.verbose:
+            if parse_cache.hit:
+                outcome = 'hit'
+            else:
+                outcome = 'miss, %Imports reused: {0}'.format(
+                        parse_cache.imports_reused)
+
+            print("Parse cache {0} for {1} ({2:.3f}s)".format(outcome,
+                            self.sip_file, time.perf_counter() - start_time),
+                    flush=True)
 
         # Resolve the types.
         resolve(spec, modules)
@@ -10,8 +10,11 @@ from .module import resolve_abi_version
 from .toml import toml_load
 
 
-def get_bindings_configuration(abi_major, sip_file, sip_include_dirs):
-    """ Get the configuration of a set of bindings. """
+def get_bindings_configuration(abi_major, sip_file, sip_include_dirs,
+        searched=None):
+    """ Get the configuration of a set of bindings.  If searched is a list
+    then the name of every .toml file that was looked for is appended to it.
+    """
 
     # We make no assumption about the name of the .sip file but we assume that
     # the directory it is in is the name of the bindings.
@@ -22,6 +25,9 @@ def get_bindings_configuration(abi_major, sip_file, sip_include_dirs):
         toml_file = os.path.join(sip_dir, bindings_name,
                 bindings_name + '.toml')
 
+        if searched is not None:
+            searched.append(toml_file)
+
         if os.path.isfile(toml_file):
             break
     else:
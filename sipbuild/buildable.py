@@ -51,6 +51,7 @@ class BuildableFromSources(Buildable):
         self.define_macros = []
         self.sources = []
         self.headers = []
+        self.precompiled_headers = []
         self.include_dirs = []
         self.libraries = []
         self.library_dirs = []
@@ -71,6 +72,8 @@ class BuildableFromSources(Buildable):
         # Make the file names relative to the build directory.
         self.include_dirs = self._relative_names(self.include_dirs)
         self.headers = self._relative_names(self.headers)
+        self.precompiled_headers = self._relative_names(
+                self.precompiled_headers)
         self.sources = self._relative_names(self.sources)
         self.library_dirs = self._relative_names(self.library_dirs)
 
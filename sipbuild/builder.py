@@ -115,6 +115,7 @@ class Builder(AbstractBuilder):
 
         # Create a temporary directory for the wheel.
         wheel_build_dir = os.path.join(project.build_dir, 'wheel')
+        shutil.rmtree(wheel_build_dir, ignore_errors=True)
         os.mkdir(wheel_build_dir)
 
         # Build the wheel contents.
@@ -14,6 +14,7 @@ from .buildable import BuildableModule
 from .builder import Builder
 from .exceptions import UserException
 from .installable import Installable
+from .precompiled_headers import precompile_headers
 
 
 class DistutilsBuilder(Builder):
@@ -118,15 +119,17 @@ class DistutilsBuilder(Builder):
 
         buildable.make_names_relative()
 
-        module_builder.extensions = [
-            Extension(buildable.fq_name, buildable.sources,
-                    define_macros=define_macros,
-                    extra_compile_args=buildable.extra_compile_args,
-                    extra_link_args=buildable.extra_link_args,
-                    extra_objects=buildable.extra_objects,
-                    include_dirs=buildable.include_dirs,
-                    libraries=buildable.libraries,
-                    library_dirs=buildable.library_dirs)]
+        extension = Extension(buildable.fq_name, buildable.sources,
+                define_macros=define_macros,
+                extra_compile_args=buildable.extra_compile_args,
+                extra_link_args=buildable.extra_link_args,
+                extra_objects=buildable.extra_objects,
+                include_dirs=buildable.include_dirs,
+                libraries=buildable.libraries,
+                library_dirs=buildable.library_dirs)
+        extension.precompiled_headers = buildable.precompiled_headers
+
+        module_builder.extensions = [extension]
 
         project.progress(
                 "Compiling the '{0}' module".format(buildable.fq_name))
@@ -162,6 +165,13 @@ class ExtensionCommand(build_ext):
 
         self._buildable = buildable
 
+    def build_extension(self, ext):
+        """ Reimplemented to precompile any headers first. """
+
+        precompile_headers(self, ext)
+
+        super().build_extension(ext)
+
     def get_ext_filename(self, ext_name):
         """ Reimplemented to handle modules that use the limited API. """
 
@@ -4,5 +4,5 @@
 
 
 # Publish the API.  This is private to the rest of sip.
-from .parser import parse
+from .parser import ParseCache, parse
 from .resolver import resolve
@@ -16,6 +16,12 @@ class ErrorLog:
 
         self._errors = []
 
+    @property
+    def has_errors(self):
+        """ Set if any errors have been logged. """
+
+        return bool(self._errors)
+
     def log(self, text, source_location=None):
         """ Log an error with an optional source location. """
 
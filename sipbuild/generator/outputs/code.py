@@ -3,6 +3,9 @@
 # Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
 
 
+from concurrent.futures import ProcessPoolExecutor
+import io
+import multiprocessing
 import os
 
 from ...exceptions import UserException
@@ -242,6 +245,23 @@ f'''
 
     # These are dependent on the specific ABI version.
     if spec.abi_version >= (13, 0):
+        # ABI v13.9 and later.
+        if spec.abi_version >= (13, 9):
+            sf.write(
+f'''#define sipParseVectorcallArgs      sipAPI_{module_name}->api_parse_vectorcall_args
+#define sipParseVectorcallPlan      sipAPI_{module_name}->api_parse_vectorcall_plan
+#define sipLookupOverloadCache      sipAPI_{module_name}->api_lookup_overload_cache
+#define sipUpdateOverloadCache      sipAPI_{module_name}->api_update_overload_cache
+#define sipStartParseDiagnosis      sipAPI_{module_name}->api_start_parse_diagnosis
+#define sipEndParseDiagnosis        sipAPI_{module_name}->api_end_parse_diagnosis
+#define sipConvertToStridedArray    sipAPI_{module_name}->api_convert_to_strided_array
+#define sipLong_AsArray             sipAPI_{module_name}->api_long_as_array
+
+#undef sipTypeAsPyTypeObject
+#define sipTypeAsPyTypeObject(td)   ((td)->td_py_type != SIP_NULLPTR ? (td)->td_py_type : sipAPI_{module_name}->api_type_as_py_type_object(td))
+#define sipTypeCheck(obj, td)       ((td)->td_py_type != SIP_NULLPTR && PyObject_TypeCheck((obj), (td)->td_py_type))
+''')
+
         # ABI v13.6 and later.
         if spec.abi_version >= (13, 6):
             sf.write(
@@ -433,6 +453,8 @@ f'    sip_import_component_module(sipModuleDict, "{mod.fq_py_name}");\n')
 def _module_code(spec, bindings, project, py_debug, buildable):
     """ Generate the C/C++ code for a module. """
 
+    global _kept_reference_keys
+
     module = spec.module
     module_name = module.py_name
     parts = bindings.concatenate
@@ -441,18 +463,7 @@ def _module_code(spec, bindings, project, py_debug, buildable):
     if source_suffix is None:
         source_suffix = '.c' if spec.c_bindings else '.cpp'
 
-    # Calculate the number of files in each part.
     if parts:
-        nr_files = 1
-
-        for iface_file in spec.iface_files:
-            if iface_file.module is module and iface_file.type is not IfaceFileType.EXCEPTION:
-                nr_files += 1
-
-        max_per_part = (nr_files + parts - 1) // parts
-        files_in_part = 1
-        this_part = 0
-
         source_name = _make_part_name(buildable, module_name, 0, source_suffix)
     else:
         source_name = os.path.join(buildable.build_dir,
@@ -538,7 +549,7 @@ void sipVEH_{module_name}_{virtual_error_handler.name}(sipSimpleWrapper *{self_n
 
     for klass in module.proxies:
         if len(klass.ctors) != 0:
-            _type_init(sf, spec, bindings, klass)
+            _type_init(sf, spec, bindings, klass, extender=True)
             init_extenders = True
 
         for member in klass.members:
@@ -1064,10 +1075,13 @@ f'''    {module.nr_typedefs},
             (_abi_has_next_exception_handler(spec) and bindings.exceptions and module.nr_exceptions > 0),
             'sipExceptionHandler_' + module_name)
 
-    sf.write(
-f'''    {exception_handler},
-}};
-''')
+    sf.write(f'    {exception_handler},\n')
+
+    if spec.abi_version >= (13, 9):
+        module_flags = 'SIP_MODULE_LAZY_TYPES' if bindings.lazy_types else '0'
+        sf.write(f'    {module_flags},\n')
+
+    sf.write('};\n')
 
     _module_docstring(sf, module)
 
@@ -1220,43 +1234,300 @@ f'''
 ''')
 
     # Generate the interface source files.
-    for iface_file in spec.iface_files:
-        if iface_file.module is module and iface_file.type is not IfaceFileType.EXCEPTION:
-            need_postinc = False
-            use_sf = None
+    iface_file_nrs = [iface_file_nr
+            for iface_file_nr, iface_file in enumerate(spec.iface_files)
+                    if iface_file.module is module and iface_file.type is not IfaceFileType.EXCEPTION]
+
+    # The keys of kept references are allocated before any interface file is
+    # generated so that they don't depend on the order in which they are
+    # generated.
+    _kept_reference_keys = _allocate_kept_reference_keys(spec, iface_file_nrs)
+
+    # The interface files are independent of each other so, unless they are
+    # being concatenated, they can be generated by worker processes that
+    # inherit the resolved specification.
+    can_fork = 'fork' in multiprocessing.get_all_start_methods()
+
+    try:
+        if parts:
+            sf = _iface_files_cpp_in_parts(sf, spec, bindings, project,
+                    buildable, py_debug, source_suffix, iface_file_nrs, parts)
+        elif project.jobs > 1 and len(iface_file_nrs) > 1 and can_fork:
+            _iface_files_cpp_in_parallel(spec, bindings, project, buildable,
+                    py_debug, source_suffix, iface_file_nrs)
+        else:
+            for iface_file_nr in iface_file_nrs:
+                _iface_file_cpp(spec, bindings, project, buildable, py_debug,
+                        spec.iface_files[iface_file_nr], False, source_suffix,
+                        None)
+    finally:
+        _kept_reference_keys = None
 
-            if parts:
-                if files_in_part == max_per_part:
-                    # Close the old part.
-                    sf.close()
+    sf.close()
 
-                    # Create a new one.
-                    files_in_part = 1
-                    this_part += 1
+    header_name = os.path.join(buildable.build_dir, f'sipAPI{module_name}.h')
 
-                    source_name = _make_part_name(buildable, module_name,
-                            this_part, source_suffix)
-                    sf = CompilationUnit(source_name, "Module code.", module,
-                            project, buildable)
+    with SourceFile(header_name, "Internal module API header file.", module, project, buildable.headers) as sf:
+        _internal_api_header(sf, spec, bindings, py_debug, name_cache_list)
 
-                    need_postinc = True
-                else:
-                    files_in_part += 1
+    # The internal API header is included by every part or interface file so
+    # it is worth precompiling.
+    if bindings.precompiled_header:
+        buildable.precompiled_headers.append(header_name)
 
-                if iface_file.file_extension is None:
-                    # The interface file should use this source file rather
-                    # than create one of its own.
-                    use_sf = sf
 
+def _iface_files_cpp_in_parts(sf, spec, bindings, project, buildable,
+        py_debug, source_suffix, iface_file_nrs, parts):
+    """ Generate the C/C++ code for a number of interfaces concatenated into a
+    number of parts and return the last part.  sf is the first part which
+    already contains the module code.  The interfaces are distributed according
+    to an estimate of the size of their generated code so that no one part
+    dominates the time taken to compile them all.
+    """
+
+    module = spec.module
+
+    # Interfaces with a specific file extension still get a file of their own.
+    iface_file_weights = _iface_file_weights(spec)
+    weights = {}
+
+    for iface_file_nr in iface_file_nrs:
+        iface_file = spec.iface_files[iface_file_nr]
+
+        if iface_file.file_extension is None:
+            weight = iface_file_weights.get(id(iface_file))
+            if weight is not None:
+                weights[iface_file_nr] = weight
+        else:
             _iface_file_cpp(spec, bindings, project, buildable, py_debug,
-                    iface_file, need_postinc, source_suffix, use_sf)
+                    iface_file, False, source_suffix, None)
 
-    sf.close()
+    # Assign the heaviest remaining interface to the lightest part each time.
+    # Ties are resolved by the original order so that the result is stable.
+    part_weights = [_module_weight(spec)] + [0] * (parts - 1)
+    part_iface_file_nrs = [[] for _ in range(parts)]
 
-    header_name = os.path.join(buildable.build_dir, f'sipAPI{module_name}.h')
+    for iface_file_nr in sorted(weights, key=lambda nr: weights[nr],
+            reverse=True):
+        part_nr = part_weights.index(min(part_weights))
+        part_weights[part_nr] += weights[iface_file_nr]
+        part_iface_file_nrs[part_nr].append(iface_file_nr)
 
-    with SourceFile(header_name, "Internal module API header file.", module, project, buildable.headers) as sf:
-        _internal_api_header(sf, spec, bindings, py_debug, name_cache_list)
+    this_part = 0
+
+    for part_nr, part in enumerate(part_iface_file_nrs):
+        if part_nr != 0:
+            # Don't create an empty part.
+            if not part:
+                continue
+
+            # Close the old part and create a new one.
+            sf.close()
+
+            this_part += 1
+
+            source_name = _make_part_name(buildable, module.py_name,
+                    this_part, source_suffix)
+            sf = CompilationUnit(source_name, "Module code.", module, project,
+                    buildable)
+
+        need_postinc = (part_nr != 0)
+
+        for iface_file_nr in sorted(part):
+            _iface_file_cpp(spec, bindings, project, buildable, py_debug,
+                    spec.iface_files[iface_file_nr], need_postinc,
+                    source_suffix, sf)
+
+            need_postinc = False
+
+    return sf
+
+
+def _module_weight(spec):
+    """ Return an estimate of the relative size of the generated module code.
+    """
+
+    return 1 + len(spec.module.overloads) + len(spec.virtual_handlers)
+
+
+def _iface_file_weights(spec):
+    """ Return a dict of an estimate of the relative size of the generated code
+    for each interface keyed by the id() of its interface file.  Interfaces
+    that would not have any content are omitted.  This is done in a single pass
+    so that the cost doesn't depend on the product of the number of interfaces
+    and the number of classes.
+    """
+
+    weights = {}
+    non_empty = set()
+
+    for klass in spec.classes:
+        if klass.external:
+            continue
+
+        # Protected classes are generated with the enclosing scope.
+        scope = klass.scope if klass.is_protected else klass
+        key = id(scope.iface_file)
+
+        weights[key] = weights.get(key, 0) + 1 + len(klass.ctors) + len(klass.overloads) + len(klass.virtual_overloads)
+
+        # This must be consistent with _empty_iface_file().
+        if not klass.is_hidden_namespace and not klass.is_protected:
+            non_empty.add(id(klass.iface_file))
+
+    for mapped_type in spec.mapped_types:
+        key = id(mapped_type.iface_file)
+
+        weights[key] = weights.get(key, 0) + 1 + len(mapped_type.overloads)
+        non_empty.add(key)
+
+    return {key: weight for key, weight in weights.items() if key in non_empty}
+
+
+def _iface_files_cpp_in_parallel(spec, bindings, project, buildable,
+        py_debug, source_suffix, iface_file_nrs):
+    """ Generate the C/C++ code for a number of interfaces using a pool of
+    forked worker processes.  The generated code is the same as if it had been
+    generated serially.
+    """
+
+    global _worker_state
+
+    _worker_state = (spec, bindings, project, buildable, py_debug,
+            source_suffix)
+
+    chunksize = max(1, len(iface_file_nrs) // (project.jobs * 4))
+    mp_context = multiprocessing.get_context('fork')
+
+    try:
+        with ProcessPoolExecutor(max_workers=project.jobs,
+                mp_context=mp_context) as executor:
+            results = list(executor.map(_iface_file_cpp_worker,
+                    iface_file_nrs, chunksize=chunksize))
+    finally:
+        _worker_state = None
+
+    for error, sources in results:
+        if error is not None:
+            text, detail = error
+            raise UserException(text, detail=detail)
+
+        for source_name, contents in sources:
+            buildable.sources.append(source_name)
+            _write_if_changed(source_name, contents)
+
+
+def _iface_file_cpp_worker(iface_file_nr):
+    """ Generate the C/C++ code for an interface in a worker process and return
+    a 2-tuple of any error as a (text, detail) tuple and a list of the
+    generated (source name, contents) tuples.
+    """
+
+    spec, bindings, project, buildable, py_debug, source_suffix = _worker_state
+
+    SourceFile.captured = captured = []
+
+    try:
+        _iface_file_cpp(spec, bindings, project, buildable, py_debug,
+                spec.iface_files[iface_file_nr], False, source_suffix, None)
+    except UserException as e:
+        return (e.text, e.detail), None
+    finally:
+        SourceFile.captured = None
+
+    return None, captured
+
+
+# The state inherited by the worker processes that generate interface files.
+_worker_state = None
+
+
+def _allocate_kept_reference_keys(spec, iface_file_nrs):
+    """ Allocate the keys of the kept references needed by the generated code
+    of a number of interfaces and return them as a dict.  The keys of a
+    variable are a 3-tuple of the getter's variable and self keys and the
+    setter's key keyed by the id() of the variable.  The keys of a call to a
+    virtual handler are a 2-tuple of the result key and a list of the argument
+    keys keyed by a 2-tuple of the id() of the class and of the virtual
+    overload.
+    """
+
+    keys = {}
+
+    for iface_file_nr in iface_file_nrs:
+        iface_file = spec.iface_files[iface_file_nr]
+
+        # This must be consistent with _iface_file_cpp().
+        if _empty_iface_file(spec, iface_file):
+            continue
+
+        for klass in spec.classes:
+            if klass.is_protected or klass.external:
+                continue
+
+            if klass.iface_file is iface_file:
+                _allocate_class_keys(spec, klass, keys)
+
+                for proto_klass in spec.classes:
+                    if proto_klass.is_protected and proto_klass.scope is klass:
+                        _allocate_class_keys(spec, proto_klass, keys)
+
+    return keys
+
+
+def _allocate_class_keys(spec, klass, keys):
+    """ Allocate the keys of the kept references needed by the generated code
+    of a class in the order that the code is generated.
+    """
+
+    # The calls to the virtual handlers in the virtual catchers.
+    if klass.has_shadow:
+        module = spec.module
+
+        for virtual_overload in _unique_class_virtual_overloads(spec, klass):
+            result = virtual_overload.overload.cpp_signature.result
+
+            if result is not None and result.type is ArgumentType.VOID and len(result.derefs) == 0:
+                result = None
+
+            result_key = None
+
+            if result is not None and _keep_py_reference(result):
+                result_key = _next_key(module)
+
+            arg_keys = [_next_key(module)
+                    for arg in virtual_overload.overload.cpp_signature.args
+                            if arg.is_out and _keep_py_reference(arg)]
+
+            keys[(id(klass), id(virtual_overload))] = (result_key, arg_keys)
+
+    # The variable getters and setters.
+    if klass.has_variable_handlers:
+        for variable in spec.variables:
+            if variable.scope is not klass or not variable.needs_handler:
+                continue
+
+            var_type = variable.type
+            var_key = self_key = set_key = None
+
+            if var_type.type is ArgumentType.CLASS and len(var_type.derefs) == 0 and not var_type.is_const:
+                var_key = _next_key(var_type.definition.iface_file.module)
+
+                if not variable.is_static:
+                    self_key = _next_key(variable.module)
+
+            # This must be consistent with _variable_setter().
+            can_set = _can_set_variable(variable) and variable.set_code is None
+
+            if can_set and _keep_py_reference(var_type) and not variable.is_static:
+                set_key = _next_key(variable.module)
+
+            keys[id(variable)] = (var_key, self_key, set_key)
+
+
+# The keys of the kept references allocated by _allocate_kept_reference_keys()
+# while the interface files are being generated.
+_kept_reference_keys = None
 
 
 def _name_cache_as_list(name_cache):
@@ -1565,37 +1836,55 @@ def _ordinary_function(sf, spec, bindings, member, scope=None):
     else:
         has_auto_docstring = False
 
-    if member.no_arg_parser or member.allow_keyword_args:
-        kw_fw_decl = ', PyObject *'
-        kw_decl = ', PyObject *sipKwds'
+    if _member_uses_vectorcall(spec, member):
+        args_fw_decl = 'PyObject *const *, Py_ssize_t'
+        args_decl = 'PyObject *const *sipArgs, Py_ssize_t sipNrArgs'
+
+        if member.allow_keyword_args:
+            args_fw_decl += ', PyObject *'
+            args_decl += ', PyObject *sipKwdNames'
     else:
-        kw_fw_decl = kw_decl = ''
+        args_fw_decl = 'PyObject *'
+        args_decl = 'PyObject *sipArgs'
+
+        if member.no_arg_parser or member.allow_keyword_args:
+            args_fw_decl += ', PyObject *'
+            args_decl += ', PyObject *sipKwds'
+
+    member_overloads = [o for o in overloads if o.common is member]
+
+    # The function will be called again to diagnose any failure to parse its
+    # arguments.
+    diagnose_parse = (_member_uses_vectorcall(spec, member) and
+            len(member_overloads) != 0)
 
     sip_self_unused = False
 
     if py_scope is None:
+        function_name = f'func_{member_name}'
+
         if not spec.c_bindings:
-            sf.write(f'extern "C" {{static PyObject *func_{member_name}(PyObject *, PyObject *{kw_fw_decl});}}\n')
-            sip_self = ''
+            sf.write(f'extern "C" {{static PyObject *{function_name}(PyObject *, {args_fw_decl});}}\n')
+            sip_self = 'sipSelf' if diagnose_parse else ''
         else:
             sip_self = 'sipSelf'
-            sip_self_unused = True;
-
-        sf.write(f'static PyObject *func_{member_name}(PyObject *{sip_self}, PyObject *sipArgs{kw_decl})\n')
+            sip_self_unused = not diagnose_parse
     else:
+        function_name = f'meth_{py_scope_prefix}{member_name}'
+
         if not spec.c_bindings:
-            sf.write(f'extern "C" {{static PyObject *meth_{py_scope_prefix}{member_name}(PyObject *, PyObject *{kw_fw_decl});}}\n')
+            sf.write(f'extern "C" {{static PyObject *{function_name}(PyObject *, {args_fw_decl});}}\n')
 
-        sf.write(f'static PyObject *meth_{py_scope_prefix}{member_name}(PyObject *, PyObject *sipArgs{kw_decl})\n')
+        sip_self = 'sipSelf' if diagnose_parse else ''
+
+    sf.write(f'static PyObject *{function_name}(PyObject *{sip_self}, {args_decl})\n')
 
     sf.write('{\n')
 
     need_intro = True
+    use_overload_cache = _uses_overload_cache(spec, member, member_overloads)
 
-    for overload in overloads:
-        if overload.common is not member:
-            continue
-
+    for overload_nr, overload in enumerate(member_overloads):
         if member.no_arg_parser:
             sf.write_code(overload.method_code)
             break
@@ -1603,6 +1892,9 @@ def _ordinary_function(sf, spec, bindings, member, scope=None):
         if need_intro:
             sf.write('    PyObject *sipParseErr = SIP_NULLPTR;\n')
 
+            if use_overload_cache:
+                _overload_cache_lookup(sf, member.allow_keyword_args)
+
             if sip_self_unused:
                 sf.write(
 '''
@@ -1611,9 +1903,13 @@ def _ordinary_function(sf, spec, bindings, member, scope=None):
 
             need_intro = False
 
-        _function_body(sf, spec, bindings, scope, overload)
+        _function_body(sf, spec, bindings, scope, overload,
+                overload_cache_nr=overload_nr if use_overload_cache else None)
 
     if not need_intro:
+        if diagnose_parse:
+            _parse_diagnosis(sf, function_name, member.allow_keyword_args)
+
         sf.write(
 f'''
     /* Raise an exception if the arguments couldn't be parsed. */
@@ -1790,7 +2086,21 @@ def _types_inline(sf, spec):
         else:
             ptr = '&' + variable.fq_cpp_name.as_cpp
 
-        sf.write(f'    sipAddTypeInstance({dict_name}, {py_name}, {ptr}, {_gto_name(variable.type.definition)});\n')
+        add_instance = f'sipAddTypeInstance({dict_name}, {py_name}, {ptr}, {_gto_name(variable.type.definition)})'
+
+        # From ABI v13.9 the type object of the scope may be created here and
+        # that may fail.
+        if _py_scope(variable.scope) is not None and spec.abi_version >= (13, 9):
+            sf.write(
+f'''
+    if ({add_instance} < 0)
+    {{
+        Py_DECREF(sipModule);
+        return SIP_NULLPTR;
+    }}
+''')
+        else:
+            sf.write(f'    {add_instance};\n')
 
 
 def _class_instances(sf, spec, scope=None):
@@ -2077,7 +2387,9 @@ def _iface_file_cpp(spec, bindings, project, buildable, py_debug, iface_file,
     if _empty_iface_file(spec, iface_file):
         return
 
-    if sf is None:
+    own_sf = (sf is None)
+
+    if own_sf:
         source_name = os.path.join(buildable.build_dir,
                 'sip' + iface_file.module.py_name)
 
@@ -2123,6 +2435,9 @@ def _iface_file_cpp(spec, bindings, project, buildable, py_debug, iface_file,
         if mapped_type.iface_file is iface_file:
             _mapped_type_cpp(sf, spec, bindings, mapped_type)
 
+    if own_sf:
+        sf.close()
+
 
 def _mapped_type_cpp(sf, spec, bindings, mapped_type):
     """ Generate the C++ code for a mapped type version. """
@@ -2294,6 +2609,9 @@ sipMappedTypeDef sipTypeDef_{mapped_type.iface_file.module.py_name}_{mapped_type
     if mapped_type.needs_user_state:
         flags.append('SIP_TYPE_USER_STATE')
 
+    if mapped_type.pod_type and _abi_supports_pod_types(spec):
+        flags.append('SIP_TYPE_POD')
+
     flags.append('SIP_TYPE_MAPPED')
 
     td_flags = '|'.join(flags)
@@ -2339,8 +2657,16 @@ f'''        0, SIP_NULLPTR,
     {mtd_copy},
     {mtd_release},
     {mtd_cto},
-    {mtd_cfrom}
-}};
+    {mtd_cfrom}''')
+
+    if _abi_supports_pod_types(spec):
+        mtd_sizeof = f'sizeof ({mapped_type_type})' if mapped_type.pod_type else '0'
+
+        sf.write(f''',
+    {mtd_sizeof}''')
+
+    sf.write('''
+};
 ''')
 
 
@@ -2376,6 +2702,24 @@ f'''static PyObject *convertFrom_{name}(void *sipCppV, PyObject *{xfer})
 
             sf.write('}\n')
 
+        # Generate the optional dynamic type identifier.
+        if _class_caches_subclass(spec, klass):
+            name = klass.iface_file.fq_cpp_name.as_word
+
+            sf.write(
+f'''
+
+#include <typeinfo>
+
+extern "C" {{static const void *dynamicType_{name}(void *);}}
+static const void *dynamicType_{name}(void *sipCppV)
+{{
+    {_class_from_void(spec, klass)};
+
+    return &typeid (*sipCpp);
+}}
+''')
+
     _type_definition(sf, spec, bindings, klass, py_debug)
 
 
@@ -2459,14 +2803,18 @@ def _py_method_table(sf, spec, bindings, members, scope):
         cached_py_name = _cached_name_ref(py_name)
         comma = '' if member is members[-1] else ','
 
-        if member.no_arg_parser or member.allow_keyword_args:
+        if _member_uses_vectorcall(spec, member):
             cast = 'SIP_MLMETH_CAST('
             cast_suffix = ')'
-            flags = '|METH_KEYWORDS'
+            flags = 'METH_FASTCALL|METH_KEYWORDS' if member.allow_keyword_args else 'METH_FASTCALL'
+        elif member.no_arg_parser or member.allow_keyword_args:
+            cast = 'SIP_MLMETH_CAST('
+            cast_suffix = ')'
+            flags = 'METH_VARARGS|METH_KEYWORDS'
         else:
             cast = ''
             cast_suffix = ''
-            flags = ''
+            flags = 'METH_VARARGS'
 
         if _has_member_docstring(bindings, member, scope.overloads):
             docstring = f'doc_{scope_name}_{py_name.name}'
@@ -2482,7 +2830,7 @@ static PyMethodDef methods_{scope_name}[] = {{
 
             no_intro = False
 
-        sf.write(f'    {{{cached_py_name}, {cast}meth_{scope_name}_{py_name.name}{cast_suffix}, METH_VARARGS{flags}, {docstring}}}{comma}\n')
+        sf.write(f'    {{{cached_py_name}, {cast}meth_{scope_name}_{py_name.name}{cast_suffix}, {flags}, {docstring}}}{comma}\n')
 
     if not no_intro:
         sf.write('};\n')
@@ -2581,17 +2929,9 @@ def _variable_getter(sf, spec, variable):
     # former).  Therefore the Python object wrapping the variable must keep a
     # reference to the Python object wrapping the containing class (but only if
     # the latter is non-static).
-    var_key = self_key = 0
-
-    if variable_type is ArgumentType.CLASS and len(variable.type.derefs) == 0 and not variable.type.is_const:
-        var_key = variable.type.definition.iface_file.module.next_key
-        variable.type.definition.iface_file.module.next_key -= 1
+    var_key, self_key, _ = _kept_reference_keys[id(variable)]
 
-        if not variable.is_static:
-            self_key = variable.module.next_key
-            variable.module.next_key -= 1
-
-    second_arg = 'sipPySelf' if spec.c_bindings or var_key < 0 else ''
+    second_arg = 'sipPySelf' if spec.c_bindings or var_key is not None else ''
     variable_as_word = variable.fq_cpp_name.as_word
 
     sf.write('\n\n')
@@ -2606,7 +2946,7 @@ f'''static PyObject *varget_{variable_as_word}(void *{first_arg}, PyObject *{sec
 
     if variable.get_code is not None:
         sip_py_decl = 'PyObject *sipPy'
-    elif var_key < 0:
+    elif var_key is not None:
         if variable.is_static:
             sip_py_decl = 'static PyObject *sipPy = SIP_NULLPTR'
         else:
@@ -2647,7 +2987,7 @@ f'''static PyObject *varget_{variable_as_word}(void *{first_arg}, PyObject *{sec
         return
 
     # Get any previously wrapped cached object.
-    if var_key < 0:
+    if var_key is not None:
         if variable.is_static:
             sf.write(
 '''    if (sipPy)
@@ -2688,13 +3028,13 @@ f'''    sipPy = sipGetReference(sipPySelf, {self_key});
     sf.write(';\n\n')
 
     if variable_type in (ArgumentType.CLASS, ArgumentType.MAPPED):
-        prefix_s = 'sipPy =' if var_key < 0 else 'return'
+        prefix_s = 'sipPy =' if var_key is not None else 'return'
         new_s = 'New' if needs_new else ''
         sip_val_s = _const_cast(spec, variable.type, 'sipVal')
 
         sf.write(f'    {prefix_s} sipConvertFrom{new_s}Type({sip_val_s}, {_gto_name(variable.type.definition)}, SIP_NULLPTR);\n')
 
-        if var_key < 0:
+        if var_key is not None:
             if variable.is_static:
                 ref_code = 'Py_INCREF(sipPy)'
             else:
@@ -2983,8 +3323,7 @@ f'''
     Py_INCREF(sipKeep);
 ''')
         else:
-            key = variable.module.next_key
-            variable.module.next_key -= 1
+            _, _, key = _kept_reference_keys[id(variable)]
 
             sf.write(
 f'''
@@ -3244,8 +3583,11 @@ def _py_slot(sf, spec, bindings, member, scope=None):
                 sf.write_code(overload.method_code)
     else:
         if is_inplace_number_slot(member.py_slot):
+            type_check = _type_check(spec, 'sipSelf',
+                    f'sip{prefix}_{fq_cpp_name.as_word}')
+
             sf.write(
-f'''    if (!PyObject_TypeCheck(sipSelf, sipTypeAsPyTypeObject(sip{prefix}_{fq_cpp_name.as_word})))
+f'''    if (!{type_check})
     {{
         Py_INCREF(Py_NotImplemented);
         return Py_NotImplemented;
@@ -4046,24 +4388,14 @@ def _virtual_handler_call(sf, spec, klass, virtual_overload, result):
     _restore_protected_args(protection_state)
 
     # Add extra arguments for all the references we need to keep.
-    args_keep = False
-    result_keep = False
-    saved_keys = {}
-
-    if result is not None and _keep_py_reference(result):
-        result_keep = True
-        saved_keys[result] = result.key
-        result.key = module.next_key
-        module.next_key -= 1
+    result_key, arg_keys = _kept_reference_keys[
+            (id(klass), id(virtual_overload))]
+
+    if result_key is not None:
         sf.write(', int')
 
-    for arg in overload.cpp_signature.args:
-        if arg.is_out and _keep_py_reference(arg):
-            args_keep = True
-            saved_keys[arg] = arg.key
-            arg.key = module.next_key
-            module.next_key -= 1
-            sf.write(', int')
+    for _ in arg_keys:
+        sf.write(', int')
 
     sf.write(');\n\n    ')
 
@@ -4107,16 +4439,11 @@ def _virtual_handler_call(sf, spec, klass, virtual_overload, result):
         sf.write(f', {prefix}{arg_name}')
 
     # Pass the keys to maintain the kept references.
-    if result_keep:
-        sf.write(', ' + str(result.key))
+    if result_key is not None:
+        sf.write(', ' + result_key)
 
-    if args_keep:
-        for arg in overload.cpp_signature.args:
-            if arg.is_out and _keep_py_reference(arg):
-                sf.write(', ' + str(arg.key))
-
-    for type, key in saved_keys.items():
-        type.key = key
+    for arg_key in arg_keys:
+        sf.write(', ' + arg_key)
 
     sf.write(f'){trailing};\n')
 
@@ -5485,7 +5812,7 @@ def _argument_variable(sf, spec, scope, arg, arg_nr):
                         sf.write(f'        void *{arg_name}UserState = SIP_NULLPTR;\n')
 
         elif arg.type is ArgumentType.MAPPED:
-            if not arg.definition.no_release and not arg.is_constrained:
+            if _get_convert_to_type_code(arg) is not None and not arg.definition.no_release:
                 sf.write(f'        int {arg_name}State = 0;\n')
 
                 if _type_needs_user_state(arg):
@@ -5686,6 +6013,12 @@ static sipPySlotDef slots_{klass_name}[] = {{
     if not py_debug and module.use_limited_api:
         flags.append('SIP_TYPE_LIMITED_API')
 
+    if klass.value_type and _abi_supports_vectorcall(spec):
+        flags.append('SIP_TYPE_VALUE')
+
+    if klass.gc_untracked and klass.gc_traverse_code is None and _abi_supports_vectorcall(spec):
+        flags.append('SIP_TYPE_GC_UNTRACKED')
+
     flags.append('SIP_TYPE_NAMESPACE' if klass.iface_file.type is IfaceFileType.NAMESPACE else 'SIP_TYPE_CLASS')
 
     if len(flags) == 0:
@@ -5759,7 +6092,9 @@ static sipPySlotDef slots_{klass_name}[] = {{
                     klass_name))
     class_fields.append(_class_object_ref(is_slots, 'slots', klass_name))
     class_fields.append(
-                _class_object_ref(klass.can_create, 'init_type', klass_name))
+                _class_object_ref(
+                        (klass.can_create and not _class_uses_vectorcall(spec, klass)),
+                        'init_type', klass_name))
     class_fields.append(
                 _class_object_ref((klass.gc_traverse_code is not None),
                         'traverse', klass_name))
@@ -5815,6 +6150,15 @@ static sipPySlotDef slots_{klass_name}[] = {{
         else:
             class_fields.append('0')
 
+    if _abi_supports_vectorcall(spec):
+        class_fields.append(
+                _class_object_ref(
+                        (klass.can_create and _class_uses_vectorcall(spec, klass)),
+                        'init_type', klass_name))
+        class_fields.append(
+                _class_object_ref(_class_caches_subclass(spec, klass),
+                        'dynamicType', klass_name))
+
     base_fields = ',\n        '.join(base_fields)
     container_fields = ',\n        '.join(container_fields)
     class_fields = ',\n    '.join(class_fields)
@@ -5834,6 +6178,20 @@ sipClassTypeDef sipTypeDef_{module.py_name}_{klass_name} = {{
 ''')
 
 
+def _class_caches_subclass(spec, klass):
+    """ Return True if the results of the sub-class convertors for a class are
+    cached.
+    """
+
+    if spec.c_bindings or spec.abi_version < (13, 9):
+        return False
+
+    if klass.subclass_base is None:
+        return False
+
+    return klass.subclass_base.cache_subclass
+
+
 def _class_object_ref(test, object_name, klass_name):
     """ Return an appropriate reference to a class-specific object. """
 
@@ -6009,10 +6367,13 @@ def _get_slot_name(slot_type):
     return slot_type.name.lower() + '_slot'
 
 
-def _type_init(sf, spec, bindings, klass):
-    """ Generate the initialisation function for the type. """
+def _type_init(sf, spec, bindings, klass, extender=False):
+    """ Generate the initialisation function for the type.  An __init__
+    extender always uses the tuple and dict of arguments.
+    """
 
     klass_name = klass.iface_file.fq_cpp_name.as_word
+    vectorcall = not extender and _class_uses_vectorcall(spec, klass)
 
     # See if we need to name the self and owner arguments so that we can avoid
     # a compiler warning about an unused argument.
@@ -6041,15 +6402,22 @@ def _type_init(sf, spec, bindings, klass):
 
     sf.write('\n\n')
 
+    if vectorcall:
+        args_type = 'PyObject *const *, Py_ssize_t, PyObject *'
+        args_decl = 'PyObject *const *sipArgs, Py_ssize_t sipNrArgs, PyObject *sipKwdNames'
+    else:
+        args_type = 'PyObject *, PyObject *'
+        args_decl = 'PyObject *sipArgs, PyObject *sipKwds'
+
     if not spec.c_bindings:
-        sf.write(f'extern "C" {{static void *init_type_{klass_name}(sipSimpleWrapper *, PyObject *, PyObject *, PyObject **, PyObject **, PyObject **);}}\n')
+        sf.write(f'extern "C" {{static void *init_type_{klass_name}(sipSimpleWrapper *, {args_type}, PyObject **, PyObject **, PyObject **);}}\n')
 
     sip_self = 'sipSelf' if need_self else ''
     sip_owner = 'sipOwner' if need_owner else ''
     sip_cpp_type = 'sip' + klass_name if klass.has_shadow else _scoped_class_name(spec, klass)
 
     sf.write(
-f'''static void *init_type_{klass_name}(sipSimpleWrapper *{sip_self}, PyObject *sipArgs, PyObject *sipKwds, PyObject **sipUnused, PyObject **{sip_owner}, PyObject **sipParseErr)
+f'''static void *init_type_{klass_name}(sipSimpleWrapper *{sip_self}, {args_decl}, PyObject **sipUnused, PyObject **{sip_owner}, PyObject **sipParseErr)
 {{
     {sip_cpp_type} *sipCpp = SIP_NULLPTR;
 ''')
@@ -6057,13 +6425,21 @@ f'''static void *init_type_{klass_name}(sipSimpleWrapper *{sip_self}, PyObject *
     if bindings.tracing:
         sf.write(f'\n    sipTrace(SIP_TRACE_INITS, "init_type_{klass_name}()\\n");\n')
 
+    ctors = [c for c in klass.ctors
+            if c.access_specifier is not AccessSpecifier.PRIVATE]
+    use_overload_cache = (vectorcall and
+            _uses_overload_cache(spec, None, ctors))
+
+    if use_overload_cache:
+        _overload_cache_lookup(sf, True)
+
     # Generate the code that parses the Python arguments and calls the correct
     # constructor.
-    for ctor in klass.ctors:
-        if ctor.access_specifier is AccessSpecifier.PRIVATE:
-            continue
-
-        sf.write('\n    {\n')
+    for ctor_nr, ctor in enumerate(ctors):
+        if use_overload_cache:
+            sf.write(f'\n    if (sipOverload <= {ctor_nr})\n    {{\n')
+        else:
+            sf.write('\n    {\n')
 
         if ctor.method_code is not None:
             error_flag = _need_error_flag(ctor.method_code)
@@ -6071,9 +6447,11 @@ f'''static void *init_type_{klass_name}(sipSimpleWrapper *{sip_self}, PyObject *
         else:
             error_flag = old_error_flag = False
 
-        _arg_parser(sf, spec, klass, ctor.py_signature, ctor=ctor)
+        _arg_parser(sf, spec, klass, ctor.py_signature, ctor=ctor,
+                vectorcall=vectorcall)
         _constructor_call(sf, spec, bindings, klass, ctor, error_flag,
-                old_error_flag)
+                old_error_flag,
+                overload_cache_nr=ctor_nr if use_overload_cache else None)
 
         sf.write('    }\n')
 
@@ -6216,7 +6594,7 @@ def _throw_specifier(bindings, throw_args):
 
 
 def _constructor_call(sf, spec, bindings, klass, ctor, error_flag,
-        old_error_flag):
+        old_error_flag, overload_cache_nr=None):
     """ Generate a single constructor call. """
 
     klass_name = klass.iface_file.fq_cpp_name.as_word
@@ -6224,6 +6602,9 @@ def _constructor_call(sf, spec, bindings, klass, ctor, error_flag,
 
     sf.write('        {\n')
 
+    if overload_cache_nr is not None:
+        _overload_cache_update(sf, overload_cache_nr, True)
+
     if ctor.premethod_code is not None:
         sf.write('\n')
         sf.write_code(ctor.premethod_code)
@@ -6446,20 +6827,31 @@ def _member_function(sf, spec, bindings, klass, member, original_klass):
     else:
         has_auto_docstring = False
 
-    if member.no_arg_parser or member.allow_keyword_args:
-        arg3_type = ', PyObject *'
-        arg3_decl = ', PyObject *sipKwds'
+    if _member_uses_vectorcall(spec, member):
+        args_type = 'PyObject *const *, Py_ssize_t'
+
+        if need_args:
+            args_decl = 'PyObject *const *sipArgs, Py_ssize_t sipNrArgs'
+        else:
+            args_decl = args_type
+
+        if member.allow_keyword_args:
+            args_type += ', PyObject *'
+            args_decl += ', PyObject *sipKwdNames'
     else:
-        arg3_type = ''
-        arg3_decl = ''
+        args_type = 'PyObject *'
+        args_decl = 'PyObject *sipArgs' if need_args else args_type
+
+        if member.no_arg_parser or member.allow_keyword_args:
+            args_type += ', PyObject *'
+            args_decl += ', PyObject *sipKwds'
 
     sip_self = 'sipSelf' if need_self else ''
-    sip_args = 'sipArgs' if need_args else ''
 
     if not spec.c_bindings:
-        sf.write(f'extern "C" {{static PyObject *meth_{klass_name}_{member_py_name}(PyObject *, PyObject *{arg3_type});}}\n')
+        sf.write(f'extern "C" {{static PyObject *meth_{klass_name}_{member_py_name}(PyObject *, {args_type});}}\n')
 
-    sf.write(f'static PyObject *meth_{klass_name}_{member_py_name}(PyObject *{sip_self}, PyObject *{sip_args}{arg3_decl})\n{{\n')
+    sf.write(f'static PyObject *meth_{klass_name}_{member_py_name}(PyObject *{sip_self}, {args_decl})\n{{\n')
 
     if bindings.tracing:
         sf.write(f'    sipTrace(SIP_TRACE_METHODS, "meth_{klass_name}_{member_py_name}()\\n");\n\n')
@@ -6489,7 +6881,8 @@ def _member_function(sf, spec, bindings, klass, member, original_klass):
             # Note that we would like to rename 'sipSelfWasArg' to
             # 'sipExplicitScope' but it is part of the public API.
             if spec.abi_version >= (13, 0):
-                sipself_test = f'!PyObject_TypeCheck(sipSelf, sipTypeAsPyTypeObject({_gto_name(klass)}))'
+                sipself_test = '!' + _type_check(spec, 'sipSelf',
+                        _gto_name(klass))
             else:
                 sipself_test = '!sipSelf'
 
@@ -6501,20 +6894,28 @@ def _member_function(sf, spec, bindings, klass, member, original_klass):
             # implementation can be put in a mixin and it will all work.
             sf.write('    PyObject *sipOrigSelf = sipSelf;\n')
 
-    for overload in original_klass.overloads:
-        # If we are handling one variant then we must handle them all.
-        if _skip_overload(overload, member, klass, original_klass, want_local=False):
-            continue
+    # If we are handling one variant then we must handle them all.
+    member_overloads = [o for o in original_klass.overloads
+            if not _skip_overload(o, member, klass, original_klass, want_local=False) and o.access_specifier is not AccessSpecifier.PRIVATE]
 
-        if overload.access_specifier is AccessSpecifier.PRIVATE:
-            continue
+    # An overload cache can't be used if static and non-static overloads are
+    # mixed because the outcome then also depends on how the method was
+    # called.
+    use_overload_cache = (need_args and
+            _uses_overload_cache(spec, member, member_overloads) and
+            len({o.is_static for o in member_overloads}) == 1)
 
+    if use_overload_cache:
+        _overload_cache_lookup(sf, member.allow_keyword_args)
+
+    for overload_nr, overload in enumerate(member_overloads):
         if member.no_arg_parser:
             sf.write_code(overload.method_code)
             break
 
         _function_body(sf, spec, bindings, klass, overload,
-                original_klass=original_klass)
+                original_klass=original_klass,
+                overload_cache_nr=overload_nr if use_overload_cache else None)
 
     if not member.no_arg_parser:
         sip_parse_err = 'sipParseErr' if need_args else 'SIP_NULLPTR'
@@ -6522,6 +6923,10 @@ def _member_function(sf, spec, bindings, klass, member, original_klass):
         member_py_name_ref = _cached_name_ref(member.py_name)
         docstring_ref = f'doc_{klass_name}_{member_py_name}' if has_auto_docstring else 'SIP_NULLPTR'
 
+        if need_args and _member_uses_vectorcall(spec, member):
+            _parse_diagnosis(sf, f'meth_{klass_name}_{member_py_name}',
+                    member.allow_keyword_args)
+
         sf.write(
 f'''
     sipNoMethod({sip_parse_err}, {klass_py_name_ref}, {member_py_name_ref}, {docstring_ref});
@@ -6533,8 +6938,11 @@ f'''
 
 
 def _function_body(sf, spec, bindings, scope, overload, original_klass=None,
-        dereferenced=True):
-    """ Generate the function calls for a particular overload. """
+        dereferenced=True, overload_cache_nr=None):
+    """ Generate the function calls for a particular overload.  If an
+    overload cache is being used then overload_cache_nr is the index of the
+    overload.
+    """
 
     if scope is None:
         original_scope = None
@@ -6550,7 +6958,10 @@ def _function_body(sf, spec, bindings, scope, overload, original_klass=None,
 
     py_signature = overload.py_signature
 
-    sf.write('\n    {\n')
+    if overload_cache_nr is not None:
+        sf.write(f'\n    if (sipOverload <= {overload_cache_nr})\n    {{\n')
+    else:
+        sf.write('\n    {\n')
 
     # In case we have to fiddle with it.
     py_signature_adjusted = False
@@ -6572,7 +6983,7 @@ def _function_body(sf, spec, bindings, scope, overload, original_klass=None,
         _arg_parser(sf, spec, scope, py_signature, overload=overload)
 
     _function_call(sf, spec, bindings, scope, overload, dereferenced,
-            original_scope)
+            original_scope, overload_cache_nr)
 
     sf.write('    }\n')
 
@@ -6970,7 +7381,7 @@ def _needs_heap_copy(arg, using_copy_ctor=True):
 
 
 def _function_call(sf, spec, bindings, scope, overload, dereferenced,
-        original_scope):
+        original_scope, overload_cache_nr):
     """ Generate a function call. """
 
     py_slot = overload.common.py_slot
@@ -6990,6 +7401,10 @@ def _function_call(sf, spec, bindings, scope, overload, dereferenced,
 
         return
 
+    if overload_cache_nr is not None:
+        _overload_cache_update(sf, overload_cache_nr,
+                overload.common.allow_keyword_args)
+
     # Save the full result type as we may want to fiddle with it.
     saved_result_is_const = result.is_const
 
@@ -7517,11 +7932,17 @@ def _get_number_slot_call(spec, overload, operator):
     return f'({arg0} {operator} {arg1})'
 
 
-def _arg_parser(sf, spec, scope, py_signature, ctor=None, overload=None):
+def _arg_parser(sf, spec, scope, py_signature, ctor=None, overload=None,
+        vectorcall=False):
     """ Generate the argument variables for a member
     function/constructor/operator.
     """
 
+    # Ordinary functions and methods decide for themselves if the arguments
+    # were passed using the vectorcall protocol.
+    if overload is not None and overload.common.py_slot is None:
+        vectorcall = _member_uses_vectorcall(spec, overload.common)
+
     # If the scope is just a namespace, then ignore it.
     if isinstance(scope, WrappedClass) and scope.iface_file.type is IfaceFileType.NAMESPACE:
         scope = None
@@ -7629,13 +8050,29 @@ def _arg_parser(sf, spec, scope, py_signature, ctor=None, overload=None):
             if is_ka_list:
                 sf.write('        };\n\n')
 
-        parser_function = 'sipParseKwdArgs'
         args.append('sipParseErr' if ctor is not None else '&sipParseErr')
         args.append('sipArgs')
-        args.append('sipKwds')
+
+        if vectorcall:
+            parser_function = 'sipParseVectorcallArgs'
+            args.append('sipNrArgs')
+            args.append('sipKwdNames')
+        else:
+            parser_function = 'sipParseKwdArgs'
+            args.append('sipKwds')
+
         args.append('sipKwdList' if is_ka_list else 'SIP_NULLPTR')
         args.append('sipUnused' if ctor is not None else 'SIP_NULLPTR')
 
+    elif vectorcall:
+        parser_function = 'sipParseVectorcallArgs'
+        args.append('&sipParseErr')
+        args.append('sipArgs')
+        args.append('sipNrArgs')
+        args.append('SIP_NULLPTR')
+        args.append('SIP_NULLPTR')
+        args.append('SIP_NULLPTR')
+
     else:
         single_arg = not (overload is None or overload.common.py_slot is None or is_multi_arg_slot(overload.common.py_slot))
         plural = '' if single_arg else 's'
@@ -7644,6 +8081,37 @@ def _arg_parser(sf, spec, scope, py_signature, ctor=None, overload=None):
         args.append('&sipParseErr')
         args.append('sipArg' + plural)
 
+    # See if a precompiled parse plan can be used instead of a format string.
+    if parser_function == 'sipParseVectorcallArgs' and spec.module.use_parse_plans and not ctor_needs_self:
+        plan = _parse_plan(spec, scope, py_signature, overload, handle_self,
+                ctor)
+
+        if plan is not None:
+            entries, outputs = plan
+
+            sf.write('        static const sipParsePlanDef sipPlan[] = {\n')
+
+            for kind, flags, type_ref in entries:
+                sf.write(f'            {{{kind}, {flags}, {type_ref}}},\n')
+
+            sf.write('            {sipPlanEnd, 0, SIP_NULLPTR}\n')
+            sf.write('        };\n')
+
+            args.append('sipPlan')
+
+            if len(outputs) != 0:
+                outputs = ', '.join(outputs)
+                sf.write(f'        void *sipPlanOut[] = {{{outputs}}};\n')
+                args.append('sipPlanOut')
+            else:
+                args.append('SIP_NULLPTR')
+
+            args = ', '.join(args)
+
+            sf.write(f'\n        if (sipParseVectorcallPlan({args}))\n')
+
+            return
+
     # Generate the format string.
     format_s = '"'
     optional_args = False
@@ -7946,6 +8414,183 @@ def _get_subformat_char(arg):
     return chr(ord('0') + flags)
 
 
+# The parse plan kinds of those arguments that are converted by the plan
+# parser in the same way as the format string parser.
+_PLAN_SCALAR_KINDS = {
+    ArgumentType.BOOL: 'sipPlanBool',
+    ArgumentType.INT: 'sipPlanInt',
+    ArgumentType.UINT: 'sipPlanUnsignedInt',
+    ArgumentType.SIZE: 'sipPlanSize',
+    ArgumentType.BYTE: 'sipPlanChar',
+    ArgumentType.SBYTE: 'sipPlanSignedChar',
+    ArgumentType.UBYTE: 'sipPlanUnsignedChar',
+    ArgumentType.SHORT: 'sipPlanShort',
+    ArgumentType.USHORT: 'sipPlanUnsignedShort',
+    ArgumentType.LONG: 'sipPlanLong',
+    ArgumentType.ULONG: 'sipPlanUnsignedLong',
+    ArgumentType.LONGLONG: 'sipPlanLongLong',
+    ArgumentType.ULONGLONG: 'sipPlanUnsignedLongLong',
+    ArgumentType.FLOAT: 'sipPlanFloat',
+    ArgumentType.DOUBLE: 'sipPlanDouble',
+}
+
+
+def _parse_plan(spec, scope, py_signature, overload, handle_self, ctor):
+    """ Return a 2-tuple of the entries of a parse plan and the corresponding
+    outputs for a signature or None if a plan cannot be used.
+    """
+
+    entries = []
+    outputs = []
+
+    if handle_self:
+        if overload.is_static:
+            entries.append(('sipPlanCls', '0', 'SIP_NULLPTR'))
+            outputs.append('&sipSelf')
+        else:
+            kind = 'sipPlanProtectedSelf' if overload.access_is_really_protected else 'sipPlanSelf'
+            entries.append((kind, '0', '&' + _gto_name(scope)))
+            outputs.append('&sipSelf')
+            outputs.append('&sipCpp')
+
+    optional_args = False
+
+    for arg_nr, arg in enumerate(py_signature.args):
+        if not arg.is_in:
+            continue
+
+        # Anything that needs more than a simple conversion is left to the
+        # format string parser.
+        if arg.get_wrapper or arg.key is not None or arg.array is not ArrayArgument.NONE:
+            return None
+
+        if arg.default_value is not None:
+            optional_args = True
+
+        flags = ['SIP_PLAN_OPTIONAL'] if optional_args else []
+        arg_name_ref = '&' + fmt_argument_as_name(spec, arg, arg_nr)
+
+        if arg.type is ArgumentType.ENUM:
+            if arg.is_constrained:
+                return None
+
+            if arg.definition.fq_cpp_name is None:
+                entries.append(('sipPlanInt', '|'.join(flags) or '0',
+                        'SIP_NULLPTR'))
+            else:
+                entries.append(('sipPlanEnum', '|'.join(flags) or '0',
+                        '&' + _gto_name(arg.definition)))
+
+            outputs.append(arg_name_ref)
+
+        elif arg.type in _PLAN_SCALAR_KINDS:
+            entries.append((_PLAN_SCALAR_KINDS[arg.type],
+                    '|'.join(flags) or '0', 'SIP_NULLPTR'))
+            outputs.append(arg_name_ref)
+
+        elif arg.type in (ArgumentType.CLASS, ArgumentType.MAPPED):
+            # The plan flags have the same values as the sub-format flags.
+            subformat_flags = ord(_get_subformat_char(arg)) - ord('0')
+
+            # As with the format string, a mapped type without
+            # %ConvertToTypeCode has no state.  The flag stops the plan parser
+            # expecting one and is otherwise ignored for mapped types.
+            if arg.type is ArgumentType.MAPPED and arg.definition.convert_to_type_code is None:
+                subformat_flags |= 0x08
+
+            for flag, name in ((0x01, 'DEREF'), (0x02, 'TRANSFER'),
+                    (0x04, 'TRANSFER_BACK'), (0x08, 'NO_CONVERTORS'),
+                    (0x10, 'TRANSFER_THIS')):
+                if subformat_flags & flag:
+                    flags.append('SIP_PLAN_' + name)
+
+            entries.append(('sipPlanInstance', '|'.join(flags) or '0',
+                    '&' + _gto_name(arg.definition)))
+            outputs.append(arg_name_ref)
+
+            if arg.transfer is Transfer.TRANSFER_THIS:
+                outputs.append('sipOwner' if ctor is not None else '&sipOwner')
+
+            if not subformat_flags & 0x08:
+                if arg.type is ArgumentType.MAPPED and arg.definition.no_release:
+                    outputs.append('SIP_NULLPTR')
+                else:
+                    outputs.append(arg_name_ref + 'State')
+
+                if arg.type is ArgumentType.MAPPED and arg.definition.needs_user_state:
+                    outputs.append(arg_name_ref + 'UserState')
+
+        else:
+            return None
+
+    return entries, outputs
+
+
+# The types of argument where whether or not a Python object can be converted
+# depends only on the object's type.
+_TYPE_DETERMINED_ARGS = frozenset(_PLAN_SCALAR_KINDS) | {ArgumentType.CBOOL,
+    ArgumentType.CINT, ArgumentType.CFLOAT, ArgumentType.CDOUBLE,
+    ArgumentType.ENUM, ArgumentType.PYOBJECT, ArgumentType.PYTUPLE,
+    ArgumentType.PYLIST, ArgumentType.PYDICT, ArgumentType.PYSLICE,
+    ArgumentType.PYTYPE, ArgumentType.PYCALLABLE, ArgumentType.PYBUFFER,
+    ArgumentType.PYENUM, ArgumentType.ELLIPSIS}
+
+
+def _uses_overload_cache(spec, member, overloads):
+    """ Return True if the overloads of a function (or the ctors of a class
+    if member is None) can use an overload cache.  This is the case if whether
+    or not each overload accepts a set of arguments depends only on the types
+    of those arguments.
+    """
+
+    if len(overloads) < 2:
+        return False
+
+    if member is not None and not _member_uses_vectorcall(spec, member):
+        return False
+
+    for overload in overloads:
+        for arg in overload.py_signature.args:
+            if not arg.is_in:
+                continue
+
+            if arg.array is not ArrayArgument.NONE:
+                return False
+
+            if arg.type is ArgumentType.CLASS:
+                # A class with convertors may accept other types.
+                if arg.definition.convert_to_type_code is not None and not arg.is_constrained:
+                    return False
+
+            elif arg.type not in _TYPE_DETERMINED_ARGS:
+                return False
+
+    return True
+
+
+def _overload_cache_lookup(sf, kw_args):
+    """ Generate the overload cache and the lookup of the overload to try
+    first.
+    """
+
+    sip_kwd_names = 'sipKwdNames' if kw_args else 'SIP_NULLPTR'
+
+    sf.write(
+f'''    static sipOverloadCacheDef sipOverloadCache;
+    int sipOverload = sipLookupOverloadCache(&sipOverloadCache, sipArgs, sipNrArgs, {sip_kwd_names});
+''')
+
+
+def _overload_cache_update(sf, overload_nr, kw_args):
+    """ Generate the update of the overload cache after an overload has
+    accepted the arguments.
+    """
+
+    sip_kwd_names = 'sipKwdNames' if kw_args else 'SIP_NULLPTR'
+
+    sf.write(f'            sipUpdateOverloadCache(&sipOverloadCache, {overload_nr}, sipArgs, sipNrArgs, {sip_kwd_names});\n\n')
+
+
 def _get_convert_to_type_code(type):
     """ Return a type's %ConvertToTypeCode. """
 
@@ -8628,7 +9273,10 @@ def _global_function_table_entries(sf, spec, bindings, members):
             py_name = _get_normalised_cached_name(member.py_name)
             sf.write(f'        {{sipName_{py_name}, ')
 
-            if member.no_arg_parser or member.allow_keyword_args:
+            if _member_uses_vectorcall(spec, member):
+                flags = 'METH_FASTCALL|METH_KEYWORDS' if member.allow_keyword_args else 'METH_FASTCALL'
+                sf.write(f'SIP_MLMETH_CAST(func_{member.py_name.name}), {flags}')
+            elif member.no_arg_parser or member.allow_keyword_args:
                 sf.write(f'SIP_MLMETH_CAST(func_{member.py_name.name}), METH_VARARGS|METH_KEYWORDS')
             else:
                 sf.write(f'func_{member.py_name.name}, METH_VARARGS')
@@ -8826,6 +9474,18 @@ f'''            if ({index_arg} < 0 || {index_arg} >= sipCpp->{klass.len_cpp_nam
 ''')
 
 
+def _type_check(spec, obj, gto_name):
+    """ Return the C expression that checks if a Python object is an instance
+    of a generated type.  From ABI v13.9 the type object may not have been
+    created but then the object can't be an instance of it.
+    """
+
+    if spec.abi_version >= (13, 9):
+        return f'sipTypeCheck({obj}, {gto_name})'
+
+    return f'PyObject_TypeCheck({obj}, sipTypeAsPyTypeObject({gto_name}))'
+
+
 def _abi_has_next_exception_handler(spec):
     """ Return True if the ABI implements sipNextExceptionHandler(). """
 
@@ -8846,6 +9506,69 @@ def _abi_supports_array(spec):
     return _abi_version_check(spec, (12, 11), (13, 4))
 
 
+def _abi_supports_pod_types(spec):
+    """ Return True if the ABI supports mapped types that are plain old data
+    types.
+    """
+
+    return spec.abi_version >= (13, 9)
+
+
+def _abi_supports_vectorcall(spec):
+    """ Return True if the ABI supports the vectorcall protocol. """
+
+    return spec.abi_version >= (13, 9)
+
+
+def _parse_diagnosis(sf, function_name, kw_args):
+    """ Generate the code that calls a function, whose arguments are passed
+    using the vectorcall protocol, again so that the reasons why the arguments
+    didn't match any overload are recorded.
+    """
+
+    call_args = 'sipSelf, sipArgs, sipNrArgs'
+
+    if kw_args:
+        call_args += ', sipKwdNames'
+
+    sf.write(
+f'''
+    /* Parse the arguments again to find out why they didn't match. */
+    if (sipStartParseDiagnosis(&sipParseErr))
+    {{
+        PyObject *sipRes = {function_name}({call_args});
+
+        sipEndParseDiagnosis();
+
+        return sipRes;
+    }}
+''')
+
+
+def _member_uses_vectorcall(spec, member):
+    """ Return True if a function or method is passed its arguments using the
+    vectorcall protocol.
+    """
+
+    return spec.module.use_vectorcall and not member.no_arg_parser
+
+
+def _class_uses_vectorcall(spec, klass):
+    """ Return True if a class's ctors are passed their arguments using the
+    vectorcall protocol.
+    """
+
+    if not spec.module.use_vectorcall:
+        return False
+
+    # Handwritten code may still refer to the tuple and dict of arguments.
+    for ctor in klass.ctors:
+        if _is_used_in_code(ctor.method_code, 'sipArgs') or _is_used_in_code(ctor.method_code, 'sipKwds'):
+            return False
+
+    return True
+
+
 def _abi_version_check(spec, min_12, min_13):
     """ Return True if the ABI version meets minimum version requirements. """
 
@@ -9037,6 +9760,10 @@ def _write_instances_table(sf, scope, instances, declaration_template):
 class SourceFile:
     """ The encapsulation of a source file. """
 
+    # If this is a list then the names and contents of closed source files are
+    # appended to it rather than being written.
+    captured = None
+
     def __init__(self, source_name, description, module, project, generated):
         """ Initialise the object. """
 
@@ -9058,14 +9785,23 @@ class SourceFile:
         self.close()
 
     def close(self):
-        """ Close the source file. """
+        """ Close the source file.  The file is only written if its contents
+        have changed so that its modification time is preserved otherwise.
+        """
 
+        contents = self._f.getvalue()
         self._f.close()
 
+        if self.captured is not None:
+            self.captured.append((self._source_name, contents))
+        else:
+            _write_if_changed(self._source_name, contents)
+
     def open(self, source_name, project):
         """ Open a source file and make it current. """
 
-        self._f = open(source_name, 'w', encoding='UTF-8')
+        self._source_name = source_name
+        self._f = io.StringIO()
 
         self._line_nr = 1
 
@@ -9096,7 +9832,7 @@ class SourceFile:
             self.write(f'#line {code_block.line_nr} "{self._posix_path(code_block.sip_file)}"\n')
             self.write(code_block.text)
 
-        self.write(f'#line {self._line_nr + 1} "{self._posix_path(self._f.name)}"\n')
+        self.write(f'#line {self._line_nr + 1} "{self._posix_path(self._source_name)}"\n')
 
     @staticmethod
     def _posix_path(path):
@@ -9133,3 +9869,30 @@ class CompilationUnit(SourceFile):
 
         if sip_api_file:
             self.write(f'#include "sipAPI{module.py_name}.h"\n')
+
+
+def _next_key(module):
+    """ Allocate the next key of a kept reference from a module and return it
+    as a string.
+    """
+
+    key = module.next_key
+    module.next_key -= 1
+
+    return str(key)
+
+
+def _write_if_changed(file_name, contents):
+    """ Write the contents of a file unless it already has those contents.
+    This preserves the modification time of an unchanged file.
+    """
+
+    try:
+        with open(file_name, encoding='UTF-8') as f:
+            if f.read() == contents:
+                return
+    except (OSError, UnicodeDecodeError):
+        pass
+
+    with open(file_name, 'w', encoding='UTF-8') as f:
+        f.write(contents)
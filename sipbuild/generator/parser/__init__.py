@@ -4,4 +4,5 @@
 
 
 # Publish the API.  This is private to the rest of sip.
+from .parse_cache import ParseCache
 from .parser import parse
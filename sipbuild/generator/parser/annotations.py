@@ -175,6 +175,7 @@ _ANNOTATION_TYPES = {
     'ArraySize':                boolean(),
     'AutoGen':                  name(optional=True),
     'BaseType':                 name(),
+    'CacheSubClass':            boolean(),
     'Capsule':                  boolean(),
     'Constrained':              boolean(),
     'Deprecated':               boolean(),
@@ -186,6 +187,7 @@ _ANNOTATION_TYPES = {
     'Encoding':                 string(),
     'Factory':                  boolean(),
     'FileExtension':            string(),
+    'GCUntracked':              boolean(),
     'GetWrapper':               boolean(),
     'HoldGIL':                  boolean(),
     'In':                       boolean(),
@@ -213,6 +215,7 @@ _ANNOTATION_TYPES = {
     'PostHook':                 name(),
     'PreHook':                  name(),
     'PyInt':                    boolean(),
+    'PODType':                  boolean(),
     'PyName':                   name(),
     'PyQtFlags':                integer(),
     'PyQtFlagsEnums':           string_list(),
@@ -231,5 +234,6 @@ _ANNOTATION_TYPES = {
     'TypeHintIn':               string(),
     'TypeHintOut':              string(),
     'TypeHintValue':            string(),
+    'ValueType':                boolean(),
     'VirtualErrorHandler':      name(),
 }
@@ -0,0 +1,151 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+import hashlib
+import os
+import pickle
+import sys
+
+from ...version import SIP_VERSION_STR
+
+
+class ParseCache:
+    """ Encapsulate an on-disk cache of the results of parsing .sip files.
+    There are two sorts of entry.  The first is the result of a complete parse
+    and is keyed by the arguments of the parse.  The second is the state of the
+    parser immediately after a module has been %Imported by the main module
+    and is keyed by everything that the state before the %Import depended on.
+    This means that a change to the main module doesn't mean that the modules
+    it imports have to be parsed again.  Each entry is only valid if every
+    file that it depends on is unchanged.
+    """
+
+    def __init__(self, cache_dir):
+        """ Initialise the cache. """
+
+        self.cache_dir = cache_dir
+
+        # Set if the last lookup of a complete parse found a valid entry.
+        self.hit = False
+
+        # The number of %Imports whose state was found in the cache since the
+        # last lookup of a complete parse.
+        self.imports_reused = 0
+
+    def load(self, key, tags, disabled_features):
+        """ Return the cached result of a parse or None if there was no valid
+        entry.  The tags and disabled features are updated as they would have
+        been by the parse itself.
+        """
+
+        self.hit = False
+        self.imports_reused = 0
+
+        entry = self._load_entry(key)
+        if entry is None:
+            return None
+
+        tags[:] = entry['tags']
+        disabled_features[:] = entry['disabled_features']
+
+        self.hit = True
+
+        return entry['result']
+
+    def load_import(self, key):
+        """ Return a 2-tuple of the cached state of the parser after an
+        %Import and the files that the %Import depended on, or None if there
+        was no valid entry.
+        """
+
+        entry = self._load_entry(key)
+        if entry is None:
+            return None
+
+        self.imports_reused += 1
+
+        return entry['state'], entry['dependencies']
+
+    @staticmethod
+    def make_key(*args):
+        """ Return the key of an entry derived from the arguments of a parse.
+        """
+
+        key_args = (SIP_VERSION_STR, sys.version_info[:2], os.getcwd()) + args
+
+        return hashlib.sha256(repr(key_args).encode()).hexdigest()
+
+    def save(self, key, result, dependencies, tags, disabled_features):
+        """ Save the result of a parse. """
+
+        self._save_entry(key,
+                {
+                    'dependencies': dependencies,
+                    'tags': list(tags),
+                    'disabled_features': list(disabled_features),
+                    'result': result,
+                })
+
+    def save_import(self, key, state, dependencies):
+        """ Save the state of the parser after an %Import. """
+
+        self._save_entry(key,
+                {
+                    'dependencies': dependencies,
+                    'state': state,
+                })
+
+    def _entry_file_name(self, key):
+        """ Return the name of the file containing an entry. """
+
+        return os.path.join(self.cache_dir, key + '.pickle')
+
+    def _load_entry(self, key):
+        """ Return an entry or None if there was no valid entry. """
+
+        try:
+            with open(self._entry_file_name(key), 'rb') as f:
+                entry = pickle.load(f)
+        except Exception:
+            return None
+
+        for file_name, digest in entry['dependencies'].items():
+            if self._file_digest(file_name) != digest:
+                return None
+
+        return entry
+
+    def _save_entry(self, key, entry):
+        """ Save an entry. """
+
+        # Write to a temporary file first so that a concurrent build never
+        # sees a partial entry.  A cache that can't be written is ignored.
+        entry_file_name = self._entry_file_name(key)
+        temp_file_name = '{}.{}.tmp'.format(entry_file_name, os.getpid())
+
+        try:
+            os.makedirs(self.cache_dir, exist_ok=True)
+
+            with open(temp_file_name, 'wb') as f:
+                pickle.dump(entry, f, protocol=pickle.HIGHEST_PROTOCOL)
+
+            os.replace(temp_file_name, entry_file_name)
+        except (OSError, pickle.PicklingError, RecursionError):
+            try:
+                os.remove(temp_file_name)
+            except OSError:
+                pass
+
+    @staticmethod
+    def _file_digest(file_name):
+        """ Return the SHA-256 digest of a file's contents or None if it
+        doesn't exist.
+        """
+
+        try:
+            with open(file_name, 'rb') as f:
+                return hashlib.sha256(f.read()).hexdigest()
+        except (FileNotFoundError, IsADirectoryError):
+            return None
@@ -8,13 +8,33 @@ from .parser_manager import ParserManager
 
 def parse(sip_file, hex_version, encoding, abi_version, tags,
         disabled_features, protected_is_public, include_dirs, sip_module,
-        is_strict=True):
+        is_strict=True, cache=None):
     """ Parse a .sip file and return a 3-tuple of a Specification object, a
     list of Module objects and a list of the .sip files that specify the module
-    to be generated.  A UserException is raised if there was an error.
+    to be generated.  If a ParseCache is given then a valid cached result is
+    returned if there is one, otherwise the result is added to the cache.  In
+    the latter case the cache is also used for the modules %Imported by the
+    main module.  A UserException is raised if there was an error.
     """
 
-    return ParserManager(
-            hex_version, encoding, abi_version, tags, disabled_features,
-            protected_is_public, include_dirs, sip_module, is_strict).parse(
-                    sip_file)
+    if cache is None:
+        key = None
+    else:
+        key = cache.make_key(sip_file, hex_version, encoding, abi_version,
+                tags, disabled_features, protected_is_public, include_dirs,
+                sip_module, is_strict)
+
+        result = cache.load(key, tags, disabled_features)
+        if result is not None:
+            return result
+
+    pm = ParserManager(hex_version, encoding, abi_version, tags,
+            disabled_features, protected_is_public, include_dirs, sip_module,
+            is_strict, cache=cache, cache_key=key)
+
+    result = pm.parse(sip_file)
+
+    if cache is not None:
+        cache.save(key, result, pm.dependencies, tags, disabled_features)
+
+    return result
@@ -4,7 +4,9 @@
 
 
 from functools import partial
+import hashlib
 import os
+import sys
 
 from ...bindings_configuration import get_bindings_configuration
 from ...exceptions import deprecated, UserException
@@ -37,7 +39,7 @@ class ParserManager:
 
     def __init__(self, hex_version, encoding, abi_version, tags,
             disabled_features, protected_is_public, include_dirs, sip_module,
-            is_strict):
+            is_strict, cache=None, cache_key=None):
         """ Initialise the manager. """
 
         # Create the lexer.
@@ -67,6 +69,12 @@ class ParserManager:
 
         self.c_bindings = None
         self.code_block = None
+
+        # The files that the result of the parse depends on.  Each is a map of
+        # the absolute file name to the SHA-256 digest of its contents or None
+        # if the file was looked for but didn't exist.
+        self.dependencies = {}
+
         self.module_state = None
         self.paren_depth = 0
         self.parsing_template = False
@@ -81,6 +89,9 @@ class ParserManager:
         self._protected_is_public = protected_is_public
         self._include_dirs = include_dirs
         self._template_arg_classes = []
+        self._cache = cache
+        self._cache_key = cache_key
+        self._pending_import = None
 
         self._scope_stack = []
         self._error_log = ErrorLog()
@@ -125,7 +136,10 @@ class ParserManager:
             klass.supertype = cached_name(self.spec, supertype)
 
         klass.export_derived = annotations.get('ExportDerived', False)
+        klass.cache_subclass = annotations.get('CacheSubClass', False)
+        klass.gc_untracked = annotations.get('GCUntracked', False)
         klass.mixin = annotations.get('Mixin', False)
+        klass.value_type = annotations.get('ValueType', False)
 
         file_extension = annotations.get('FileExtension')
         if file_extension is not None:
@@ -552,6 +566,7 @@ class ParserManager:
         # Configure the destructor.
         scope.dtor = self.scope_access_specifier
         scope.dtor_gil_action = self._get_gil_action(p, symbol, annotations)
+        scope.dtor_is_virtual = self.parsing_virtual
         scope.dtor_throw_args = exceptions
         scope.dtor_virtual_catcher_code = virtual_catcher_code
 
@@ -924,6 +939,11 @@ class ParserManager:
         mapped_type.no_copy_ctor = annotations.get('NoCopyCtor', False)
         mapped_type.no_default_ctor = annotations.get('NoDefaultCtor', False)
         mapped_type.no_release = annotations.get('NoRelease', False)
+        mapped_type.pod_type = annotations.get('PODType', False)
+
+        if mapped_type.pod_type and self.spec.abi_version < (13, 9):
+            self.parser_warning(p, symbol,
+                    "/PODType/ is ignored for ABI versions earlier than v13.9")
         mapped_type.type_hints = self.get_type_hints(p, symbol, annotations)
 
         if mapped_type.no_release:
@@ -1532,6 +1552,12 @@ class ParserManager:
 
         self._error_log.log(text, self.get_source_location(p, symbol))
 
+    def parser_warning(self, p, symbol, text):
+        """ Issue a warning caused by a symbol in a production. """
+
+        print("{0}: line {1}: warning: {2}".format(self._sip_file,
+                p.lineno(symbol), text), file=sys.stderr)
+
     def pop_file(self):
         """ Restore the current .sip file from the stack and make it current.
         An IndexError is raised if the stack is empty.
@@ -1563,6 +1589,10 @@ class ParserManager:
         self.module_state = self._pending_module_state
         self._pending_module_state = None
 
+        # Cache the state if we have finished an %Import by the main module.
+        if self._pending_import is not None and not self._file_stack:
+            self._cache_import()
+
     def pop_scope(self):
         """ Pop the current scope. """
 
@@ -1587,6 +1617,8 @@ class ParserManager:
         if os.path.isfile(sip_file):
             pass
         else:
+            self.dependencies.setdefault(os.path.abspath(sip_file), None)
+
             found = None
 
             # If the name is relative then check the directory containing the
@@ -1601,6 +1633,8 @@ class ParserManager:
                         found = fn
                         break
 
+                    self.dependencies.setdefault(os.path.abspath(fn), None)
+
             if found is None:
                 if not optional:
                     self.parser_error(p, symbol,
@@ -1625,6 +1659,9 @@ class ParserManager:
             return
 
         if new_module:
+            if self._import_from_cache(sip_file):
+                return
+
             old_module_state = self.module_state
             self._import_module(sip_file)
         else:
@@ -1842,6 +1879,28 @@ class ParserManager:
         else:
             self.scope.overloads.append(overload)
 
+    def _cache_import(self):
+        """ Save the state of the parser after an %Import by the main module.
+        """
+
+        key, previous_dependencies = self._pending_import
+        self._pending_import = None
+
+        # The state is never cached if there is an error to report.
+        if self._error_log.has_errors:
+            return
+
+        dependencies = {fn: digest
+                for fn, digest in self.dependencies.items()
+                        if fn not in previous_dependencies}
+
+        state = (self.spec, self.modules, self.module_state,
+                self.class_templates, self._template_arg_classes,
+                self.c_bindings, self._all_sip_files, list(self.tags),
+                list(self._disabled_features))
+
+        self._cache.save_import(key, state, dependencies)
+
     def _check_ellipsis(self, p, symbol, signature):
         """ Check any ellipsis in a signature. """
 
@@ -2074,6 +2133,50 @@ class ParserManager:
         # call_super_init defaults to False if it wasn't specified.
         module.call_super_init = bool(module_state.call_super_init)
 
+    def _import_from_cache(self, sip_file):
+        """ Restore the state of the parser from the cache if it has previously
+        %Imported a .sip file into the main module in the same state.  Return
+        True if the state was restored.  Otherwise arrange for the state to be
+        cached when the %Import has been parsed.
+        """
+
+        # Only %Imports by the main .sip file itself are cached.  The state
+        # then only depends on the arguments of the parse, the part of the main
+        # .sip file that has been read and the other files that have been read.
+        if self._cache is None or self._file_stack or not self.in_main_module:
+            return False
+
+        main_sip_file = self.module_state.sip_file
+
+        dependencies = sorted(
+                [(fn, digest) for fn, digest in self.dependencies.items()
+                        if fn != main_sip_file],
+                key=lambda d: d[0])
+
+        key = self._cache.make_key(self._cache_key, sip_file,
+                self._input[:self._lexer.lexpos], dependencies, self.tags,
+                self._disabled_features)
+
+        cached = self._cache.load_import(key)
+
+        if cached is None:
+            self._pending_import = (key, set(self.dependencies))
+            return False
+
+        state, dependencies = cached
+
+        (self.spec, self.modules, self.module_state, self.class_templates,
+                self._template_arg_classes, self.c_bindings,
+                self._all_sip_files, tags, disabled_features) = state
+
+        # These are updated in place as they belong to the caller.
+        self.tags[:] = tags
+        self._disabled_features[:] = disabled_features
+
+        self.dependencies.update(dependencies)
+
+        return True
+
     def _import_module(self, sip_file):
         """ Create a new Module object and corresponding ModuleState object for
         a .sip file and make it current.
@@ -2088,8 +2191,22 @@ class ParserManager:
         self.module_state = ModuleState(module, sip_file)
 
         # Get the configuration of the new module.
+        toml_files = []
+
         mod_tags, mod_disabled = get_bindings_configuration(
-                self.spec.abi_version[0], sip_file, self._include_dirs)
+                self.spec.abi_version[0], sip_file, self._include_dirs,
+                searched=toml_files)
+
+        for toml_file in toml_files:
+            toml_file = os.path.abspath(toml_file)
+
+            try:
+                with open(toml_file, 'rb') as f:
+                    digest = hashlib.sha256(f.read()).hexdigest()
+            except FileNotFoundError:
+                digest = None
+
+            self.dependencies.setdefault(toml_file, digest)
 
         for tag in mod_tags:
             if tag not in self.tags:
@@ -2106,10 +2223,18 @@ class ParserManager:
         """ Return the contents of the current .sip file. """
 
         try:
-            with open(sip_file, encoding=self._encoding) as f:
-                self._input = f.read()
+            with open(sip_file, 'rb') as f:
+                contents = f.read()
         except FileNotFoundError:
             raise UserException("unable to read '{0}'".format(sip_file))
+
+        self.dependencies[sip_file] = hashlib.sha256(contents).hexdigest()
+
+        # Decode the contents with the same handling of newlines as a file
+        # opened in text mode.
+        try:
+            self._input = contents.decode(self._encoding).replace('\r\n',
+                    '\n').replace('\r', '\n')
         except UnicodeDecodeError as e:
             raise UserException(
                     "'{0}' doesn't appear to use the '{1}' encoding".format(
@@ -869,6 +869,7 @@ _MAPPED_TYPE_ANNOTATIONS = (
     'NoCopyCtor',
     'NoDefaultCtor',
     'NoRelease',
+    'PODType',
     'PyName',
     'PyQtFlags',
     'TypeHint',
@@ -1069,6 +1070,24 @@ def p_module(p):
     if 'use_limited_api' in args:
         module.use_limited_api = args['use_limited_api']
 
+    if 'use_vectorcall' in args:
+        module.use_vectorcall = args['use_vectorcall']
+
+        if module.use_vectorcall:
+            if pm.spec.abi_version < (13, 9):
+                pm.parser_error(p, 1,
+                        "'use_vectorcall' is only supported for ABI v13.9 and later")
+            elif module.use_limited_api:
+                pm.parser_error(p, 1,
+                        "'use_vectorcall' cannot be used with 'use_limited_api'")
+
+    if 'use_parse_plans' in args:
+        module.use_parse_plans = args['use_parse_plans']
+
+        if module.use_parse_plans and not module.use_vectorcall:
+            pm.parser_error(p, 1,
+                    "'use_parse_plans' can only be used with 'use_vectorcall'")
+
     for directive in body:
         if isinstance(directive, tuple):
             module_state.auto_py_name_rules.append(directive)
@@ -1095,7 +1114,9 @@ def p_module_arg(p):
         | name '=' dotted_name
         | py_ssize_t_clean '=' bool_value
         | use_argument_names '=' bool_value
-        | use_limited_api '=' bool_value"""
+        | use_limited_api '=' bool_value
+        | use_parse_plans '=' bool_value
+        | use_vectorcall '=' bool_value"""
 
     pm = p.parser.pm
 
@@ -1699,11 +1720,13 @@ def p_opt_ref(p):
 _CLASS_ANNOTATIONS = (
     'Abstract',
     'AllowNone',
+    'CacheSubClass',
     'DelayDtor',
     'Deprecated',
     'ExportDerived',
     'External',
     'FileExtension',
+    'GCUntracked',
     'Metatype',
     'Mixin',
     'NoDefaultCtors',
@@ -1718,6 +1741,7 @@ _CLASS_ANNOTATIONS = (
     'TypeHintIn',
     'TypeHintOut',
     'TypeHintValue',
+    'ValueType',
     'VirtualErrorHandler',
 )
 
@@ -75,7 +75,8 @@ directive_keywords = {
     'False', 'format', 'get', 'id', 'keyword_arguments', 'language',
     'licensee', 'name', 'optional', 'order', 'remove_leading', 'set',
     'signature', 'timestamp', 'True', 'type', 'py_ssize_t_clean',
-    'use_argument_names', 'use_limited_api',
+    'use_argument_names', 'use_limited_api', 'use_parse_plans',
+    'use_vectorcall',
 }
 
 
@@ -18,8 +18,9 @@ from ..specification import (AccessSpecifier, Argument, ArgumentType,
         VirtualHandler, VirtualOverload, VisibleMember, WrappedClass)
 from ..templates import (encoded_template_name, same_template_signature,
         template_code, template_code_blocks, template_expansions)
-from ..utils import (append_iface_file, argument_as_str, cached_name,
-        find_iface_file, find_method, same_argument_type, same_base_type,
+from ..utils import (append_iface_file, argument_as_str, base_type_key,
+        build_type_index, cached_name, find_iface_file, find_method,
+        insert_mapped_type, same_argument_type, same_base_type,
         same_signature, search_typedefs)
 
 
@@ -80,6 +81,9 @@ def resolve(spec, modules):
 
         _set_mro(spec, klass, error_log)
 
+    # Index the named types now that the classes are in their final order.
+    build_type_index(spec)
+
     # Resolve the various types in the modules.
     _resolve_module(spec, spec.module, error_log, final_checks)
 
@@ -712,6 +716,14 @@ def _set_mro(spec, klass, error_log, seen=None):
 
         seen.remove(klass)
 
+        # The results of the sub-class convertors are cached using the dynamic
+        # type of an instance which requires the class to be polymorphic.
+        if klass.subclass_base is klass and klass.cache_subclass and not spec.c_bindings:
+            if not _is_polymorphic(klass):
+                error_log.log(
+                        "'{0}' must be polymorphic to specify /CacheSubClass/".format(
+                                klass.iface_file.fq_cpp_name))
+
         # If the class doesn't have an explicit meta-type then inherit from the
         # module's default.
         if klass.metatype is None and len(klass.superclasses) == 0:
@@ -765,6 +777,22 @@ def _set_mro(spec, klass, error_log, seen=None):
     spec.classes.append(klass)
 
 
+def _is_polymorphic(klass):
+    """ Return True if a class, or any of its super-classes, has a virtual
+    dtor or a virtual method.
+    """
+
+    for klass_mro in klass.mro:
+        if klass_mro.dtor_is_virtual:
+            return True
+
+        for overload in klass_mro.overloads:
+            if overload.is_virtual:
+                return True
+
+    return False
+
+
 def _resolve_typedefs(spec, mod, error_log):
     """ Resolve the base types for all typedefs of a module. """
 
@@ -1798,8 +1826,8 @@ def _resolve_instantiated_class_template(spec, type):
     for arg in template_signature.args:
         _resolve_instantiated_class_template(spec, arg)
 
-    for klass in spec.classes:
-        if klass.template is not None and klass.template.cpp_name == template.cpp_name and same_signature(spec, klass.template.types, template_signature):
+    for klass in spec.type_index.class_templates.get(template.cpp_name.base_name, ()):
+        if klass.template.cpp_name == template.cpp_name and same_signature(spec, klass.template.types, template_signature):
             type.type = ArgumentType.CLASS
             type.definition = klass
             break
@@ -1859,7 +1887,7 @@ def _instantiate_mapped_type_template(spec, mod, mapped_type_template, type,
         mapped_type.release_code = template_code(spec, used,
                 proto_mapped_type.release_code, expansions)
 
-    spec.mapped_types.insert(0, mapped_type)
+    insert_mapped_type(spec, mapped_type)
 
     _replace_template_type(mapped_type, type)
 
@@ -1912,7 +1940,7 @@ def _search_mapped_types(spec, mod, type, scoped_name=None):
         type.definition = scoped_name
         type.type = ArgumentType.DEFINED
 
-    for mapped_type in spec.mapped_types:
+    for mapped_type in spec.type_index.mapped_types.get(base_type_key(type), ()):
         if same_base_type(mapped_type.type, type):
             break
     else:
@@ -1983,10 +2011,7 @@ def _merged_type_hints(type_hints, defaults):
 def _search_enums(spec, scoped_name, type):
     """ Search the enums for a name and resolve the type. """
 
-    for enum in spec.enums:
-        if enum.fq_cpp_name is None:
-            continue
-
+    for enum in spec.type_index.enums.get(scoped_name.base_name, ()):
         if enum.fq_cpp_name == scoped_name:
             type.type = ArgumentType.ENUM
             type.definition = enum
@@ -1998,7 +2023,7 @@ def _search_classes(spec, mod, scoped_name, type):
     type.
     """
 
-    for klass in spec.classes:
+    for klass in spec.type_index.classes.get(scoped_name.base_name, ()):
         # Ignore an external class unless it was declared in the same module as
         # the name is being used.
         if klass.external and klass.iface_file.module is not mod:
@@ -865,6 +865,9 @@ class MappedType:
     # The overloaded member functions.
     overloads: List['Overload'] = field(default_factory=list)
 
+    # Set if /PODType/ was specified.
+    pod_type: bool = False
+
     # The Python name.  It will be None for mapped type templates.
     py_name: Optional[CachedName] = None
 
@@ -1042,6 +1045,14 @@ class Module:
     # Set if the generated bindings should only use the limited Python API.
     use_limited_api: bool = False
 
+    # Set if the generated functions, methods and ctors should parse their
+    # arguments using precompiled plans where possible.
+    use_parse_plans: bool = False
+
+    # Set if the generated functions, methods and ctors should be passed their
+    # arguments using the vectorcall protocol.
+    use_vectorcall: bool = False
+
     # The interface files used by the module.
     used: List[IfaceFile] = field(default_factory=list)
 
@@ -1297,6 +1308,9 @@ class Specification:
     # The QObject class.
     pyqt_qobject: Optional['WrappedClass'] = None
 
+    # The index of the named types used to resolve names. (resolver)
+    type_index: Optional['TypeIndex'] = None
+
     # The list of typedefs.
     typedefs: List['WrappedTypedef'] = field(default_factory=list)
 
@@ -1336,6 +1350,33 @@ class ThrowArguments:
     arguments: Optional[List['WrappedException']] = None
 
 
+@dataclass
+class TypeIndex:
+    """ Encapsulate the index of the named types of a specification.  Each
+    dict maps a key derived from a C/C++ name (normally its base name) to the
+    list of corresponding types in the same order as they appear in the
+    specification.  The key is only a necessary condition for a match so every
+    candidate must still be compared in full.
+    """
+
+    # The classes keyed by base name.
+    classes: Dict[str, List['WrappedClass']] = field(default_factory=dict)
+
+    # The classes that are instantiations of a class template keyed by the
+    # base name of the template.
+    class_templates: Dict[str, List['WrappedClass']] = field(
+            default_factory=dict)
+
+    # The named enums keyed by base name.
+    enums: Dict[str, List['WrappedEnum']] = field(default_factory=dict)
+
+    # The mapped types keyed by the base type key of their type.
+    mapped_types: Dict[Any, List[MappedType]] = field(default_factory=dict)
+
+    # The typedefs keyed by base name.
+    typedefs: Dict[str, List['WrappedTypedef']] = field(default_factory=dict)
+
+
 @dataclass
 class TypeHints:
     """ Encapsulate a set of PEP 484 type hints for a type. """
@@ -1455,6 +1496,9 @@ class WrappedClass:
     # The %BIReleaseBufferCode.
     bi_release_buffer_code: Optional[CodeBlock] = None
 
+    # Set if /CacheSubClass/ was specified.
+    cache_subclass: bool = False
+
     # Set if the class has usable constructors.
     can_create: bool = False
 
@@ -1503,6 +1547,9 @@ class WrappedClass:
     # The action required on the GIL.
     dtor_gil_action: GILAction = GILAction.DEFAULT
 
+    # Set if the dtor is virtual.
+    dtor_is_virtual: bool = False
+
     # The optional dtor throw arguments.  Replace with 'noexcept' in SIP v7.
     dtor_throw_args: Optional[ThrowArguments] = None
 
@@ -1524,6 +1571,9 @@ class WrappedClass:
     # The %GCTraverseCode.
     gc_traverse_code: Optional[CodeBlock] = None
 
+    # Set if /GCUntracked/ was specified.
+    gc_untracked: bool = False
+
     # Set if /AllowNone/ was specified.
     handles_none: bool = False
 
@@ -1637,6 +1687,9 @@ class WrappedClass:
     # The type hints.
     type_hints: Optional[TypeHints] = None
 
+    # Set if /ValueType/ was specified.
+    value_type: bool = False
+
     # The name of the virtual error handler to use.
     virtual_error_handler: Optional[str] = None
 
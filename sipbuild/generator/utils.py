@@ -4,7 +4,8 @@
 
 
 from .scoped_name import ScopedName
-from .specification import ArgumentType, CachedName, IfaceFile, IfaceFileType
+from .specification import (ArgumentType, CachedName, IfaceFile,
+        IfaceFileType, TypeIndex)
 
 
 def append_iface_file(iface_file_list, iface_file):
@@ -125,6 +126,59 @@ def argument_as_str(arg):
     return s
 
 
+def base_type_key(type):
+    """ Return the key of an Argument object used to index mapped types.  Two
+    types can only be the same base type (as determined by same_base_type())
+    if they have the same key.
+    """
+
+    if type.type in (ArgumentType.CLASS, ArgumentType.MAPPED):
+        return type.definition.iface_file.fq_cpp_name.base_name
+
+    if type.type is ArgumentType.ENUM:
+        fq_cpp_name = type.definition.fq_cpp_name
+
+        return None if fq_cpp_name is None else fq_cpp_name.base_name
+
+    if type.type is ArgumentType.TEMPLATE:
+        return type.definition.cpp_name.base_name
+
+    if type.type in (ArgumentType.DEFINED, ArgumentType.STRUCT, ArgumentType.UNION):
+        return type.definition.base_name
+
+    # Any other types are the same if they are of the same type.
+    return type.type
+
+
+def build_type_index(spec):
+    """ Build the index of the named types of a specification.  This should be
+    done when the lists of those types are complete and in their final order.
+    """
+
+    spec.type_index = type_index = TypeIndex()
+
+    for klass in spec.classes:
+        type_index.classes.setdefault(klass.iface_file.fq_cpp_name.base_name,
+                []).append(klass)
+
+        if klass.template is not None:
+            type_index.class_templates.setdefault(
+                    klass.template.cpp_name.base_name, []).append(klass)
+
+    for enum in spec.enums:
+        if enum.fq_cpp_name is not None:
+            type_index.enums.setdefault(enum.fq_cpp_name.base_name,
+                    []).append(enum)
+
+    for mapped_type in spec.mapped_types:
+        type_index.mapped_types.setdefault(base_type_key(mapped_type.type),
+                []).append(mapped_type)
+
+    for typedef in spec.typedefs:
+        type_index.typedefs.setdefault(typedef.fq_cpp_name.base_name,
+                []).append(typedef)
+
+
 def cached_name(spec, name):
     """ Add a name to the cache if necessary and return the cached name. """
 
@@ -225,6 +279,18 @@ def find_method(klass, name):
     return None
 
 
+def insert_mapped_type(spec, mapped_type):
+    """ Insert a new mapped type at the start of the list of mapped types and
+    update the index if there is one.
+    """
+
+    spec.mapped_types.insert(0, mapped_type)
+
+    if spec.type_index is not None:
+        spec.type_index.mapped_types.setdefault(
+                base_type_key(mapped_type.type), []).insert(0, mapped_type)
+
+
 def normalised_scoped_name(scoped_name, scope):
     """ Convert a scoped name to a fully qualified name. """
 
@@ -466,7 +532,12 @@ def search_typedefs(spec, cpp_name, type):
     fq_cpp_name = ScopedName(cpp_name)
     fq_cpp_name.make_absolute()
 
-    for typedef in spec.typedefs:
+    if spec.type_index is None:
+        typedefs = spec.typedefs
+    else:
+        typedefs = spec.type_index.typedefs.get(fq_cpp_name.base_name, ())
+
+    for typedef in typedefs:
         if typedef.fq_cpp_name == fq_cpp_name:
             break
     else:
@@ -3,6 +3,7 @@
 # Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
 
 
+import filecmp
 import os
 import shutil
 import subprocess
@@ -67,7 +68,9 @@ def copy_sip_pyi(abi_major_version, target_dir):
 
 
 def copy_nonshared_sources(abi_major_version, target_dir):
-    """ Copy the module sources as a non-shared module. """
+    """ Copy the module sources as a non-shared module.  A file that is
+    already up to date isn't copied so that its modification time is preserved.
+    """
 
     # Copy the patched sip.h.
     copy_sip_h(abi_major_version, target_dir)
@@ -80,7 +83,9 @@ def copy_nonshared_sources(abi_major_version, target_dir):
         if fn.endswith('.c') or fn.endswith('.cpp') or fn.endswith('.h'):
             src_fn = os.path.join(module_source_dir, fn)
             dst_fn = os.path.join(target_dir, fn)
-            shutil.copyfile(src_fn, dst_fn)
+
+            if not os.path.isfile(dst_fn) or not filecmp.cmp(src_fn, dst_fn, shallow=False):
+                shutil.copyfile(src_fn, dst_fn)
 
             if not fn.endswith('.h'):
                 sources.append(dst_fn)
@@ -191,7 +196,9 @@ def _install_source_file(name, module_source_dir, target_dir, patches):
 
 
 def _install_file(name_in, name_out, patches):
-    """ Install a file. """
+    """ Install a file.  An existing file with the same contents isn't written
+    so that its modification time is preserved.
+    """
 
     # Read the file.
     with open(name_in) as f:
@@ -201,6 +208,13 @@ def _install_file(name_in, name_out, patches):
     for patch_name, patch in patches.items():
         data = data.replace(patch_name, patch)
 
-    # Write the file.
+    # Write the file if it has changed.
+    try:
+        with open(name_out) as f:
+            if f.read() == data:
+                return
+    except OSError:
+        pass
+
     with open(name_out, 'w') as f:
         f.write(data)
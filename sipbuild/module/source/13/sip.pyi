@@ -3,7 +3,8 @@
 # Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
 
 
-from typing import Any, Generic, Iterable, overload, Sequence, TypeVar, Union
+from typing import (Any, Dict, Generic, Iterable, Optional, overload,
+        Sequence, Tuple, TypeVar, Union)
 
 
 # PEP 484 has no explicit support for the buffer protocol so we just name types
@@ -31,6 +32,11 @@ _T = TypeVar('_T')
 
 class array(Sequence[_T], Generic[_T]):
 
+    @overload
+    def __init__(self, type: Union[wrappertype, str], init: int) -> None: ...
+    @overload
+    def __init__(self, type: Union[wrappertype, str], init: Union[Iterable[_T], Buffer]) -> None: ...
+
     @overload
     def __getitem__(self, key: int) -> _T: ...
     @overload
@@ -48,6 +54,8 @@ class array(Sequence[_T], Generic[_T]):
 
     def __len__(self) -> int: ...
 
+    def reshape(self, shape: Sequence[int], strides: Optional[Sequence[int]] = None) -> 'array[_T]': ...
+
 
 # The voidptr type.
 class voidptr:
@@ -66,7 +74,7 @@ class voidptr:
 
     def __setitem__(self, i: Union[int, slice], v: Buffer) -> None: ...
 
-    def asarray(self, size: int = -1) -> array[int]: ...
+    def asarray(self, size: int = -1, *, shape: Optional[Sequence[int]] = None, strides: Optional[Sequence[int]] = None) -> array[int]: ...
 
     # Python doesn't expose the capsule type.
     def ascapsule(self) -> Any: ...
@@ -91,8 +99,13 @@ def enableautoconversion(type: wrappertype, enable: bool) -> bool: ...
 def isdeleted(obj: simplewrapper) -> bool: ...
 def ispycreated(obj: simplewrapper) -> bool: ...
 def ispyowned(obj: simplewrapper) -> bool: ...
+def objectmapstats() -> Dict[str, Any]: ...
+def overloadcachestats() -> Tuple[int, int]: ...
+def resetstats() -> None: ...
 def setdeleted(obj: simplewrapper) -> None: ...
+def setfreelistsize(type: wrappertype, size: int) -> int: ...
 def settracemask(mask: int) -> None: ...
+def stats() -> Dict[str, Any]: ...
 def transferback(obj: wrapper) -> None: ...
 def transferto(obj: wrapper, owner: wrapper) -> None: ...
 def unwrapinstance(obj: simplewrapper) -> None: ...
@@ -29,22 +29,68 @@ typedef struct {
     Py_ssize_t len;
     int flags;
     PyObject *owner;
+    int ndim;
+    Py_ssize_t *shape;
 } sipArrayObject;
 
 
+/*
+ * The shape of a multi-dimensional (or strided) array is followed by its
+ * strides in the same memory block.  The shape is NULL for a one-dimensional
+ * contiguous array.
+ */
+#define ARRAY_STRIDES(a)    ((a)->shape + (a)->ndim)
+
+
+/* Storage for a single value of a fundamental type. */
+typedef union {
+    signed char s_char_t;
+    unsigned char u_char_t;
+    signed short s_short_t;
+    unsigned short u_short_t;
+    signed int s_int_t;
+    unsigned int u_int_t;
+    float float_t;
+    double double_t;
+} sipArrayValue;
+
+
+/* The supported formats of arrays of fundamental types. */
+static const char *const formats[] = {
+    "b", "B", "h", "H", "i", "I", "f", "d", NULL
+};
+
+
+static int assign_from_buffer(sipArrayObject *array, Py_ssize_t start,
+        Py_ssize_t len, PyObject *value);
 static void bad_key(PyObject *key);
 static int check_index(sipArrayObject *array, Py_ssize_t idx);
 static int check_writable(sipArrayObject *array);
 static PyObject *create_array(void *data, const sipTypeDef *td,
         const char *format, size_t stride, Py_ssize_t len, int flags,
         PyObject *owner);
+static PyObject *create_strided_array(void *data, const char *format,
+        size_t stride, int ndim, Py_ssize_t *shape, int flags,
+        PyObject *owner);
+static void convert_elements(void *dst, char dst_format, const void *src,
+        char src_format, Py_ssize_t src_stride, Py_ssize_t len);
 static void *element(sipArrayObject *array, Py_ssize_t idx);
+static int fill_array(sipArrayObject *array, PyObject *values);
+static size_t format_size(char format);
+static int get_extent(int ndim, const Py_ssize_t *shape,
+        const Py_ssize_t *strides, Py_ssize_t itemsize, Py_ssize_t *lo,
+        Py_ssize_t *hi);
 static void *get_slice(sipArrayObject *array, PyObject *value, Py_ssize_t len);
 static const char *get_type_name(sipArrayObject *array);
-static void *get_value(sipArrayObject *array, PyObject *value);
+static void *get_value(sipArrayObject *array, PyObject *value,
+        sipArrayValue *storage);
 static void init_array(sipArrayObject *array, void *data, const sipTypeDef *td,
         const char *format, size_t stride, Py_ssize_t len, int flags,
         PyObject *owner);
+static int is_contiguous(int ndim, const Py_ssize_t *shape,
+        const Py_ssize_t *strides, Py_ssize_t itemsize, char order);
+static Py_ssize_t *parse_shape(PyObject *shape_obj, PyObject *strides_obj,
+        Py_ssize_t itemsize, int *ndimp);
 
 
 /*
@@ -70,6 +116,25 @@ static PyObject *sipArray_item(PyObject *self, Py_ssize_t idx)
 
     data = element(array, idx);
 
+    /* An element of a multi-dimensional array is a sub-array. */
+    if (array->ndim > 1)
+    {
+        Py_ssize_t *shape;
+        int i, ndim = array->ndim - 1;
+
+        if ((shape = PyMem_New(Py_ssize_t, 2 * ndim)) == NULL)
+            return PyErr_NoMemory();
+
+        for (i = 0; i < ndim; ++i)
+        {
+            shape[i] = array->shape[i + 1];
+            shape[ndim + i] = ARRAY_STRIDES(array)[i + 1];
+        }
+
+        return create_strided_array(data, array->format, array->stride, ndim,
+                shape, (array->flags & ~SIP_OWNS_MEMORY), array->owner);
+    }
+
     if (array->td != NULL)
     {
         py_item = sip_api_convert_from_type(data, array->td, NULL);
@@ -167,6 +232,21 @@ static PyObject *sipArray_subscript(PyObject *self, PyObject *key)
             return NULL;
         }
 
+        if (array->shape != NULL)
+        {
+            Py_ssize_t *shape;
+
+            if ((shape = PyMem_New(Py_ssize_t, 2 * array->ndim)) == NULL)
+                return PyErr_NoMemory();
+
+            memcpy(shape, array->shape, 2 * array->ndim * sizeof (Py_ssize_t));
+            shape[0] = slicelength;
+
+            return create_strided_array(element(array, start), array->format,
+                    array->stride, array->ndim, shape,
+                    (array->flags & ~SIP_OWNS_MEMORY), array->owner);
+        }
+
         return create_array(element(array, start), array->td, array->format,
                 array->stride, slicelength, (array->flags & ~SIP_OWNS_MEMORY),
                 array->owner);
@@ -186,11 +266,22 @@ static int sipArray_ass_subscript(PyObject *self, PyObject *key,
 {
     sipArrayObject *array = (sipArrayObject *)self;
     Py_ssize_t start, len;
+    sipArrayValue storage;
     void *value_data;
 
     if (check_writable(array) < 0)
         return -1;
 
+    /*
+     * Only individual elements of a one-dimensional strided array can be
+     * assigned.
+     */
+    if (array->ndim > 1 || (array->shape != NULL && !PyIndex_Check(key)))
+    {
+        PyErr_SetNone(PyExc_NotImplementedError);
+        return -1;
+    }
+
     if (PyIndex_Check(key))
     {
         start = PyNumber_AsSsize_t(key, PyExc_IndexError);
@@ -204,7 +295,7 @@ static int sipArray_ass_subscript(PyObject *self, PyObject *key,
         if (check_index(array, start) < 0)
             return -1;
 
-        if ((value_data = get_value(array, value)) == NULL)
+        if ((value_data = get_value(array, value, &storage)) == NULL)
             return -1;
 
         len = 1;
@@ -222,6 +313,10 @@ static int sipArray_ass_subscript(PyObject *self, PyObject *key,
             return -1;
         }
 
+        /* Any buffer can be assigned to an array of a fundamental type. */
+        if (array->td == NULL && PyObject_CheckBuffer(value))
+            return assign_from_buffer(array, start, len, value);
+
         if ((value_data = get_slice(array, value, len)) == NULL)
             return -1;
     }
@@ -305,7 +400,6 @@ static int sipArray_getbuffer(PyObject *self, Py_buffer *view, int flags)
     }
 
     view->buf = array->data;
-    view->len = array->len * array->stride;
     view->readonly = (array->flags & SIP_READ_ONLY);
     view->itemsize = itemsize;
 
@@ -314,20 +408,75 @@ static int sipArray_getbuffer(PyObject *self, Py_buffer *view, int flags)
         /* Note that the need for a cast is probably a Python bug. */
         view->format = (char *)format;
 
-    view->ndim = 1;
+    if (array->shape != NULL)
+    {
+        Py_ssize_t *strides = ARRAY_STRIDES(array);
+        int i;
+
+        /*
+         * Make sure the consumer can handle the layout.  A consumer that
+         * doesn't ask for the strides assumes C-contiguous memory.
+         */
+        if (((flags & PyBUF_STRIDES) != PyBUF_STRIDES || (flags & PyBUF_C_CONTIGUOUS) == PyBUF_C_CONTIGUOUS) && !is_contiguous(array->ndim, array->shape, strides, itemsize, 'C'))
+        {
+            PyErr_SetString(PyExc_BufferError,
+                    _SIP_MODULE_FQ_NAME ".array object is not C-contiguous");
+            goto release;
+        }
+
+        if ((flags & PyBUF_F_CONTIGUOUS) == PyBUF_F_CONTIGUOUS && !is_contiguous(array->ndim, array->shape, strides, itemsize, 'F'))
+        {
+            PyErr_SetString(PyExc_BufferError,
+                    _SIP_MODULE_FQ_NAME ".array object is not Fortran-contiguous");
+            goto release;
+        }
+
+        if ((flags & PyBUF_ANY_CONTIGUOUS) == PyBUF_ANY_CONTIGUOUS && !is_contiguous(array->ndim, array->shape, strides, itemsize, 'C') && !is_contiguous(array->ndim, array->shape, strides, itemsize, 'F'))
+        {
+            PyErr_SetString(PyExc_BufferError,
+                    _SIP_MODULE_FQ_NAME ".array object is not contiguous");
+            goto release;
+        }
+
+        view->len = itemsize;
+        for (i = 0; i < array->ndim; ++i)
+            view->len *= array->shape[i];
+
+        view->ndim = array->ndim;
 
-    view->shape = NULL;
-    if ((flags & PyBUF_ND) == PyBUF_ND)
-        view->shape = &view->len;
+        view->shape = NULL;
+        if ((flags & PyBUF_ND) == PyBUF_ND)
+            view->shape = array->shape;
 
-    view->strides = NULL;
-    if ((flags & PyBUF_STRIDES) == PyBUF_STRIDES)
-        view->strides = &view->itemsize;
+        view->strides = NULL;
+        if ((flags & PyBUF_STRIDES) == PyBUF_STRIDES)
+            view->strides = strides;
+    }
+    else
+    {
+        view->len = array->len * array->stride;
+
+        view->ndim = 1;
+
+        view->shape = NULL;
+        if ((flags & PyBUF_ND) == PyBUF_ND)
+            view->shape = &view->len;
+
+        view->strides = NULL;
+        if ((flags & PyBUF_STRIDES) == PyBUF_STRIDES)
+            view->strides = &view->itemsize;
+    }
 
     view->suboffsets = NULL;
     view->internal = NULL;
 
     return 0;
+
+release:
+    view->obj = NULL;
+    Py_DECREF(self);
+
+    return -1;
 }
 
 
@@ -356,6 +505,10 @@ static void sipArray_dealloc(PyObject *self)
     {
         Py_XDECREF(array->owner);
     }
+
+    PyMem_Free(array->shape);
+
+    Py_TYPE(self)->tp_free(self);
 }
 
 
@@ -365,12 +518,66 @@ static void sipArray_dealloc(PyObject *self)
 static PyObject *sipArray_repr(PyObject *self)
 {
     sipArrayObject *array = (sipArrayObject *)self;
+    PyObject *shape, *repr;
+    int i;
+
+    if (array->ndim == 1)
+        return PyUnicode_FromFormat(_SIP_MODULE_FQ_NAME ".array(%s, %zd)",
+                get_type_name(array), array->len);
 
-    return PyUnicode_FromFormat(_SIP_MODULE_FQ_NAME ".array(%s, %zd)",
-            get_type_name(array), array->len);
+    if ((shape = PyTuple_New(array->ndim)) == NULL)
+        return NULL;
+
+    for (i = 0; i < array->ndim; ++i)
+    {
+        PyObject *dim = PyLong_FromSsize_t(array->shape[i]);
+
+        if (dim == NULL)
+        {
+            Py_DECREF(shape);
+            return NULL;
+        }
+
+        PyTuple_SET_ITEM(shape, i, dim);
+    }
+
+    repr = PyUnicode_FromFormat(_SIP_MODULE_FQ_NAME ".array(%s, %R)",
+            get_type_name(array), shape);
+
+    Py_DECREF(shape);
+
+    return repr;
+}
+
+
+/*
+ * Implement reshape() for the type.
+ */
+static PyObject *sipArray_reshape(PyObject *self, PyObject *args,
+        PyObject *kw)
+{
+#if PY_VERSION_HEX >= 0x030d0000
+    static char * const kwlist[] = {"shape", "strides", NULL};
+#else
+    static char *kwlist[] = {"shape", "strides", NULL};
+#endif
+
+    PyObject *shape, *strides = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kw, "O|O:reshape", kwlist, &shape, &strides))
+        return NULL;
+
+    return sip_array_reshape(self, shape, strides);
 }
 
 
+/* The methods data structure. */
+static PyMethodDef sipArray_Methods[] = {
+    {"reshape", (PyCFunction)sipArray_reshape, METH_VARARGS|METH_KEYWORDS, NULL},
+    {NULL, NULL, 0, NULL}
+};
+
+
 /*
  * Implement __new__ for the type.
  */
@@ -383,43 +590,156 @@ static PyObject *sipArray_new(PyTypeObject *cls, PyObject *args, PyObject *kw)
 #endif
 
     Py_ssize_t length;
-    PyObject *array, *type;
-    const sipClassTypeDef *ctd;
+    PyObject *array, *type, *init, *values;
+    const sipClassTypeDef *ctd = NULL;
+    const char *format = NULL;
+    size_t stride;
+    void *data;
+    Py_buffer view;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kw, "O!n:array", kwlist, &sipWrapperType_Type, &type, &length))
+    if (!PyArg_ParseTupleAndKeywords(args, kw, "OO:array", kwlist, &type, &init))
         return NULL;
 
-    ctd = (const sipClassTypeDef *)((sipWrapperType *)type)->wt_td;
-
-    /* We require the array delete helper which was added in ABI v13.4. */
-    if (ctd->ctd_base.td_module->em_api_minor < 4)
+    if (PyUnicode_Check(type))
     {
-        PyErr_SetString(PyExc_TypeError,
-                "a " _SIP_MODULE_FQ_NAME ".array can only be created for types using ABI v13.4 or later");
-        return NULL;
+        /* The type is the format of a fundamental type. */
+        const char *const *fmt;
+
+        for (fmt = formats; *fmt != NULL; ++fmt)
+            if (PyUnicode_CompareWithASCIIString(type, *fmt) == 0)
+                break;
+
+        if ((format = *fmt) == NULL)
+        {
+            PyErr_Format(PyExc_ValueError, "'%U' is not a supported format",
+                    type);
+            return NULL;
+        }
+
+        stride = format_size(*format);
     }
+    else if (PyObject_TypeCheck(type, &sipWrapperType_Type))
+    {
+        ctd = (const sipClassTypeDef *)((sipWrapperType *)type)->wt_td;
 
-    if (ctd->ctd_array == NULL || ctd->ctd_sizeof == 0)
+        /* We require the array delete helper which was added in ABI v13.4. */
+        if (ctd->ctd_base.td_module->em_api_minor < 4)
+        {
+            PyErr_SetString(PyExc_TypeError,
+                    "a " _SIP_MODULE_FQ_NAME ".array can only be created for types using ABI v13.4 or later");
+            return NULL;
+        }
+
+        if (ctd->ctd_array == NULL || ctd->ctd_sizeof == 0)
+        {
+            PyErr_Format(PyExc_TypeError,
+                    "a " _SIP_MODULE_FQ_NAME ".array cannot be created for '%s'",
+                    Py_TYPE(type)->tp_name);
+            return NULL;
+        }
+
+        stride = ctd->ctd_sizeof;
+    }
+    else
     {
         PyErr_Format(PyExc_TypeError,
-                "a " _SIP_MODULE_FQ_NAME ".array cannot be created for '%s'",
+                "array() argument 1 must be " _SIP_MODULE_FQ_NAME ".wrappertype or str, not %s",
                 Py_TYPE(type)->tp_name);
         return NULL;
     }
 
-    if (length < 0)
+    /* The elements are either default values or taken from an iterable. */
+    values = NULL;
+
+    if (PyIndex_Check(init))
     {
-        PyErr_SetString(PyExc_ValueError,
-                "a " _SIP_MODULE_FQ_NAME ".array length cannot be negative");
-        return NULL;
+        if ((length = PyNumber_AsSsize_t(init, PyExc_OverflowError)) == -1 && PyErr_Occurred())
+            return NULL;
+
+        if (length < 0)
+        {
+            PyErr_SetString(PyExc_ValueError,
+                    "a " _SIP_MODULE_FQ_NAME ".array length cannot be negative");
+            return NULL;
+        }
+    }
+    else if (format != NULL && PyObject_CheckBuffer(init))
+    {
+        /* The buffer is copied (and converted) after the array is created. */
+        if (PyObject_GetBuffer(init, &view, PyBUF_RECORDS_RO) < 0)
+            return NULL;
+
+        length = (view.ndim == 1 ? view.shape[0] : -1);
+        PyBuffer_Release(&view);
+
+        if (length < 0)
+        {
+            PyErr_SetString(PyExc_TypeError,
+                    "the buffer used to initialise a " _SIP_MODULE_FQ_NAME ".array must be one-dimensional");
+            return NULL;
+        }
+    }
+    else
+    {
+        /*
+         * Take a copy of the values so that converting them cannot change how
+         * many there are.
+         */
+        if ((values = PySequence_Tuple(init)) == NULL)
+            return NULL;
+
+        length = PyTuple_GET_SIZE(values);
+    }
+
+    /* Create the memory for the elements. */
+    if (ctd != NULL)
+        data = ctd->ctd_array(length);
+    else
+        data = PyMem_Calloc(length > 0 ? length : 1, stride);
+
+    if (data == NULL)
+    {
+        Py_XDECREF(values);
+        return PyErr_NoMemory();
     }
 
     /* Create the instance. */
     if ((array = cls->tp_alloc(cls, 0)) == NULL)
+    {
+        if (ctd != NULL)
+            ctd->ctd_array_delete(data);
+        else
+            PyMem_Free(data);
+
+        Py_XDECREF(values);
         return NULL;
+    }
+
+    init_array((sipArrayObject *)array, data,
+            (ctd != NULL ? &ctd->ctd_base : NULL), format, stride, length,
+            SIP_OWNS_MEMORY, NULL);
+
+    /* Set the initial values. */
+    if (values != NULL)
+    {
+        int rc = fill_array((sipArrayObject *)array, values);
+
+        Py_DECREF(values);
 
-    init_array((sipArrayObject *)array, ctd->ctd_array(length), &ctd->ctd_base,
-            NULL, ctd->ctd_sizeof, length, SIP_OWNS_MEMORY, NULL);
+        if (rc < 0)
+        {
+            Py_DECREF(array);
+            return NULL;
+        }
+    }
+    else if (format != NULL && !PyIndex_Check(init))
+    {
+        if (assign_from_buffer((sipArrayObject *)array, 0, length, init) < 0)
+        {
+            Py_DECREF(array);
+            return NULL;
+        }
+    }
 
     return array;
 }
@@ -458,7 +778,7 @@ PyTypeObject sipArray_Type = {
     0,                      /* tp_weaklistoffset */
     0,                      /* tp_iter */
     0,                      /* tp_iternext */
-    0,                      /* tp_methods */
+    sipArray_Methods,       /* tp_methods */
     0,                      /* tp_members */
     0,                      /* tp_getset */
     0,                      /* tp_base */
@@ -508,6 +828,55 @@ void sip_array_convert(PyObject *obj, void **data, Py_ssize_t *size)
 }
 
 
+/*
+ * Return a view of the memory of an array of a fundamental type with a
+ * different shape and (optionally) strides.  The view must lie within the
+ * memory of the original array.
+ */
+PyObject *sip_array_reshape(PyObject *obj, PyObject *shape_obj,
+        PyObject *strides_obj)
+{
+    sipArrayObject *array = (sipArrayObject *)obj;
+    Py_ssize_t itemsize = array->stride, lo, hi, array_lo, array_hi;
+    Py_ssize_t *shape;
+    int ndim;
+
+    if (array->td != NULL)
+    {
+        PyErr_Format(PyExc_TypeError,
+                "a " _SIP_MODULE_FQ_NAME ".array of %s cannot be reshaped",
+                get_type_name(array));
+        return NULL;
+    }
+
+    if ((shape = parse_shape(shape_obj, strides_obj, itemsize, &ndim)) == NULL)
+        return NULL;
+
+    if (array->shape != NULL)
+    {
+        /* This can't overflow because the array's shape was checked. */
+        get_extent(array->ndim, array->shape, ARRAY_STRIDES(array), itemsize,
+                &array_lo, &array_hi);
+    }
+    else
+    {
+        array_lo = 0;
+        array_hi = array->len * itemsize;
+    }
+
+    if (get_extent(ndim, shape, shape + ndim, itemsize, &lo, &hi) < 0 || lo < array_lo || hi > array_hi)
+    {
+        PyErr_SetString(PyExc_ValueError,
+                "the shape and strides extend beyond the memory of the " _SIP_MODULE_FQ_NAME ".array");
+        PyMem_Free(shape);
+        return NULL;
+    }
+
+    return create_strided_array(array->data, array->format, array->stride,
+            ndim, shape, (array->flags & ~SIP_OWNS_MEMORY), array->owner);
+}
+
+
 /*
  * Check that an array is writable.
  */
@@ -550,30 +919,25 @@ static void bad_key(PyObject *key)
 
 
 /*
- * Get the address of an element of an array.
+ * Get the address of an element (or sub-array) of an array.
  */
 static void *element(sipArrayObject *array, Py_ssize_t idx)
 {
-    return (unsigned char *)(array->data) + idx * array->stride;
+    Py_ssize_t stride;
+
+    stride = (array->shape != NULL ? ARRAY_STRIDES(array)[0] : (Py_ssize_t)array->stride);
+
+    return (unsigned char *)(array->data) + idx * stride;
 }
 
 
 /*
- * Get the address of a value that will be copied to an array.
+ * Get the address of a value that will be copied to an array.  The storage is
+ * used for the value of a fundamental type.
  */
-static void *get_value(sipArrayObject *array, PyObject *value)
+static void *get_value(sipArrayObject *array, PyObject *value,
+        sipArrayValue *storage)
 {
-    static union {
-        signed char s_char_t;
-        unsigned char u_char_t;
-        signed short s_short_t;
-        unsigned short u_short_t;
-        signed int s_int_t;
-        unsigned int u_int_t;
-        float float_t;
-        double double_t;
-    } static_data;
-
     void *data;
 
     if (array->td != NULL)
@@ -590,43 +954,43 @@ static void *get_value(sipArrayObject *array, PyObject *value)
         switch (*array->format)
         {
         case 'b':
-            static_data.s_char_t = sip_api_long_as_char(value);
-            data = &static_data.s_char_t;
+            storage->s_char_t = sip_api_long_as_char(value);
+            data = &storage->s_char_t;
             break;
 
         case 'B':
-            static_data.u_char_t = sip_api_long_as_unsigned_char(value);
-            data = &static_data.u_char_t;
+            storage->u_char_t = sip_api_long_as_unsigned_char(value);
+            data = &storage->u_char_t;
             break;
 
         case 'h':
-            static_data.s_short_t = sip_api_long_as_short(value);
-            data = &static_data.s_short_t;
+            storage->s_short_t = sip_api_long_as_short(value);
+            data = &storage->s_short_t;
             break;
 
         case 'H':
-            static_data.u_short_t = sip_api_long_as_unsigned_short(value);
-            data = &static_data.u_short_t;
+            storage->u_short_t = sip_api_long_as_unsigned_short(value);
+            data = &storage->u_short_t;
             break;
 
         case 'i':
-            static_data.s_int_t = sip_api_long_as_int(value);
-            data = &static_data.s_int_t;
+            storage->s_int_t = sip_api_long_as_int(value);
+            data = &storage->s_int_t;
             break;
 
         case 'I':
-            static_data.u_int_t = sip_api_long_as_unsigned_int(value);
-            data = &static_data.u_int_t;
+            storage->u_int_t = sip_api_long_as_unsigned_int(value);
+            data = &storage->u_int_t;
             break;
 
         case 'f':
-            static_data.float_t = (float)PyFloat_AsDouble(value);
-            data = &static_data.float_t;
+            storage->float_t = (float)PyFloat_AsDouble(value);
+            data = &storage->float_t;
             break;
 
         case 'd':
-            static_data.double_t = PyFloat_AsDouble(value);
-            data = &static_data.double_t;
+            storage->double_t = PyFloat_AsDouble(value);
+            data = &storage->double_t;
             break;
 
         default:
@@ -648,7 +1012,7 @@ static void *get_slice(sipArrayObject *array, PyObject *value, Py_ssize_t len)
 {
     sipArrayObject *other = (sipArrayObject *)value;
 
-    if (!PyObject_IsInstance(value, (PyObject *)&sipArray_Type) || array->td != other->td || strcmp(array->format, other->format) != 0)
+    if (!PyObject_IsInstance(value, (PyObject *)&sipArray_Type) || array->td != other->td)
     {
         PyErr_Format(PyExc_TypeError,
                 "can only assign another array of %s to the slice",
@@ -663,7 +1027,7 @@ static void *get_slice(sipArrayObject *array, PyObject *value, Py_ssize_t len)
         return NULL;
     }
 
-    if (other->stride == array->stride)
+    if (other->stride != array->stride)
     {
         PyErr_Format(PyExc_TypeError,
                 "the array being assigned must have stride %zu",
@@ -675,6 +1039,435 @@ static void *get_slice(sipArrayObject *array, PyObject *value, Py_ssize_t len)
 }
 
 
+/*
+ * Set the elements of a new array from a tuple of values of the same length.
+ * This avoids the overhead of assigning each element through __setitem__().
+ */
+static int fill_array(sipArrayObject *array, PyObject *values)
+{
+    sipAssignFunc assign = NULL;
+    Py_ssize_t i;
+
+    if (array->td != NULL && (assign = ((const sipClassTypeDef *)(array->td))->ctd_assign) == NULL)
+    {
+        PyErr_Format(PyExc_TypeError,
+                "a " _SIP_MODULE_FQ_NAME ".array cannot copy '%s'",
+                get_type_name(array));
+        return -1;
+    }
+
+    for (i = 0; i < array->len; ++i)
+    {
+        sipArrayValue storage;
+        void *value_data;
+
+        if ((value_data = get_value(array, PyTuple_GET_ITEM(values, i), &storage)) == NULL)
+            return -1;
+
+        if (assign != NULL)
+            assign(array->data, i, value_data);
+        else
+            memcpy(element(array, i), value_data, array->stride);
+    }
+
+    return 0;
+}
+
+
+/*
+ * Assign the contents of a one-dimensional buffer to a slice of an array of a
+ * fundamental type.  The contents are converted if the formats are different.
+ */
+static int assign_from_buffer(sipArrayObject *array, Py_ssize_t start,
+        Py_ssize_t len, PyObject *value)
+{
+    Py_buffer view;
+    const char *src_format;
+    char dst_format = *array->format;
+    void *dst, *tmp = NULL;
+    const void *src;
+    Py_ssize_t src_stride;
+    int rc = -1;
+
+    if (PyObject_GetBuffer(value, &view, PyBUF_RECORDS_RO) < 0)
+        return -1;
+
+    /* Only the native byte order and alignment is supported. */
+    if ((src_format = view.format) == NULL)
+        src_format = "B";
+    else if (*src_format == '@')
+        ++src_format;
+
+    if (view.ndim != 1)
+    {
+        PyErr_SetString(PyExc_TypeError,
+                "the buffer being assigned must be one-dimensional");
+        goto release;
+    }
+
+    if (src_format[0] == '\0' || src_format[1] != '\0' || format_size(src_format[0]) != (size_t)view.itemsize)
+    {
+        PyErr_Format(PyExc_TypeError,
+                "a buffer with format '%s' cannot be assigned to a " _SIP_MODULE_FQ_NAME ".array",
+                src_format);
+        goto release;
+    }
+
+    if (view.shape[0] != len)
+    {
+        PyErr_Format(PyExc_TypeError,
+                "the buffer being assigned must have length %zd", len);
+        goto release;
+    }
+
+    /* Be consistent with the assignment of a single value. */
+    if ((src_format[0] == 'f' || src_format[0] == 'd') && dst_format != 'f' && dst_format != 'd')
+    {
+        PyErr_Format(PyExc_TypeError,
+                "a buffer of floating point values cannot be assigned to an array of %s",
+                get_type_name(array));
+        goto release;
+    }
+
+    dst = element(array, start);
+    src = view.buf;
+    src_stride = view.strides[0];
+
+    if (src_format[0] == dst_format && (size_t)src_stride == array->stride)
+    {
+        memmove(dst, src, len * array->stride);
+    }
+    else
+    {
+        const char *src_first = (const char *)src;
+        const char *src_last = src_first + (len > 0 ? (len - 1) * src_stride : 0);
+
+        if (src_stride < 0)
+        {
+            const char *swap = src_first;
+
+            src_first = src_last;
+            src_last = swap;
+        }
+
+        /*
+         * If the source overlaps the destination then convert from a copy of
+         * it.
+         */
+        if (len > 0 && src_first < (const char *)dst + len * array->stride && (const char *)dst < src_last + view.itemsize)
+        {
+            if ((tmp = PyMem_Malloc(len * view.itemsize)) == NULL)
+            {
+                PyErr_NoMemory();
+                goto release;
+            }
+
+            convert_elements(tmp, src_format[0], src, src_format[0],
+                    src_stride, len);
+
+            src = tmp;
+            src_stride = view.itemsize;
+        }
+
+        convert_elements(dst, dst_format, src, src_format[0], src_stride, len);
+
+        PyMem_Free(tmp);
+    }
+
+    rc = 0;
+
+release:
+    PyBuffer_Release(&view);
+
+    return rc;
+}
+
+
+/*
+ * Convert a number of elements of a fundamental type to another.  The
+ * destination is contiguous.  The loops are kept simple (and specialised for a
+ * contiguous source) so that the compiler can vectorise them.
+ */
+#define CONVERT_LOOP(dst_t, src_t) \
+    { \
+        dst_t *d = (dst_t *)dst; \
+        Py_ssize_t i; \
+        if (src_stride == (Py_ssize_t)sizeof (src_t)) \
+        { \
+            const src_t *s = (const src_t *)src; \
+            for (i = 0; i < len; ++i) \
+                d[i] = (dst_t)s[i]; \
+        } \
+        else \
+        { \
+            for (i = 0; i < len; ++i) \
+                d[i] = (dst_t)*(const src_t *)((const char *)src + i * src_stride); \
+        } \
+    }
+
+#define CONVERT_FROM(dst_t) \
+    switch (src_format) \
+    { \
+    case 'b': CONVERT_LOOP(dst_t, signed char); break; \
+    case 'B': CONVERT_LOOP(dst_t, unsigned char); break; \
+    case 'h': CONVERT_LOOP(dst_t, signed short); break; \
+    case 'H': CONVERT_LOOP(dst_t, unsigned short); break; \
+    case 'i': CONVERT_LOOP(dst_t, signed int); break; \
+    case 'I': CONVERT_LOOP(dst_t, unsigned int); break; \
+    case 'f': CONVERT_LOOP(dst_t, float); break; \
+    case 'd': CONVERT_LOOP(dst_t, double); break; \
+    }
+
+static void convert_elements(void *dst, char dst_format, const void *src,
+        char src_format, Py_ssize_t src_stride, Py_ssize_t len)
+{
+    switch (dst_format)
+    {
+    case 'b': CONVERT_FROM(signed char); break;
+    case 'B': CONVERT_FROM(unsigned char); break;
+    case 'h': CONVERT_FROM(signed short); break;
+    case 'H': CONVERT_FROM(unsigned short); break;
+    case 'i': CONVERT_FROM(signed int); break;
+    case 'I': CONVERT_FROM(unsigned int); break;
+    case 'f': CONVERT_FROM(float); break;
+    case 'd': CONVERT_FROM(double); break;
+    }
+}
+
+#undef CONVERT_FROM
+#undef CONVERT_LOOP
+
+
+/*
+ * Return the size of an element of a fundamental type or 0 if the format isn't
+ * supported.
+ */
+static size_t format_size(char format)
+{
+    switch (format)
+    {
+    case 'b':
+        return sizeof (char);
+
+    case 'B':
+        return sizeof (unsigned char);
+
+    case 'h':
+        return sizeof (short);
+
+    case 'H':
+        return sizeof (unsigned short);
+
+    case 'i':
+        return sizeof (int);
+
+    case 'I':
+        return sizeof (unsigned int);
+
+    case 'f':
+        return sizeof (float);
+
+    case 'd':
+        return sizeof (double);
+    }
+
+    return 0;
+}
+
+
+/*
+ * Parse the Python objects specifying a shape and optional strides and return
+ * them in a newly allocated block, the shape followed by the strides.  If no
+ * strides are given then the array is C-contiguous.
+ */
+static Py_ssize_t *parse_shape(PyObject *shape_obj, PyObject *strides_obj,
+        Py_ssize_t itemsize, int *ndimp)
+{
+    PyObject *shape_seq, *strides_seq = NULL;
+    Py_ssize_t *shape = NULL, *strides, ndim, i;
+
+    if ((shape_seq = PySequence_Fast(shape_obj, "the shape must be a sequence of integers")) == NULL)
+        return NULL;
+
+    ndim = PySequence_Fast_GET_SIZE(shape_seq);
+
+    if (ndim < 1 || ndim > PyBUF_MAX_NDIM)
+    {
+        PyErr_Format(PyExc_ValueError,
+                "the shape must have between 1 and %d dimensions",
+                PyBUF_MAX_NDIM);
+        goto error;
+    }
+
+    if (strides_obj != Py_None)
+    {
+        if ((strides_seq = PySequence_Fast(strides_obj, "the strides must be a sequence of integers")) == NULL)
+            goto error;
+
+        if (PySequence_Fast_GET_SIZE(strides_seq) != ndim)
+        {
+            PyErr_SetString(PyExc_ValueError,
+                    "the strides must have the same number of dimensions as the shape");
+            goto error;
+        }
+    }
+
+    if ((shape = PyMem_New(Py_ssize_t, 2 * ndim)) == NULL)
+    {
+        PyErr_NoMemory();
+        goto error;
+    }
+
+    strides = shape + ndim;
+
+    for (i = 0; i < ndim; ++i)
+    {
+        Py_ssize_t dim = PyNumber_AsSsize_t(PySequence_Fast_GET_ITEM(shape_seq, i), PyExc_OverflowError);
+
+        if (dim == -1 && PyErr_Occurred())
+            goto error;
+
+        if (dim < 0)
+        {
+            PyErr_SetString(PyExc_ValueError,
+                    "the shape cannot contain negative values");
+            goto error;
+        }
+
+        shape[i] = dim;
+    }
+
+    if (strides_seq != NULL)
+    {
+        for (i = 0; i < ndim; ++i)
+        {
+            Py_ssize_t stride = PyNumber_AsSsize_t(PySequence_Fast_GET_ITEM(strides_seq, i), PyExc_OverflowError);
+
+            if (stride == -1 && PyErr_Occurred())
+                goto error;
+
+            /* This ensures that every element is properly aligned. */
+            if (stride % itemsize != 0)
+            {
+                PyErr_Format(PyExc_ValueError,
+                        "the strides must be multiples of the element size (%zd)",
+                        itemsize);
+                goto error;
+            }
+
+            strides[i] = stride;
+        }
+    }
+    else
+    {
+        Py_ssize_t stride = itemsize;
+
+        for (i = ndim - 1; i >= 0; --i)
+        {
+            strides[i] = stride;
+
+            if (shape[i] != 0 && stride > PY_SSIZE_T_MAX / shape[i])
+            {
+                PyErr_SetString(PyExc_OverflowError, "the shape is too large");
+                goto error;
+            }
+
+            stride *= shape[i];
+        }
+    }
+
+    Py_XDECREF(strides_seq);
+    Py_DECREF(shape_seq);
+
+    *ndimp = (int)ndim;
+
+    return shape;
+
+error:
+    PyMem_Free(shape);
+    Py_XDECREF(strides_seq);
+    Py_DECREF(shape_seq);
+
+    return NULL;
+}
+
+
+/*
+ * Get the range of byte offsets, relative to the first element, spanned by an
+ * array with a given shape and strides.  -1 is returned if the range can't be
+ * represented.
+ */
+static int get_extent(int ndim, const Py_ssize_t *shape,
+        const Py_ssize_t *strides, Py_ssize_t itemsize, Py_ssize_t *lo,
+        Py_ssize_t *hi)
+{
+    int i;
+
+    *lo = *hi = 0;
+
+    for (i = 0; i < ndim; ++i)
+        if (shape[i] == 0)
+            return 0;
+
+    *hi = itemsize;
+
+    for (i = 0; i < ndim; ++i)
+    {
+        Py_ssize_t span, stride = strides[i];
+
+        if (shape[i] == 1 || stride == 0)
+            continue;
+
+        if (stride > 0)
+        {
+            if (stride > (PY_SSIZE_T_MAX - *hi) / (shape[i] - 1))
+                return -1;
+
+            *hi += (shape[i] - 1) * stride;
+        }
+        else
+        {
+            span = -stride;
+
+            if (span > (PY_SSIZE_T_MAX + *lo) / (shape[i] - 1))
+                return -1;
+
+            *lo -= (shape[i] - 1) * span;
+        }
+    }
+
+    return 0;
+}
+
+
+/*
+ * Return TRUE if an array with a given shape and strides is contiguous in
+ * either C ('C') or Fortran ('F') order.
+ */
+static int is_contiguous(int ndim, const Py_ssize_t *shape,
+        const Py_ssize_t *strides, Py_ssize_t itemsize, char order)
+{
+    Py_ssize_t expected = itemsize;
+    int i;
+
+    for (i = 0; i < ndim; ++i)
+        if (shape[i] == 0)
+            return TRUE;
+
+    for (i = 0; i < ndim; ++i)
+    {
+        int dim = (order == 'C' ? ndim - 1 - i : i);
+
+        if (shape[dim] != 1 && strides[dim] != expected)
+            return FALSE;
+
+        expected *= shape[dim];
+    }
+
+    return TRUE;
+}
+
+
 /*
  * Get the name of the type of an element of an array.
  */
@@ -750,6 +1543,40 @@ static PyObject *create_array(void *data, const sipTypeDef *td,
 }
 
 
+/*
+ * Create a multi-dimensional (or strided) array of a fundamental type.  The
+ * array takes ownership of the block containing the shape and strides.
+ */
+static PyObject *create_strided_array(void *data, const char *format,
+        size_t stride, int ndim, Py_ssize_t *shape, int flags,
+        PyObject *owner)
+{
+    sipArrayObject *array;
+
+    /* A one-dimensional contiguous array doesn't need the shape. */
+    if (ndim == 1 && shape[1] == (Py_ssize_t)stride)
+    {
+        Py_ssize_t len = shape[0];
+
+        PyMem_Free(shape);
+
+        return create_array(data, NULL, format, stride, len, flags, owner);
+    }
+
+    if ((array = PyObject_NEW(sipArrayObject, &sipArray_Type)) == NULL)
+    {
+        PyMem_Free(shape);
+        return NULL;
+    }
+
+    init_array(array, data, NULL, format, stride, shape[0], flags, owner);
+    array->ndim = ndim;
+    array->shape = shape;
+
+    return (PyObject *)array;
+}
+
+
 /*
  * Initialise an array.
  */
@@ -763,6 +1590,8 @@ static void init_array(sipArrayObject *array, void *data, const sipTypeDef *td,
     array->stride = stride;
     array->len = len;
     array->flags = flags;
+    array->ndim = 1;
+    array->shape = NULL;
 
     if (flags & SIP_OWNS_MEMORY)
     {
@@ -795,43 +1624,10 @@ PyObject *sip_api_convert_to_array(void *data, const char *format,
         return Py_None;
     }
 
-    switch (*format)
+    if ((stride = format_size(*format)) == 0)
     {
-    case 'b':
-        stride = sizeof (char);
-        break;
-
-    case 'B':
-        stride = sizeof (unsigned char);
-        break;
-
-    case 'h':
-        stride = sizeof (short);
-        break;
-
-    case 'H':
-        stride = sizeof (unsigned short);
-        break;
-
-    case 'i':
-        stride = sizeof (int);
-        break;
-
-    case 'I':
-        stride = sizeof (unsigned int);
-        break;
-
-    case 'f':
-        stride = sizeof (float);
-        break;
-
-    case 'd':
-        stride = sizeof (double);
-        break;
-
-    default:
         PyErr_Format(PyExc_ValueError, "'%c' is not a supported format",
-                format);
+                *format);
         return NULL;
     }
 
@@ -856,3 +1652,59 @@ PyObject *sip_api_convert_to_typed_array(void *data, const sipTypeDef *td,
 
     return create_array(data, td, format, stride, len, flags, NULL);
 }
+
+
+/*
+ * Wrap a multi-dimensional array of instances of a fundamental type with
+ * arbitrary strides (in bytes).  If strides is NULL then the array is
+ * C-contiguous.
+ */
+PyObject *sip_api_convert_to_strided_array(void *data, const char *format,
+        int ndim, const Py_ssize_t *shape, const Py_ssize_t *strides,
+        int flags)
+{
+    size_t stride;
+    Py_ssize_t *shape_copy;
+    int i;
+
+    assert(ndim >= 1 && ndim <= PyBUF_MAX_NDIM);
+
+    if (data == NULL)
+    {
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+
+    if ((stride = format_size(*format)) == 0)
+    {
+        PyErr_Format(PyExc_ValueError, "'%c' is not a supported format",
+                *format);
+        return NULL;
+    }
+
+    if ((shape_copy = PyMem_New(Py_ssize_t, 2 * ndim)) == NULL)
+        return PyErr_NoMemory();
+
+    memcpy(shape_copy, shape, ndim * sizeof (Py_ssize_t));
+
+    if (strides != NULL)
+    {
+        memcpy(shape_copy + ndim, strides, ndim * sizeof (Py_ssize_t));
+    }
+    else
+    {
+        Py_ssize_t c_stride = stride;
+
+        for (i = ndim - 1; i >= 0; --i)
+        {
+            shape_copy[ndim + i] = c_stride;
+            c_stride *= shape[i];
+        }
+    }
+
+    for (i = 0; i < ndim; ++i)
+        assert(shape_copy[i] >= 0);
+
+    return create_strided_array(data, format, stride, ndim, shape_copy, flags,
+            NULL);
+}
@@ -29,9 +29,14 @@ PyObject *sip_api_convert_to_array(void *data, const char *format,
         Py_ssize_t len, int flags);
 PyObject *sip_api_convert_to_typed_array(void *data, const sipTypeDef *td,
         const char *format, size_t stride, Py_ssize_t len, int flags);
+PyObject *sip_api_convert_to_strided_array(void *data, const char *format,
+        int ndim, const Py_ssize_t *shape, const Py_ssize_t *strides,
+        int flags);
 
 int sip_array_can_convert(PyObject *obj, const sipTypeDef *td);
 void sip_array_convert(PyObject *obj, void **data, Py_ssize_t *size);
+PyObject *sip_array_reshape(PyObject *obj, PyObject *shape_obj,
+        PyObject *strides_obj);
 
 
 #ifdef __cplusplus
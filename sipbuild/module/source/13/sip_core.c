@@ -239,7 +239,7 @@ static sipWrapperType sipWrapper_Type = {
     0,                      /* wt_td */
     0,                      /* wt_iextend */
     0,                      /* wt_user_data */
-    0,                      /* wt_reserved */
+    0,                      /* wt_private */
 };
 
 
@@ -295,6 +295,22 @@ static int sip_api_parse_kwd_args(PyObject **parseErrp, PyObject *sipArgs,
         const char *fmt, ...);
 static int sip_api_parse_pair(PyObject **parseErrp, PyObject *sipArg0,
         PyObject *sipArg1, const char *fmt, ...);
+static int sip_api_parse_vectorcall_args(PyObject **parseErrp,
+        PyObject *const *sipArgs, Py_ssize_t sipNrArgs,
+        PyObject *sipKwdNames, const char **kwdlist, PyObject **unused,
+        const char *fmt, ...);
+static int sip_api_parse_vectorcall_plan(PyObject **parseErrp,
+        PyObject *const *sipArgs, Py_ssize_t sipNrArgs,
+        PyObject *sipKwdNames, const char **kwdlist, PyObject **unused,
+        const sipParsePlanDef *plan, void **outputs);
+static int sip_api_lookup_overload_cache(sipOverloadCacheDef *oc,
+        PyObject *const *sipArgs, Py_ssize_t sipNrArgs,
+        PyObject *sipKwdNames);
+static void sip_api_update_overload_cache(sipOverloadCacheDef *oc,
+        int overload, PyObject *const *sipArgs, Py_ssize_t sipNrArgs,
+        PyObject *sipKwdNames);
+static int sip_api_start_parse_diagnosis(PyObject **parseErrp);
+static void sip_api_end_parse_diagnosis(void);
 static void sip_api_no_function(PyObject *parseErr, const char *func,
         const char *doc);
 static void sip_api_no_method(PyObject *parseErr, const char *scope,
@@ -547,10 +563,15 @@ static const sipAPIDef sip_api = {
     sip_api_instance_destroyed_ex,
     sip_api_is_py_method_12_8,
     sip_api_next_exception_handler,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
+    sip_api_parse_vectorcall_args,
+    sip_api_parse_vectorcall_plan,
+    sip_api_lookup_overload_cache,
+    sip_api_update_overload_cache,
+    sip_api_start_parse_diagnosis,
+    sip_api_end_parse_diagnosis,
+    sip_api_convert_to_strided_array,
+    sip_api_long_as_array,
+    sip_api_type_as_py_type_object,
 };
 
 
@@ -601,6 +622,20 @@ typedef struct _sipParseFailure {
 } sipParseFailure;
 
 
+/*
+ * The arguments being parsed.  The positional arguments are either the items
+ * of a tuple or a vector passed using the vectorcall protocol.  Any keyword
+ * arguments are either in a dict or, for the vectorcall protocol, follow the
+ * positional arguments in the vector with their names in a tuple.
+ */
+typedef struct _sipArgsView {
+    PyObject *const *args;      /* The positional arguments. */
+    Py_ssize_t nr_pos_args;     /* The number of positional arguments. */
+    PyObject *kwd_dict;         /* The keyword arguments if in a dict. */
+    PyObject *kwd_names;        /* The keyword argument names if in a tuple. */
+} sipArgsView;
+
+
 /*
  * An entry in a linked list of name/symbol pairs.
  */
@@ -650,6 +685,61 @@ typedef struct _sipEventHandler {
 } sipEventHandler;
 
 
+/*
+ * An entry in the cache of Python reimplementations of C/C++ virtuals.
+ */
+typedef struct _sipReimpCacheEntry {
+    PyTypeObject *py_type;          /* The Python type. */
+    const char *mname;              /* The name of the virtual. */
+    unsigned int version;           /* The version tag of the type. */
+    PyObject *mname_obj;            /* The interned name of the virtual. */
+    PyObject *reimp;                /* Any reimplementation (borrowed). */
+    PyObject *cls;                  /* The type defining the reimplementation. */
+} sipReimpCacheEntry;
+
+#define REIMP_CACHE_SIZE    256     /* The size of the reimplementation cache. */
+
+
+/*
+ * An entry in the cache of the results of sub-class convertors.
+ */
+typedef struct _sipSubClassCacheEntry {
+    const sipTypeDef *td;           /* The static type. */
+    const void *dynamic_type;       /* The identity of the dynamic type. */
+    const sipTypeDef *sub_td;       /* The type to convert to. */
+    ptrdiff_t offset;               /* The adjustment to the C++ address. */
+} sipSubClassCacheEntry;
+
+#define SUBCLASS_CACHE_SIZE 256     /* The size of the sub-class convertor cache. */
+
+
+/*
+ * A module that uses lazy types and the dictionary that its module scoped
+ * types are placed in.
+ */
+typedef struct _sipLazyModule {
+    sipExportedModuleDef *em;       /* The module. */
+    PyObject *mod_dict;             /* The module dictionary. */
+    PyObject *type_names;           /* The module scoped types by name. */
+    struct _sipLazyModule *next;    /* The next in the list. */
+} sipLazyModule;
+
+
+/*
+ * The number of delayed dtors allocated at a time.
+ */
+#define DELAYED_DTOR_CHUNK  64
+
+
+/*
+ * A chunk of delayed dtors.
+ */
+typedef struct _sipDelayedDtorChunk {
+    sipDelayedDtor dds[DELAYED_DTOR_CHUNK]; /* The delayed dtors. */
+    struct _sipDelayedDtorChunk *next;  /* The next in the list. */
+} sipDelayedDtorChunk;
+
+
 /*
  * Various strings as Python objects created as and when needed.
  */
@@ -661,6 +751,9 @@ static PyObject *signatureName = NULL;
 
 static sipObjectMap cppPyMap;           /* The C/C++ to Python map. */
 static sipExportedModuleDef *moduleList = NULL; /* List of registered modules. */
+static sipLazyModule *lazyModules = NULL;   /* List of modules using lazy types. */
+static sipDelayedDtorChunk *delayedDtorChunks = NULL;   /* Delayed dtor storage. */
+static int nrFreeDelayedDtors = 0;      /* Unused in the first chunk. */
 static unsigned traceMask = 0;          /* The current trace mask. */
 
 static sipTypeDef *currentType = NULL;  /* The type being created. */
@@ -676,8 +769,26 @@ static sipPyObject *sipRegisteredPyTypes = NULL;    /* Registered Python types.
 static sipPyObject *sipDisabledAutoconversions = NULL;  /* Python types whose auto-conversion is disabled. */
 static PyInterpreterState *sipInterpreter = NULL;   /* The interpreter. */
 static sipEventHandler *event_handlers[sipEventNrEvents];   /* The event handler lists. */
+static unsigned long overload_cache_hits = 0;   /* Overload cache hits. */
+static unsigned long overload_cache_misses = 0; /* Overload cache misses. */
+static PyObject *unrecorded_failures;   /* Marks parse failures that weren't recorded. */
+#if defined(SIP_THREAD_LOCAL)
+static SIP_THREAD_LOCAL int parse_diagnosis_depth = 0;  /* >0 if the current thread is diagnosing parse failures. */
+#else
+static int parse_diagnosis_depth = 0;   /* >0 if parse failures are being diagnosed. */
+#endif
+#if !defined(Py_GIL_DISABLED)
+static sipReimpCacheEntry reimp_cache[REIMP_CACHE_SIZE];    /* The Python reimplementations. */
+static sipSubClassCacheEntry subclass_cache[SUBCLASS_CACHE_SIZE];  /* The sub-class convertor results. */
+#endif
 
 static void addClassSlots(sipWrapperType *wt, const sipClassTypeDef *ctd);
+#if !defined(Py_GIL_DISABLED)
+static int untracked_setattro(PyObject *self, PyObject *name,
+        PyObject *value);
+#endif
+static void untrack_leaf(sipSimpleWrapper *sw);
+static void track(sipSimpleWrapper *sw);
 static void *findSlot(PyObject *self, sipPySlotType st);
 static void *findSlotInClass(const sipClassTypeDef *psd, sipPySlotType st);
 static void *findSlotInSlotList(sipPySlotDef *psd, sipPySlotType st);
@@ -686,15 +797,30 @@ static int objobjargprocSlot(PyObject *self, PyObject *arg1, PyObject *arg2,
 static int ssizeobjargprocSlot(PyObject *self, Py_ssize_t arg1,
         PyObject *arg2, sipPySlotType st);
 static PyObject *buildObject(PyObject *tup, const char *fmt, va_list va);
-static int parseKwdArgs(PyObject **parseErrp, PyObject *sipArgs,
+static int buildElements(PyObject **els, const char *fmt, char termch,
+        va_list va);
+static int parseTupleArgs(PyObject **parseErrp, PyObject *sipArgs,
         PyObject *sipKwdArgs, const char **kwdlist, PyObject **unused,
-        const char *fmt, va_list va_orig);
+        const char *fmt, va_list va);
+static int parseKwdArgs(PyObject **parseErrp, const sipArgsView *av,
+        const char **kwdlist, PyObject **unused, const char *fmt,
+        va_list va_orig);
 static int parsePass1(PyObject **parseErrp, PyObject **selfp, int *selfargp,
-        PyObject *sipArgs, PyObject *sipKwdArgs, const char **kwdlist,
-        PyObject **unused, const char *fmt, va_list va);
-static int parsePass2(PyObject *self, int selfarg, PyObject *sipArgs,
-        PyObject *sipKwdArgs, const char **kwdlist, const char *fmt,
-        va_list va);
+        const sipArgsView *av, const char **kwdlist, PyObject **unused,
+        const char *fmt, va_list va);
+static int parsePass2(PyObject *self, int selfarg, const sipArgsView *av,
+        const char **kwdlist, const char *fmt, va_list va);
+static int parsePlanPass1(PyObject **parseErrp, PyObject **selfp,
+        int *selfargp, const sipArgsView *av, const char **kwdlist,
+        PyObject **unused, const sipParsePlanDef *plan, void **outputs);
+static int parsePlanPass2(PyObject *self, int selfarg, const sipArgsView *av,
+        const char **kwdlist, const sipParsePlanDef *plan, void **outputs);
+static int plan_nr_outputs(const sipParsePlanDef *pd);
+static Py_ssize_t args_view_nr_kwds(const sipArgsView *av);
+static PyObject *args_view_get_kwd(const sipArgsView *av, const char *name);
+static int args_view_next_kwd(const sipArgsView *av, Py_ssize_t *posp,
+        PyObject **keyp, PyObject **valuep);
+static PyObject *args_view_kwd_dict(const sipArgsView *av);
 static int parseResult(PyObject *method, PyObject *res,
         sipSimpleWrapper *py_self, const char *fmt, va_list va);
 static PyObject *signature_FromDocstring(const char *doc, Py_ssize_t line);
@@ -704,7 +830,7 @@ static int convertFromSequence(PyObject *seq, const sipTypeDef *td,
         void **array, Py_ssize_t *nr_elem);
 static PyObject *convertToSequence(void *array, Py_ssize_t nr_elem,
         const sipTypeDef *td);
-static int getSelfFromArgs(sipTypeDef *td, PyObject *args, int argnr,
+static int getSelfFromArgs(sipTypeDef *td, const sipArgsView *av, int argnr,
         PyObject **selfp);
 static int compareTypedefName(const void *key, const void *el);
 static int checkPointer(void *ptr, sipSimpleWrapper *sw);
@@ -713,6 +839,17 @@ static void *cast_cpp_ptr(void *ptr, PyTypeObject *src_type,
 static void finalise(void);
 static PyObject *getDefaultBase(void);
 static PyObject *getDefaultSimpleBase(void);
+static int registerLazyModule(sipExportedModuleDef *client,
+        PyObject *mod_dict);
+static PyObject *getLazyModuleDict(const sipExportedModuleDef *em);
+static int createLazyType(sipTypeDef *td);
+static int createNestedTypes(const sipTypeDef *td);
+static PyObject *createLazyTypeNames(sipExportedModuleDef *em);
+static sipTypeDef *findLazyModuleType(sipLazyModule *lm, PyObject *name);
+static const char *lazyModuleTypeName(sipExportedModuleDef *em,
+        sipTypeDef *td);
+static PyObject *lazy_module_getattr(PyObject *self, PyObject *name);
+static PyObject *lazy_module_dir(PyObject *self, PyObject *args);
 static PyObject *getScopeDict(sipTypeDef *td, PyObject *mod_dict,
         sipExportedModuleDef *client);
 static PyObject *createContainerType(sipContainerDef *cod, sipTypeDef *td,
@@ -720,6 +857,12 @@ static PyObject *createContainerType(sipContainerDef *cod, sipTypeDef *td,
         PyObject *type_dict, sipExportedModuleDef *client);
 static int createClassType(sipExportedModuleDef *client, sipClassTypeDef *ctd,
         PyObject *mod_dict);
+static int set_ancestors(const sipClassTypeDef *ctd, sipWrapperType *wt);
+#if !defined(Py_GIL_DISABLED) && !defined(Py_TRACE_REFS)
+static PyObject *wrapper_alloc(PyTypeObject *py_type, Py_ssize_t nitems);
+static void wrapper_free(void *self);
+static void trim_freelist(sipWrapperTypePrivate *wp);
+#endif
 static int createMappedType(sipExportedModuleDef *client,
         sipMappedTypeDef *mtd, PyObject *mod_dict);
 static sipExportedModuleDef *getModule(PyObject *mname_obj);
@@ -730,6 +873,9 @@ static PyObject *createTypeDict(sipExportedModuleDef *em);
 static sipTypeDef *getGeneratedType(const sipEncodedTypeDef *enc,
         sipExportedModuleDef *em);
 static const sipTypeDef *convertSubClass(const sipTypeDef *td, void **cppPtr);
+#if !defined(Py_GIL_DISABLED)
+static sipDynamicTypeFunc get_dynamic_type(const sipTypeDef *td);
+#endif
 static int convertPass(const sipTypeDef **tdp, void **cppPtr);
 static void *getPtrTypeDef(sipSimpleWrapper *self,
         const sipClassTypeDef **ctd);
@@ -757,6 +903,11 @@ static PyObject *enableAutoconversion(PyObject *self, PyObject *args);
 static PyObject *isDeleted(PyObject *self, PyObject *args);
 static PyObject *isPyCreated(PyObject *self, PyObject *args);
 static PyObject *isPyOwned(PyObject *self, PyObject *args);
+static PyObject *objectMapStats(PyObject *self, PyObject *args);
+static PyObject *setFreelistSize(PyObject *self, PyObject *args);
+static PyObject *overloadCacheStats(PyObject *self, PyObject *args);
+static PyObject *resetStats(PyObject *self, PyObject *args);
+static PyObject *stats(PyObject *self, PyObject *args);
 static PyObject *setDeleted(PyObject *self, PyObject *args);
 static PyObject *setTraceMask(PyObject *self, PyObject *args);
 static PyObject *wrapInstance(PyObject *self, PyObject *args);
@@ -782,11 +933,15 @@ static PyObject *parseString_AsLatin1String(PyObject *obj, const char **ap);
 static int parseString_AsUTF8Char(PyObject *obj, char *ap);
 static PyObject *parseString_AsUTF8String(PyObject *obj, const char **ap);
 static int parseString_AsEncodedChar(PyObject *bytes, PyObject *obj, char *ap);
+static const char *parseString_BorrowASCII(PyObject *obj);
+static const char *parseString_BorrowLatin1(PyObject *obj);
+static const char *parseString_BorrowUTF8(PyObject *obj);
 static PyObject *parseString_AsEncodedString(PyObject *bytes, PyObject *obj,
         const char **ap);
 #if defined(HAVE_WCHAR_H)
 static int parseWCharArray(PyObject *obj, wchar_t **ap, Py_ssize_t *aszp);
 static int convertToWCharArray(PyObject *obj, wchar_t **ap, Py_ssize_t *aszp);
+static int copyWideChars(PyObject *obj, wchar_t *wc, Py_ssize_t ulen);
 static int parseWChar(PyObject *obj, wchar_t *ap);
 static int convertToWChar(PyObject *obj, wchar_t *ap);
 static int parseWCharString(PyObject *obj, wchar_t **ap);
@@ -798,11 +953,23 @@ static void *getComplexCppPtr(sipSimpleWrapper *w, const sipTypeDef *td);
 static PyObject *findPyType(const char *name);
 static int addPyObjectToList(sipPyObject **head, PyObject *object);
 static PyObject *getDictFromObject(PyObject *obj);
+static int find_reimplementation(PyTypeObject *py_type, const char *mname,
+        PyObject **mname_objp, PyObject **reimpp, PyObject **clsp);
+#if !defined(Py_GIL_DISABLED)
+static unsigned int get_type_version(PyTypeObject *py_type);
+#endif
 static void forgetObject(sipSimpleWrapper *sw);
 static int add_lazy_container_attrs(const sipTypeDef *td, sipContainerDef *cod,
         PyObject *dict);
 static int add_lazy_attrs(const sipTypeDef *td);
 static void add_failure(PyObject **parseErrp, sipParseFailure *failure);
+static void report_failure(PyObject **parseErrp, sipParseFailure *failure);
+static void defer_failures(PyObject **parseErrp);
+static void check_unused_kwds(const sipArgsView *av, const char **kwdlist,
+        int nr_args, int selfarg, Py_ssize_t nr_kwd_args_used,
+        PyObject **unused, sipParseFailure *failure);
+static void check_unknown_kwds(const sipArgsView *av, const char **kwdlist,
+        int nr_args, sipParseFailure *failure);
 static PyObject *bad_type_str(int arg_nr, PyObject *arg);
 static void *explicit_access_func(sipSimpleWrapper *sw, AccessFuncOp op);
 static void *indirect_access_func(sipSimpleWrapper *sw, AccessFuncOp op);
@@ -817,6 +984,28 @@ static sipConvertFromFunc get_from_convertor(const sipTypeDef *td);
 static sipPyObject **autoconversion_disabled(const sipTypeDef *td);
 static void fix_slots(PyTypeObject *py_type, sipPySlotDef *psd);
 static sipFinalFunc find_finalisation(sipClassTypeDef *ctd);
+static sipInitVectorcallFunc get_init_vectorcall(const sipClassTypeDef *ctd);
+static void *init_vectorcall(sipInitVectorcallFunc init,
+        sipSimpleWrapper *self, PyObject *const *args, Py_ssize_t nargs,
+        PyObject *kwnames, PyObject **unused, PyObject **owner,
+        PyObject **parseErr);
+static void *call_init_vectorcall(sipInitVectorcallFunc init,
+        sipSimpleWrapper *self, PyObject *args, PyObject *kwds,
+        PyObject **unused, PyObject **owner, PyObject **parseErr);
+static int get_ownership_flags(sipSimpleWrapper *self, sipWrapper **ownerp);
+static void bind_new_instance(sipSimpleWrapper *self, void *sipNew,
+        int sipFlags, sipWrapper *owner);
+static void raise_no_ctor(sipClassTypeDef *ctd, PyObject *parseErr);
+static PyObject *sipSimpleWrapper_new(sipWrapperType *wt, PyObject *args,
+        PyObject *kwds);
+static int sipSimpleWrapper_init(sipSimpleWrapper *self, PyObject *args,
+        PyObject *kwds);
+#if PY_VERSION_HEX >= 0x03090000
+static PyObject *sipWrapperType_vectorcall(PyObject *callable,
+        PyObject *const *args, size_t nargsf, PyObject *kwnames);
+static PyObject *vectorcall_fallback(PyObject *callable,
+        PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames);
+#endif
 static PyObject *next_in_mro(PyObject *self, PyObject *after);
 static int super_init(PyObject *self, PyObject *args, PyObject *kwds,
         PyObject *type);
@@ -840,6 +1029,9 @@ static void handle_failed_type_conversion(sipParseFailure *pf, PyObject *arg);
 static void raise_no_convert_from(const sipTypeDef *td);
 static void raise_no_convert_to(PyObject *py, const sipTypeDef *td);
 static int user_state_is_valid(const sipTypeDef *td, void **user_statep);
+static int add_types_to_index(sipExportedModuleDef *em);
+static PyTypeObject sipKeptReferences_Type;
+static void clear_type_index(void);
 
 
 /*
@@ -858,8 +1050,13 @@ const sipAPIDef *sip_init_library(PyObject *mod_dict)
         {"isdeleted", isDeleted, METH_VARARGS, NULL},
         {"ispycreated", isPyCreated, METH_VARARGS, NULL},
         {"ispyowned", isPyOwned, METH_VARARGS, NULL},
+        {"objectmapstats", objectMapStats, METH_NOARGS, NULL},
+        {"overloadcachestats", overloadCacheStats, METH_NOARGS, NULL},
+        {"resetstats", resetStats, METH_NOARGS, NULL},
         {"setdeleted", setDeleted, METH_VARARGS, NULL},
+        {"setfreelistsize", setFreelistSize, METH_VARARGS, NULL},
         {"settracemask", setTraceMask, METH_VARARGS, NULL},
+        {"stats", stats, METH_NOARGS, NULL},
         {"transferback", transferBack, METH_VARARGS, NULL},
         {"transferto", transferTo, METH_VARARGS, NULL},
         {"wrapinstance", wrapInstance, METH_VARARGS, NULL},
@@ -936,6 +1133,9 @@ const sipAPIDef *sip_init_library(PyObject *mod_dict)
     if (PyType_Ready(&sipArray_Type) < 0)
         return NULL;
 
+    if (PyType_Ready(&sipKeptReferences_Type) < 0)
+        return NULL;
+
     /* Add the public types. */
     if (PyDict_SetItemString(mod_dict, "wrappertype", (PyObject *)&sipWrapperType_Type) < 0)
         return NULL;
@@ -959,6 +1159,9 @@ const sipAPIDef *sip_init_library(PyObject *mod_dict)
     if ((empty_tuple = PyTuple_New(0)) == NULL)
         return NULL;
 
+    if ((unrecorded_failures = PyObject_CallObject((PyObject *)&PyBaseObject_Type, NULL)) == NULL)
+        return NULL;
+
     /* Initialise the object map. */
     sipOMInit(&cppPyMap);
 
@@ -1094,6 +1297,153 @@ static PyObject *setTraceMask(PyObject *self, PyObject *args)
 }
 
 
+/*
+ * Return a tuple of the number of overload cache hits and misses.
+ */
+static PyObject *overloadCacheStats(PyObject *self, PyObject *args)
+{
+    (void)self;
+    (void)args;
+
+    return Py_BuildValue("(kk)", overload_cache_hits, overload_cache_misses);
+}
+
+
+/*
+ * Return a dict of the statistics about the map of C/C++ addresses to wrapped
+ * objects.
+ */
+static PyObject *objectMapStats(PyObject *self, PyObject *args)
+{
+    sipObjectMapStats stats;
+
+    (void)self;
+    (void)args;
+
+    sipOMGetStats(&cppPyMap, &stats);
+
+    return Py_BuildValue("{s:s,s:n,s:n,s:n,s:d,s:k,s:k,s:k,s:k,s:O,s:i,s:n}",
+            "implementation", stats.implementation,
+            "size", (Py_ssize_t)stats.size,
+            "entries", (Py_ssize_t)stats.nr_entries,
+            "stale", (Py_ssize_t)stats.nr_stale,
+            "load_factor", (double)(stats.nr_entries + stats.nr_stale) / stats.size,
+            "lookups", stats.nr_lookups,
+            "probes", stats.nr_probes,
+            "max_probe_length", stats.max_probes,
+            "resizes", stats.nr_resizes,
+            "resizing", stats.resizing ? Py_True : Py_False,
+            "shards", stats.nr_shards,
+            "aliases", (Py_ssize_t)stats.nr_aliases);
+}
+
+
+/*
+ * Return a dict of all the runtime statistics grouped by subsystem.
+ */
+static PyObject *stats(PyObject *self, PyObject *args)
+{
+    unsigned long counts[sipStatNrStats];
+    PyObject *om_stats;
+
+    sip_stats_get(counts);
+
+    if ((om_stats = objectMapStats(self, args)) == NULL)
+        return NULL;
+
+    return Py_BuildValue("{s:O,s:N,s:{s:k,s:k,s:k},s:{s:k,s:k,s:k},s:{s:k,s:k},s:{s:k,s:k},s:{s:k,s:k},s:{s:k,s:k,s:k,s:k,s:k,s:k}}",
+            "enabled",
+#if defined(SIP_STATS)
+                    Py_True,
+#else
+                    Py_False,
+#endif
+            "object_map", om_stats,
+            "wrappers",
+                "wraps", counts[sipStatWraps],
+                "unwraps", counts[sipStatUnwraps],
+                "reused", counts[sipStatReusedWrappers],
+            "overloads",
+                "cache_hits", overload_cache_hits,
+                "cache_misses", overload_cache_misses,
+                "failed", counts[sipStatFailedOverloads],
+            "subclass_convertors",
+                "calls", counts[sipStatSubClassConvertors],
+                "cache_hits", counts[sipStatSubClassCacheHits],
+            "virtuals",
+                "cache_hits", counts[sipStatVirtualCacheHits],
+                "mro_walks", counts[sipStatVirtualMROWalks],
+            "enums",
+                "cache_hits", counts[sipStatEnumCacheHits],
+                "cache_misses", counts[sipStatEnumCacheMisses],
+            "allocations",
+                "total", counts[sipStatAllocations],
+                "object_map", counts[sipStatAllocObjectMap],
+                "aliases", counts[sipStatAllocAliases],
+                "kept_references", counts[sipStatAllocKeptReferences],
+                "parse_failures", counts[sipStatAllocParseFailures],
+                "delayed_dtors", counts[sipStatAllocDelayedDtors]);
+}
+
+
+/*
+ * Reset all the runtime statistics that are counts.
+ */
+static PyObject *resetStats(PyObject *self, PyObject *args)
+{
+    (void)self;
+    (void)args;
+
+    sip_stats_reset();
+    sipOMResetStats(&cppPyMap);
+
+    overload_cache_hits = 0;
+    overload_cache_misses = 0;
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+
+/*
+ * Set the maximum number of released instances of a type that are kept for
+ * reuse and return the previous maximum.
+ */
+static PyObject *setFreelistSize(PyObject *self, PyObject *args)
+{
+    sipWrapperType *wt;
+    int size, was_size;
+
+    (void)self;
+
+    if (!PyArg_ParseTuple(args, "O!i:setfreelistsize", &sipWrapperType_Type, &wt, &size))
+        return NULL;
+
+    if (wt->wt_private == NULL || !sipTypeIsClass(wt->wt_td))
+    {
+        PyErr_Format(PyExc_TypeError, "%s is not a wrapped class",
+                ((PyTypeObject *)wt)->tp_name);
+        return NULL;
+    }
+
+    if (size < 0)
+    {
+        PyErr_SetString(PyExc_ValueError,
+                "the size of a freelist cannot be negative");
+        return NULL;
+    }
+
+    was_size = wt->wt_private->wp_freelist_size;
+
+#if !defined(Py_GIL_DISABLED) && !defined(Py_TRACE_REFS)
+    wt->wt_private->wp_freelist_size = size;
+    trim_freelist(wt->wt_private);
+#endif
+
+    return PyLong_FromLong(was_size);
+}
+
+
 /*
  * Dump various bits of potentially useful information to stdout.  Note that we
  * use the same calling convention as sys.getrefcount() so that it has the
@@ -1558,6 +1908,10 @@ static int sip_api_export_module(sipExportedModuleDef *client,
     if ((client->em_nameobj = PyUnicode_FromString(full_name)) == NULL)
         return -1;
 
+    /* Make its types available to sip_api_find_type(). */
+    if (add_types_to_index(client) < 0)
+        return -1;
+
     /* Add it to the list of client modules. */
     client->em_next = moduleList;
     moduleList = client;
@@ -1576,7 +1930,13 @@ static int sip_api_init_module(sipExportedModuleDef *client,
 {
     sipExportedModuleDef *em;
     sipIntInstanceDef *next_int;
-    int i;
+    int i, lazy;
+
+    /*
+     * If the module uses lazy types then they are only initialised enough to
+     * be found by name.  Their type objects are created when first needed.
+     */
+    lazy = sipModuleHasLazyTypes(client);
 
     /* Create the module's types. */
     next_int = client->em_instances.id_int;
@@ -1611,15 +1971,25 @@ static int sip_api_init_module(sipExportedModuleDef *client,
              */
             td->td_module = client;
 
-            if (etd->etd_scope < 0 && sip_enum_create(client, etd, &next_int, mod_dict) < 0)
-                return -1;
+            if (etd->etd_scope < 0)
+            {
+                if (lazy)
+                {
+                    /* Skip the members so that the ints can be found. */
+                    next_int += etd->etd_nr_members;
+                }
+                else if (sip_enum_create(client, etd, &next_int, mod_dict) < 0)
+                {
+                    return -1;
+                }
+            }
         }
         else if (sipTypeIsMapped(td))
         {
             sipMappedTypeDef *mtd = (sipMappedTypeDef *)td;
 
             /* If there is a name then we need a namespace. */
-            if (mtd->mtd_container.cod_name >= 0)
+            if (mtd->mtd_container.cod_name >= 0 && !lazy)
             {
                 if (createMappedType(client, mtd, mod_dict) < 0)
                     return -1;
@@ -1658,11 +2028,24 @@ static int sip_api_init_module(sipExportedModuleDef *client,
                  */
                 client->em_types[i] = real_nspace;
             }
+            else if (lazy)
+            {
+                ctd->ctd_base.td_module = client;
+            }
             else if (createClassType(client, ctd, mod_dict) < 0)
+            {
                 return -1;
+            }
         }
     }
 
+    /*
+     * Register a module that uses lazy types now that its types can be found
+     * by name.
+     */
+    if (lazy && registerLazyModule(client, mod_dict) < 0)
+        return -1;
+
     /* Add any ints that aren't name enum members. */
     if (next_int != NULL)
         if (addIntInstances(mod_dict, next_int) < 0)
@@ -1678,6 +2061,9 @@ static int sip_api_init_module(sipExportedModuleDef *client,
             sipTypeDef *td = getGeneratedType(&ie->ie_class, client);
             sipWrapperType *wt = (sipWrapperType *)sipTypeAsPyTypeObject(td);
 
+            if (wt == NULL)
+                return -1;
+
             ie->ie_next = wt->wt_iextend;
             wt->wt_iextend = ie;
 
@@ -1696,6 +2082,11 @@ static int sip_api_init_module(sipExportedModuleDef *client,
 
             ++scc;
         }
+
+#if !defined(Py_GIL_DISABLED)
+        /* The new convertors may change any previous results. */
+        memset(subclass_cache, 0, sizeof (subclass_cache));
+#endif
     }
 
     /* Add any global static instances. */
@@ -1763,17 +2154,19 @@ static void finalise(void)
         if (em->em_ddlist != NULL)
         {
             em->em_delayeddtors(em->em_ddlist);
+            em->em_ddlist = NULL;
+        }
 
-            /* Free the list. */
-            do
-            {
-                sipDelayedDtor *dd = em->em_ddlist;
+    /* Free the storage of all the lists. */
+    while (delayedDtorChunks != NULL)
+    {
+        sipDelayedDtorChunk *ddc = delayedDtorChunks;
 
-                em->em_ddlist = dd->dd_next;
-                sip_api_free(dd);
-            }
-            while (em->em_ddlist != NULL);
-        }
+        delayedDtorChunks = ddc->next;
+        sip_api_free(ddc);
+    }
+
+    nrFreeDelayedDtors = 0;
 
     licenseName = NULL;
     licenseeName = NULL;
@@ -1784,6 +2177,16 @@ static void finalise(void)
     /* Release all memory we've allocated directly. */
     sipOMFinalise(&cppPyMap);
 
+    clear_type_index();
+
+    while (lazyModules != NULL)
+    {
+        sipLazyModule *lm = lazyModules;
+
+        lazyModules = lm->next;
+        sip_api_free(lm);
+    }
+
     /* Re-initialise those globals that (might) need it. */
     moduleList = NULL;
 }
@@ -1828,35 +2231,39 @@ static void sip_api_add_delayed_dtor(sipSimpleWrapper *sw)
     void *ptr;
     const sipClassTypeDef *ctd;
     sipExportedModuleDef *em;
+    sipDelayedDtor *dd;
 
     if ((ptr = getPtrTypeDef(sw, &ctd)) == NULL)
         return;
 
-    /* Find the defining module. */
-    for (em = moduleList; em != NULL; em = em->em_next)
+    /* The defining module is the one that created the type. */
+    if ((em = ctd->ctd_base.td_module) == NULL || em->em_delayeddtors == NULL)
+        return;
+
+    /* Take the next unused entry, allocating a new chunk if necessary. */
+    if (nrFreeDelayedDtors == 0)
     {
-        int i;
+        sipDelayedDtorChunk *ddc;
 
-        for (i = 0; i < em->em_nrtypes; ++i)
-            if (em->em_types[i] == (const sipTypeDef *)ctd)
-            {
-                sipDelayedDtor *dd;
+        if ((ddc = sip_api_malloc(sizeof (sipDelayedDtorChunk))) == NULL)
+            return;
 
-                if ((dd = sip_api_malloc(sizeof (sipDelayedDtor))) == NULL)
-                    return;
+        sipStatsInc(sipStatAllocDelayedDtors);
 
-                /* Add to the list. */
-                dd->dd_ptr = ptr;
-                dd->dd_name = sipPyNameOfContainer(&ctd->ctd_container,
-                        (sipTypeDef *)ctd);
-                dd->dd_isderived = sipIsDerived(sw);
-                dd->dd_next = em->em_ddlist;
+        ddc->next = delayedDtorChunks;
+        delayedDtorChunks = ddc;
+        nrFreeDelayedDtors = DELAYED_DTOR_CHUNK;
+    }
 
-                em->em_ddlist = dd;
+    dd = &delayedDtorChunks->dds[--nrFreeDelayedDtors];
 
-                return;
-            }
-    }
+    /* Add to the list. */
+    dd->dd_ptr = ptr;
+    dd->dd_name = sipPyNameOfContainer(&ctd->ctd_container, (sipTypeDef *)ctd);
+    dd->dd_isderived = sipIsDerived(sw);
+    dd->dd_next = em->em_ddlist;
+
+    em->em_ddlist = dd;
 }
 
 
@@ -1868,6 +2275,8 @@ void *sip_api_malloc(size_t nbytes)
 {
     void *mem;
 
+    sipStatsInc(sipStatAllocations);
+
     if ((mem = PyMem_RawMalloc(nbytes)) == NULL)
         PyErr_NoMemory();
 
@@ -1949,7 +2358,7 @@ static PyObject *sip_api_convert_from_new_pytype(void *cpp,
 
     va_start(va, fmt);
 
-    if ((args = PyTuple_New(strlen(fmt))) != NULL && buildObject(args, fmt, va) != NULL)
+    if ((args = PyTuple_New(strlen(fmt))) != NULL && (args = buildObject(args, fmt, va)) != NULL)
     {
         res = sipWrapInstance(cpp, py_type, args, owner,
                 (selfp != NULL ? SIP_DERIVED_CLASS : 0));
@@ -1971,24 +2380,67 @@ static PyObject *sip_api_convert_from_new_pytype(void *cpp,
 }
 
 
+#define SMALL_NARGS     8   /* The number of arguments held on the stack. */
+
 /*
- * Call a method and return the result.
+ * Call a method and return the result.  The arguments are built directly into
+ * a vector (on the stack for the common case of a small number of them) so
+ * that calling a re-implementation of a C++ virtual doesn't need to allocate
+ * an argument tuple.
  */
 static PyObject *call_method(PyObject *method, const char *fmt, va_list va)
 {
+#if PY_VERSION_HEX >= 0x03090000
+    PyObject *small_args[1 + SMALL_NARGS], **args, *res;
+    size_t nargs = strlen(fmt), i;
+
+    if (nargs <= SMALL_NARGS)
+    {
+        args = small_args;
+    }
+    else if ((args = sip_api_malloc((1 + nargs) * sizeof (PyObject *))) == NULL)
+    {
+        return NULL;
+    }
+
+    /*
+     * The first slot is left free so that a bound method can prepend self
+     * without copying the vector.
+     */
+    args[0] = NULL;
+
+    if (buildElements(&args[1], fmt, '\0', va) < 0)
+    {
+        res = NULL;
+    }
+    else
+    {
+        res = PyObject_Vectorcall(method, &args[1],
+                nargs | PY_VECTORCALL_ARGUMENTS_OFFSET, NULL);
+
+        for (i = 1; i <= nargs; ++i)
+            Py_DECREF(args[i]);
+    }
+
+    if (args != small_args)
+        sip_api_free(args);
+
+    return res;
+#else
     PyObject *args, *res;
 
     if ((args = PyTuple_New(strlen(fmt))) == NULL)
         return NULL;
 
-    if (buildObject(args, fmt, va) != NULL)
-        res = PyObject_CallObject(method, args);
-    else
-        res = NULL;
+    if ((args = buildObject(args, fmt, va)) == NULL)
+        return NULL;
+
+    res = PyObject_CallObject(method, args);
 
     Py_DECREF(args);
 
     return res;
+#endif
 }
 
 
@@ -2095,8 +2547,7 @@ static PyObject *sip_api_build_result(int *isErr, const char *fmt, ...)
  */
 static PyObject *buildObject(PyObject *obj, const char *fmt, va_list va)
 {
-    char ch, termch;
-    int i;
+    char termch;
 
     /*
      * The format string has already been checked that it is properly formed if
@@ -2110,6 +2561,36 @@ static PyObject *buildObject(PyObject *obj, const char *fmt, va_list va)
     else
         termch = '\0';
 
+    /* A single value is returned as it is. */
+    if (obj == NULL)
+    {
+        if (buildElements(&obj, fmt, termch, va) < 0)
+            return NULL;
+
+        return obj;
+    }
+
+    if (buildElements(PySequence_Fast_ITEMS(obj), fmt, termch, va) < 0)
+    {
+        Py_DECREF(obj);
+        return NULL;
+    }
+
+    return obj;
+}
+
+
+/*
+ * Get the values off the stack and put new references to the corresponding
+ * objects into an array.  On error any elements already created are released
+ * and reset.
+ */
+static int buildElements(PyObject **els, const char *fmt, char termch,
+        va_list va)
+{
+    char ch;
+    int i;
+
     i = 0;
 
     while ((ch = *fmt++) != termch)
@@ -2372,18 +2853,21 @@ static PyObject *buildObject(PyObject *obj, const char *fmt, va_list va)
 
         if (el == NULL)
         {
-            Py_XDECREF(obj);
-            return NULL;
-        }
+            while (i > 0)
+            {
+                --i;
+                Py_DECREF(els[i]);
+                els[i] = NULL;
+            }
 
-        if (obj == NULL)
-            return el;
+            return -1;
+        }
 
-        PyTuple_SET_ITEM(obj,i,el);
+        els[i] = el;
         ++i;
     }
 
-    return obj;
+    return 0;
 }
 
 
@@ -3165,7 +3649,7 @@ static int sip_api_parse_args(PyObject **parseErrp, PyObject *sipArgs,
     va_list va;
 
     va_start(va, fmt);
-    ok = parseKwdArgs(parseErrp, sipArgs, NULL, NULL, NULL, fmt, va);
+    ok = parseTupleArgs(parseErrp, sipArgs, NULL, NULL, NULL, fmt, va);
     va_end(va);
 
     return ok;
@@ -3193,7 +3677,7 @@ static int sip_api_parse_kwd_args(PyObject **parseErrp, PyObject *sipArgs,
     }
 
     va_start(va, fmt);
-    ok = parseKwdArgs(parseErrp, sipArgs, sipKwdArgs, kwdlist, unused, fmt,
+    ok = parseTupleArgs(parseErrp, sipArgs, sipKwdArgs, kwdlist, unused, fmt,
             va);
     va_end(va);
 
@@ -3208,61 +3692,306 @@ static int sip_api_parse_kwd_args(PyObject **parseErrp, PyObject *sipArgs,
 
 
 /*
- * Parse the arguments to a C/C++ function without any side effects.
+ * Parse the positional and/or keyword arguments to a C/C++ function, passed
+ * using the vectorcall protocol, without any side effects.
  */
-static int parseKwdArgs(PyObject **parseErrp, PyObject *sipArgs,
-        PyObject *sipKwdArgs, const char **kwdlist, PyObject **unused,
-        const char *fmt, va_list va_orig)
+static int sip_api_parse_vectorcall_args(PyObject **parseErrp,
+        PyObject *const *sipArgs, Py_ssize_t sipNrArgs,
+        PyObject *sipKwdNames, const char **kwdlist, PyObject **unused,
+        const char *fmt, ...)
 {
-    int no_tmp_tuple, ok, selfarg;
-    PyObject *self, *single_arg;
+    int ok;
+    sipArgsView av;
     va_list va;
 
-    /* Previous second pass errors stop subsequent parses. */
-    if (*parseErrp != NULL && !PyList_Check(*parseErrp))
-        return FALSE;
-
-    /*
-     * See if we are parsing a single argument.  In current versions we are
-     * told explicitly by the first character of the format string.  In earlier
-     * versions we guessed (sometimes wrongly).
-     */
-    if (*fmt == '1')
+    if (unused != NULL)
     {
-        ++fmt;
-        no_tmp_tuple = FALSE;
+        /*
+         * Initialise the return of any unused keyword arguments.  This is
+         * used by any ctor overload.
+         */
+        *unused = NULL;
     }
-    else
-        no_tmp_tuple = PyTuple_Check(sipArgs);
 
-    if (no_tmp_tuple)
+    av.args = sipArgs;
+    av.nr_pos_args = sipNrArgs;
+    av.kwd_dict = NULL;
+    av.kwd_names = sipKwdNames;
+
+    defer_failures(parseErrp);
+
+    va_start(va, fmt);
+    ok = parseKwdArgs(parseErrp, &av, kwdlist, unused, fmt, va);
+    va_end(va);
+
+    /* Release any unused arguments if the parse failed. */
+    if (!ok && unused != NULL)
     {
-        Py_INCREF(sipArgs);
+        Py_XDECREF(*unused);
     }
-    else if ((single_arg = PyTuple_New(1)) != NULL)
-    {
-        Py_INCREF(sipArgs);
-        PyTuple_SET_ITEM(single_arg, 0, sipArgs);
 
-        sipArgs = single_arg;
+    return ok;
+}
+
+
+/*
+ * Parse the positional and/or keyword arguments to a C/C++ function, passed
+ * using the vectorcall protocol, according to a plan created by the code
+ * generator and without any side effects.
+ */
+static int sip_api_parse_vectorcall_plan(PyObject **parseErrp,
+        PyObject *const *sipArgs, Py_ssize_t sipNrArgs,
+        PyObject *sipKwdNames, const char **kwdlist, PyObject **unused,
+        const sipParsePlanDef *plan, void **outputs)
+{
+    int ok, selfarg;
+    PyObject *self;
+    sipArgsView av;
+
+    if (unused != NULL)
+    {
+        /*
+         * Initialise the return of any unused keyword arguments.  This is
+         * used by any ctor overload.
+         */
+        *unused = NULL;
     }
-    else
+
+    /* Previous second pass errors stop subsequent parses. */
+    if (*parseErrp != NULL && *parseErrp != unrecorded_failures && !PyList_Check(*parseErrp))
+        return FALSE;
+
+    av.args = sipArgs;
+    av.nr_pos_args = sipNrArgs;
+    av.kwd_dict = NULL;
+    av.kwd_names = sipKwdNames;
+
+    defer_failures(parseErrp);
+
+    ok = parsePlanPass1(parseErrp, &self, &selfarg, &av, kwdlist, unused,
+            plan, outputs);
+
+    if (ok)
     {
-        /* Stop all parsing and indicate an exception has been raised. */
+        ok = parsePlanPass2(self, selfarg, &av, kwdlist, plan, outputs);
+
+        /* Remove any previous failed parses. */
         Py_XDECREF(*parseErrp);
-        *parseErrp = Py_None;
-        Py_INCREF(Py_None);
 
+        if (ok)
+        {
+            *parseErrp = NULL;
+        }
+        else
+        {
+            /* Indicate that an exception has been raised. */
+            *parseErrp = Py_None;
+            Py_INCREF(Py_None);
+        }
+    }
+
+    /* Release any unused arguments if the parse failed. */
+    if (!ok && unused != NULL)
+    {
+        Py_XDECREF(*unused);
+    }
+
+    return ok;
+}
+
+
+
+/*
+ * Return the index of the overload of a function that should be tried first
+ * for a set of arguments passed using the vectorcall protocol.  The code
+ * generator only creates a cache for a function if whether or not each of its
+ * overloads accepts a set of arguments depends only on the types of those
+ * arguments.  Therefore all previous overloads are known to fail and can be
+ * skipped.  -1 is returned if all the overloads should be tried.
+ */
+static int sip_api_lookup_overload_cache(sipOverloadCacheDef *oc,
+        PyObject *const *sipArgs, Py_ssize_t sipNrArgs,
+        PyObject *sipKwdNames)
+{
+#if !defined(Py_GIL_DISABLED)
+    Py_ssize_t a;
+
+    if (oc->oc_overload != 0 && oc->oc_nr_args == sipNrArgs && (sipKwdNames == NULL || PyTuple_GET_SIZE(sipKwdNames) == 0))
+    {
+        for (a = 0; a < sipNrArgs; ++a)
+            if (Py_TYPE(sipArgs[a]) != oc->oc_types[a])
+                break;
+
+        if (a == sipNrArgs)
+        {
+            ++overload_cache_hits;
+
+            return oc->oc_overload - 1;
+        }
+    }
+
+    ++overload_cache_misses;
+#else
+    /* The cache isn't thread-safe without the GIL so it is disabled. */
+    (void)oc;
+    (void)sipArgs;
+    (void)sipNrArgs;
+    (void)sipKwdNames;
+#endif
+
+    return -1;
+}
+
+
+/*
+ * Update an overload cache with the overload of a function that accepted a
+ * set of arguments passed using the vectorcall protocol.
+ */
+static void sip_api_update_overload_cache(sipOverloadCacheDef *oc,
+        int overload, PyObject *const *sipArgs, Py_ssize_t sipNrArgs,
+        PyObject *sipKwdNames)
+{
+#if !defined(Py_GIL_DISABLED)
+    Py_ssize_t a;
+
+    /* Keyword arguments aren't part of the key. */
+    if (sipNrArgs > SIP_OVERLOAD_CACHE_MAX_ARGS || (sipKwdNames != NULL && PyTuple_GET_SIZE(sipKwdNames) != 0))
+        return;
+
+    /* There is nothing to do if the cache was hit. */
+    if (oc->oc_overload == overload + 1 && oc->oc_nr_args == sipNrArgs)
+    {
+        for (a = 0; a < sipNrArgs; ++a)
+            if (Py_TYPE(sipArgs[a]) != oc->oc_types[a])
+                break;
+
+        if (a == sipNrArgs)
+            return;
+    }
+
+    /*
+     * References to the types are kept so that they cannot be replaced by
+     * different types at the same addresses.
+     */
+    for (a = 0; a < sipNrArgs; ++a)
+        Py_INCREF(Py_TYPE(sipArgs[a]));
+
+    for (a = 0; a < oc->oc_nr_args; ++a)
+        Py_DECREF(oc->oc_types[a]);
+
+    for (a = 0; a < sipNrArgs; ++a)
+        oc->oc_types[a] = Py_TYPE(sipArgs[a]);
+
+    oc->oc_overload = overload + 1;
+    oc->oc_nr_args = (int)sipNrArgs;
+#else
+    (void)oc;
+    (void)overload;
+    (void)sipArgs;
+    (void)sipNrArgs;
+    (void)sipKwdNames;
+#endif
+}
+
+
+/*
+ * Start the diagnosis of a set of arguments, passed using the vectorcall
+ * protocol, that failed to match any of the overloads of a function.  The
+ * reasons for the failures are not recorded when the arguments are first
+ * parsed so that there is no cost when an overload matches.  If it is
+ * necessary to diagnose the failures then return TRUE, in which case the
+ * caller must parse the arguments again and then call
+ * sip_api_end_parse_diagnosis().
+ */
+static int sip_api_start_parse_diagnosis(PyObject **parseErrp)
+{
+    if (*parseErrp != unrecorded_failures)
         return FALSE;
+
+    Py_DECREF(unrecorded_failures);
+    *parseErrp = NULL;
+
+    ++parse_diagnosis_depth;
+
+    return TRUE;
+}
+
+
+/*
+ * End the diagnosis of a set of arguments that failed to parse.
+ */
+static void sip_api_end_parse_diagnosis(void)
+{
+    --parse_diagnosis_depth;
+}
+
+
+/*
+ * Parse a tuple of positional arguments (or a single argument) and an
+ * optional dict of keyword arguments without any side effects.
+ */
+static int parseTupleArgs(PyObject **parseErrp, PyObject *sipArgs,
+        PyObject *sipKwdArgs, const char **kwdlist, PyObject **unused,
+        const char *fmt, va_list va)
+{
+    int is_tuple;
+    sipArgsView av;
+
+    /*
+     * See if we are parsing a single argument.  In current versions we are
+     * told explicitly by the first character of the format string.  In earlier
+     * versions we guessed (sometimes wrongly).
+     */
+    if (*fmt == '1')
+    {
+        ++fmt;
+        is_tuple = FALSE;
+    }
+    else
+        is_tuple = PyTuple_Check(sipArgs);
+
+    if (is_tuple)
+    {
+        av.args = ((PyTupleObject *)sipArgs)->ob_item;
+        av.nr_pos_args = PyTuple_GET_SIZE(sipArgs);
     }
+    else
+    {
+        /* Treat a single argument as a vector rather than a tuple. */
+        av.args = &sipArgs;
+        av.nr_pos_args = 1;
+    }
+
+    assert(sipKwdArgs == NULL || PyDict_Check(sipKwdArgs));
+
+    av.kwd_dict = sipKwdArgs;
+    av.kwd_names = NULL;
+
+    return parseKwdArgs(parseErrp, &av, kwdlist, unused, fmt, va);
+}
+
+
+/*
+ * Parse the arguments to a C/C++ function without any side effects.
+ */
+static int parseKwdArgs(PyObject **parseErrp, const sipArgsView *av,
+        const char **kwdlist, PyObject **unused, const char *fmt,
+        va_list va_orig)
+{
+    int ok, selfarg;
+    PyObject *self;
+    va_list va;
+
+    /* Previous second pass errors stop subsequent parses. */
+    if (*parseErrp != NULL && *parseErrp != unrecorded_failures && !PyList_Check(*parseErrp))
+        return FALSE;
 
     /*
      * The first pass checks all the types and does conversions that are cheap
      * and have no side effects.
      */
     va_copy(va, va_orig);
-    ok = parsePass1(parseErrp, &self, &selfarg, sipArgs, sipKwdArgs, kwdlist,
-            unused, fmt, va);
+    ok = parsePass1(parseErrp, &self, &selfarg, av, kwdlist, unused, fmt, va);
     va_end(va);
 
     if (ok)
@@ -3272,7 +4001,7 @@ static int parseKwdArgs(PyObject **parseErrp, PyObject *sipArgs,
          * have the right signature.
          */
         va_copy(va, va_orig);
-        ok = parsePass2(self, selfarg, sipArgs, sipKwdArgs, kwdlist, fmt, va);
+        ok = parsePass2(self, selfarg, av, kwdlist, fmt, va);
         va_end(va);
 
         /* Remove any previous failed parses. */
@@ -3290,12 +4019,104 @@ static int parseKwdArgs(PyObject **parseErrp, PyObject *sipArgs,
         }
     }
 
-    Py_DECREF(sipArgs);
-
     return ok;
 }
 
 
+/*
+ * Return the number of keyword arguments being parsed.
+ */
+static Py_ssize_t args_view_nr_kwds(const sipArgsView *av)
+{
+    if (av->kwd_dict != NULL)
+        return PyDict_Size(av->kwd_dict);
+
+    if (av->kwd_names != NULL)
+        return PyTuple_GET_SIZE(av->kwd_names);
+
+    return 0;
+}
+
+
+/*
+ * Return a borrowed reference to the value of a named keyword argument or
+ * NULL if it wasn't given.
+ */
+static PyObject *args_view_get_kwd(const sipArgsView *av, const char *name)
+{
+    Py_ssize_t i, nr_kwds;
+
+    if (av->kwd_dict != NULL)
+        return PyDict_GetItemString(av->kwd_dict, name);
+
+    if (av->kwd_names == NULL)
+        return NULL;
+
+    nr_kwds = PyTuple_GET_SIZE(av->kwd_names);
+
+    for (i = 0; i < nr_kwds; ++i)
+    {
+        PyObject *key = PyTuple_GET_ITEM(av->kwd_names, i);
+
+        if (PyUnicode_Check(key) && PyUnicode_CompareWithASCIIString(key, name) == 0)
+            return av->args[av->nr_pos_args + i];
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Iterate over the keyword arguments being parsed in the same way as
+ * PyDict_Next().
+ */
+static int args_view_next_kwd(const sipArgsView *av, Py_ssize_t *posp,
+        PyObject **keyp, PyObject **valuep)
+{
+    if (av->kwd_dict != NULL)
+        return PyDict_Next(av->kwd_dict, posp, keyp, valuep);
+
+    if (av->kwd_names == NULL || *posp >= PyTuple_GET_SIZE(av->kwd_names))
+        return FALSE;
+
+    *keyp = PyTuple_GET_ITEM(av->kwd_names, *posp);
+    *valuep = av->args[av->nr_pos_args + *posp];
+    ++*posp;
+
+    return TRUE;
+}
+
+
+/*
+ * Return a new reference to a dict of the keyword arguments being parsed.
+ */
+static PyObject *args_view_kwd_dict(const sipArgsView *av)
+{
+    PyObject *dict, *key, *value;
+    Py_ssize_t pos = 0;
+
+    if (av->kwd_dict != NULL)
+    {
+        Py_INCREF(av->kwd_dict);
+        return av->kwd_dict;
+    }
+
+    if ((dict = PyDict_New()) == NULL)
+        return NULL;
+
+    while (args_view_next_kwd(av, &pos, &key, &value))
+    {
+        if (PyDict_SetItem(dict, key, value) < 0)
+        {
+            Py_DECREF(dict);
+            return NULL;
+        }
+    }
+
+    return dict;
+}
+
+
 /*
  * Return a string as a Python object that describes an argument with an
  * unexpected type.
@@ -3401,6 +4222,8 @@ static void add_failure(PyObject **parseErrp, sipParseFailure *failure)
         return;
     }
 
+    sipStatsInc(sipStatAllocParseFailures);
+
     *failure_copy = *failure;
 
     if ((failure_obj = PyCapsule_New(failure_copy, NULL, failure_dtor)) == NULL)
@@ -3431,69 +4254,24 @@ static void add_failure(PyObject **parseErrp, sipParseFailure *failure)
 static int sip_api_parse_pair(PyObject **parseErrp, PyObject *sipArg0,
         PyObject *sipArg1, const char *fmt, ...)
 {
-    int ok, selfarg;
-    PyObject *self, *args;
+    int ok;
+    PyObject *args[2];
+    sipArgsView av;
     va_list va;
 
-    /* Previous second pass errors stop subsequent parses. */
-    if (*parseErrp != NULL && !PyList_Check(*parseErrp))
-        return FALSE;
-
-    if ((args = PyTuple_New(sipArg1 != NULL ? 2 : 1)) == NULL)
-    {
-        /* Stop all parsing and indicate an exception has been raised. */
-        Py_XDECREF(*parseErrp);
-        *parseErrp = Py_None;
-        Py_INCREF(Py_None);
-
-        return FALSE;
-    }
-
-    Py_INCREF(sipArg0);
-    PyTuple_SET_ITEM(args, 0, sipArg0);
+    /* The arguments are parsed as a vector rather than a temporary tuple. */
+    args[0] = sipArg0;
+    args[1] = sipArg1;
 
-    if (sipArg1 != NULL)
-    {
-        Py_INCREF(sipArg1);
-        PyTuple_SET_ITEM(args, 1, sipArg1);
-    }
+    av.args = args;
+    av.nr_pos_args = (sipArg1 != NULL ? 2 : 1);
+    av.kwd_dict = NULL;
+    av.kwd_names = NULL;
 
-    /*
-     * The first pass checks all the types and does conversions that are cheap
-     * and have no side effects.
-     */
     va_start(va, fmt);
-    ok = parsePass1(parseErrp, &self, &selfarg, args, NULL, NULL, NULL, fmt,
-            va);
+    ok = parseKwdArgs(parseErrp, &av, NULL, NULL, fmt, va);
     va_end(va);
 
-    if (ok)
-    {
-        /*
-         * The second pass does any remaining conversions now that we know we
-         * have the right signature.
-         */
-        va_start(va, fmt);
-        ok = parsePass2(self, selfarg, args, NULL, NULL, fmt, va);
-        va_end(va);
-
-        /* Remove any previous failed parses. */
-        Py_XDECREF(*parseErrp);
-
-        if (ok)
-        {
-            *parseErrp = NULL;
-        }
-        else
-        {
-            /* Indicate that an exception has been raised. */
-            *parseErrp = Py_None;
-            Py_INCREF(Py_None);
-        }
-    }
-
-    Py_DECREF(args);
-
     return ok;
 }
 
@@ -3503,8 +4281,8 @@ static int sip_api_parse_pair(PyObject **parseErrp, PyObject *sipArg0,
  * without any side effects.  Return TRUE if the arguments matched.
  */
 static int parsePass1(PyObject **parseErrp, PyObject **selfp, int *selfargp,
-        PyObject *sipArgs, PyObject *sipKwdArgs, const char **kwdlist,
-        PyObject **unused, const char *fmt, va_list va)
+        const sipArgsView *av, const char **kwdlist, PyObject **unused,
+        const char *fmt, va_list va)
 {
     int compulsory, argnr, nr_args;
     Py_ssize_t nr_pos_args, nr_kwd_args, nr_kwd_args_used;
@@ -3515,15 +4293,9 @@ static int parsePass1(PyObject **parseErrp, PyObject **selfp, int *selfargp,
     compulsory = TRUE;
     argnr = 0;
     nr_args = 0;
-    nr_pos_args = PyTuple_GET_SIZE(sipArgs);
-    nr_kwd_args = nr_kwd_args_used = 0;
-
-    if (sipKwdArgs != NULL)
-    {
-        assert(PyDict_Check(sipKwdArgs));
-
-        nr_kwd_args = PyDict_Size(sipKwdArgs);
-    }
+    nr_pos_args = av->nr_pos_args;
+    nr_kwd_args = args_view_nr_kwds(av);
+    nr_kwd_args_used = 0;
 
     /*
      * Handle those format characters that deal with the "self" argument.  They
@@ -3554,7 +4326,7 @@ static int parsePass1(PyObject **parseErrp, PyObject **selfp, int *selfargp,
                 /* The call was self.method(...). */
                 *selfp = self;
             }
-            else if (getSelfFromArgs(td, sipArgs, argnr, selfp))
+            else if (getSelfFromArgs(td, av, argnr, selfp))
             {
                 /* The call was cls.method(self, ...). */
                 *selfargp = TRUE;
@@ -3621,110 +4393,8 @@ static int parsePass1(PyObject **parseErrp, PyObject **selfp, int *selfargp,
             }
             else if (nr_kwd_args_used != nr_kwd_args)
             {
-                /*
-                 * Take a shortcut if no keyword arguments were used and we are
-                 * interested in them.
-                 */
-                if (nr_kwd_args_used == 0 && unused != NULL)
-                {
-                    Py_INCREF(sipKwdArgs);
-                    *unused = sipKwdArgs;
-                }
-                else
-                {
-                    PyObject *key, *value, *unused_dict = NULL;
-                    Py_ssize_t pos = 0;
-
-                    /*
-                     * Go through the keyword arguments to find any that were
-                     * duplicates of positional arguments.  For the remaining
-                     * ones remember the unused ones if we are interested.
-                     */
-                    while (PyDict_Next(sipKwdArgs, &pos, &key, &value))
-                    {
-                        int a;
-
-                        if (!PyUnicode_Check(key))
-                        {
-                            failure.reason = KeywordNotString;
-                            failure.detail_obj = key;
-                            Py_INCREF(key);
-                            break;
-                        }
-
-                        if (kwdlist != NULL)
-                        {
-                            /* Get the argument's index if it is one. */
-                            for (a = 0; a < nr_args; ++a)
-                            {
-                                const char *name = kwdlist[a];
-
-                                if (name == NULL)
-                                    continue;
-
-                                if (PyUnicode_CompareWithASCIIString(key, name) == 0)
-                                    break;
-                            }
-                        }
-                        else
-                        {
-                            a = nr_args;
-                        }
-
-                        if (a == nr_args)
-                        {
-                            /*
-                             * The name doesn't correspond to a keyword
-                             * argument.
-                             */
-                            if (unused == NULL)
-                            {
-                                /*
-                                 * It may correspond to a keyword argument of a
-                                 * different overload.
-                                 */
-                                failure.reason = UnknownKeyword;
-                                failure.detail_obj = key;
-                                Py_INCREF(key);
-
-                                break;
-                            }
-
-                            /*
-                             * Add it to the dictionary of unused arguments
-                             * creating it if necessary.  Note that if the
-                             * unused arguments are actually used by a later
-                             * overload then the parse will incorrectly
-                             * succeed.  This should be picked up (perhaps with
-                             * a misleading exception) so long as the code that
-                             * handles the unused arguments checks that it can
-                             * handle them all.
-                             */
-                            if (unused_dict == NULL && (*unused = unused_dict = PyDict_New()) == NULL)
-                            {
-                                failure.reason = Raised;
-                                break;
-                            }
-
-                            if (PyDict_SetItem(unused_dict, key, value) < 0)
-                            {
-                                failure.reason = Raised;
-                                break;
-                            }
-                        }
-                        else if (a < nr_pos_args - *selfargp)
-                        {
-                            /*
-                             * The argument has been given positionally and as
-                             * a keyword.
-                             */
-                            failure.reason = Duplicate;
-                            failure.detail_obj = key;
-                            Py_INCREF(key);
-                            break;
-                        }
-                    }
-                }
+                check_unused_kwds(av, kwdlist, nr_args, *selfargp,
+                        nr_kwd_args_used, unused, &failure);
             }
 
             break;
@@ -3737,7 +4407,7 @@ static int parsePass1(PyObject **parseErrp, PyObject **selfp, int *selfargp,
 
         if (argnr < nr_pos_args)
         {
-            arg = PyTuple_GET_ITEM(sipArgs, argnr);
+            arg = av->args[argnr];
             failure.arg_nr = argnr + 1;
         }
         else if (nr_kwd_args != 0 && kwdlist != NULL)
@@ -3746,7 +4416,7 @@ static int parsePass1(PyObject **parseErrp, PyObject **selfp, int *selfargp,
 
             if (name != NULL)
             {
-                arg = PyDict_GetItemString(sipKwdArgs, name);
+                arg = args_view_get_kwd(av, name);
 
                 if (arg != NULL)
                     ++nr_kwd_args_used;
@@ -3777,52 +4447,8 @@ static int parsePass1(PyObject **parseErrp, PyObject **selfp, int *selfargp,
              * a (possibly) more accurate diagnostic in the case that a keyword
              * argument has been mis-spelled.
              */
-            if (unused == NULL && sipKwdArgs != NULL && nr_kwd_args_used != nr_kwd_args)
-            {
-                PyObject *key, *value;
-                Py_ssize_t pos = 0;
-
-                while (PyDict_Next(sipKwdArgs, &pos, &key, &value))
-                {
-                    int a;
-
-                    if (!PyUnicode_Check(key))
-                    {
-                        failure.reason = KeywordNotString;
-                        failure.detail_obj = key;
-                        Py_INCREF(key);
-                        break;
-                    }
-
-                    if (kwdlist != NULL)
-                    {
-                        /* Get the argument's index if it is one. */
-                        for (a = 0; a < nr_args; ++a)
-                        {
-                            const char *name = kwdlist[a];
-
-                            if (name == NULL)
-                                continue;
-
-                            if (PyUnicode_CompareWithASCIIString(key, name) == 0)
-                                break;
-                        }
-                    }
-                    else
-                    {
-                        a = nr_args;
-                    }
-
-                    if (a == nr_args)
-                    {
-                        failure.reason = UnknownKeyword;
-                        failure.detail_obj = key;
-                        Py_INCREF(key);
-
-                        break;
-                    }
-                }
-            }
+            if (unused == NULL && nr_kwd_args_used != nr_kwd_args)
+                check_unknown_kwds(av, kwdlist, nr_args, &failure);
 
             break;
         }
@@ -4676,34 +5302,224 @@ static int parsePass1(PyObject **parseErrp, PyObject **selfp, int *selfargp,
     if (failure.reason == Ok)
         return TRUE;
 
-    if (failure.reason == Overflow)
+    report_failure(parseErrp, &failure);
+
+    return FALSE;
+}
+
+
+/*
+ * Check the keyword arguments once all the expected arguments have been
+ * parsed.  Any that weren't used are either returned as a dict, if the caller
+ * is interested, or reported.  Any that duplicate positional arguments are
+ * also reported.
+ */
+static void check_unused_kwds(const sipArgsView *av, const char **kwdlist,
+        int nr_args, int selfarg, Py_ssize_t nr_kwd_args_used,
+        PyObject **unused, sipParseFailure *failure)
+{
+    /*
+     * Take a shortcut if no keyword arguments were used and we are interested
+     * in them.
+     */
+    if (nr_kwd_args_used == 0 && unused != NULL)
+    {
+        if ((*unused = args_view_kwd_dict(av)) == NULL)
+            failure->reason = Raised;
+    }
+    else
+    {
+        PyObject *key, *value, *unused_dict = NULL;
+        Py_ssize_t pos = 0;
+
+        /*
+         * Go through the keyword arguments to find any that were duplicates of
+         * positional arguments.  For the remaining ones remember the unused
+         * ones if we are interested.
+         */
+        while (args_view_next_kwd(av, &pos, &key, &value))
+        {
+            int a;
+
+            if (!PyUnicode_Check(key))
+            {
+                failure->reason = KeywordNotString;
+                failure->detail_obj = key;
+                Py_INCREF(key);
+                break;
+            }
+
+            if (kwdlist != NULL)
+            {
+                /* Get the argument's index if it is one. */
+                for (a = 0; a < nr_args; ++a)
+                {
+                    const char *name = kwdlist[a];
+
+                    if (name == NULL)
+                        continue;
+
+                    if (PyUnicode_CompareWithASCIIString(key, name) == 0)
+                        break;
+                }
+            }
+            else
+            {
+                a = nr_args;
+            }
+
+            if (a == nr_args)
+            {
+                /* The name doesn't correspond to a keyword argument. */
+                if (unused == NULL)
+                {
+                    /*
+                     * It may correspond to a keyword argument of a different
+                     * overload.
+                     */
+                    failure->reason = UnknownKeyword;
+                    failure->detail_obj = key;
+                    Py_INCREF(key);
+
+                    break;
+                }
+
+                /*
+                 * Add it to the dictionary of unused arguments creating it if
+                 * necessary.  Note that if the unused arguments are actually
+                 * used by a later overload then the parse will incorrectly
+                 * succeed.  This should be picked up (perhaps with a
+                 * misleading exception) so long as the code that handles the
+                 * unused arguments checks that it can handle them all.
+                 */
+                if (unused_dict == NULL && (*unused = unused_dict = PyDict_New()) == NULL)
+                {
+                    failure->reason = Raised;
+                    break;
+                }
+
+                if (PyDict_SetItem(unused_dict, key, value) < 0)
+                {
+                    failure->reason = Raised;
+                    break;
+                }
+            }
+            else if (a < av->nr_pos_args - selfarg)
+            {
+                /*
+                 * The argument has been given positionally and as a keyword.
+                 */
+                failure->reason = Duplicate;
+                failure->detail_obj = key;
+                Py_INCREF(key);
+                break;
+            }
+        }
+    }
+}
+
+
+/*
+ * Check for an unknown keyword argument after too few arguments were found so
+ * that we give a (possibly) more accurate diagnostic in the case that a
+ * keyword argument has been mis-spelled.
+ */
+static void check_unknown_kwds(const sipArgsView *av, const char **kwdlist,
+        int nr_args, sipParseFailure *failure)
+{
+    PyObject *key, *value;
+    Py_ssize_t pos = 0;
+
+    while (args_view_next_kwd(av, &pos, &key, &value))
+    {
+        int a;
+
+        if (!PyUnicode_Check(key))
+        {
+            failure->reason = KeywordNotString;
+            failure->detail_obj = key;
+            Py_INCREF(key);
+            break;
+        }
+
+        if (kwdlist != NULL)
+        {
+            /* Get the argument's index if it is one. */
+            for (a = 0; a < nr_args; ++a)
+            {
+                const char *name = kwdlist[a];
+
+                if (name == NULL)
+                    continue;
+
+                if (PyUnicode_CompareWithASCIIString(key, name) == 0)
+                    break;
+            }
+        }
+        else
+        {
+            a = nr_args;
+        }
+
+        if (a == nr_args)
+        {
+            failure->reason = UnknownKeyword;
+            failure->detail_obj = key;
+            Py_INCREF(key);
+
+            break;
+        }
+    }
+}
+
+
+/*
+ * Handle the failure of the first pass of an argument parse by either adding
+ * it to the list of failures or raising an exception.
+ */
+static void report_failure(PyObject **parseErrp, sipParseFailure *failure)
+{
+    sipStatsInc(sipStatFailedOverloads);
+
+    if (failure->reason == Overflow)
     {
         /*
          * We have successfully parsed the signature but one of the arguments
          * has been found to overflow.  Raise an appropriate exception and
          * ensure we don't parse any subsequent overloads.
          */
-        if (failure.overflow_arg_nr >= 0)
+        if (failure->overflow_arg_nr >= 0)
         {
             PyErr_Format(PyExc_OverflowError, "argument %d overflowed: %S",
-                    failure.overflow_arg_nr, failure.detail_obj);
+                    failure->overflow_arg_nr, failure->detail_obj);
         }
         else
         {
             PyErr_Format(PyExc_OverflowError, "argument '%s' overflowed: %S",
-                    failure.overflow_arg_name, failure.detail_obj);
+                    failure->overflow_arg_name, failure->detail_obj);
         }
 
         /* The overflow exception has now been raised. */
-        failure.reason = Raised;
+        failure->reason = Raised;
     }
 
-    if (failure.reason != Raised)
-        add_failure(parseErrp, &failure);
+    if (failure->reason != Raised)
+    {
+        if (*parseErrp == unrecorded_failures)
+        {
+            /* The failure will be recorded if it needs to be diagnosed. */
+            Py_XDECREF(failure->detail_obj);
+            failure->detail_obj = NULL;
+        }
+        else
+        {
+            add_failure(parseErrp, failure);
+        }
+    }
 
-    if (failure.reason == Raised)
+    if (failure->reason == Raised)
     {
-        Py_XDECREF(failure.detail_obj);
+        Py_XDECREF(failure->detail_obj);
 
         /*
          * Discard any previous errors and flag that the exception we want the
@@ -4713,8 +5529,20 @@ static int parsePass1(PyObject **parseErrp, PyObject **selfp, int *selfargp,
         *parseErrp = Py_None;
         Py_INCREF(Py_None);
     }
+}
 
-    return FALSE;
+
+/*
+ * Arrange for any failures of a parse of arguments passed using the vectorcall
+ * protocol not to be recorded unless they are being diagnosed.
+ */
+static void defer_failures(PyObject **parseErrp)
+{
+    if (*parseErrp == NULL && parse_diagnosis_depth == 0)
+    {
+        *parseErrp = unrecorded_failures;
+        Py_INCREF(unrecorded_failures);
+    }
 }
 
 
@@ -4764,11 +5592,10 @@ static void handle_failed_type_conversion(sipParseFailure *pf, PyObject *arg)
  * Second pass of the argument parse, converting the remaining ones that might
  * have side effects.  Return TRUE if there was no error.
  */
-static int parsePass2(PyObject *self, int selfarg, PyObject *sipArgs,
-        PyObject *sipKwdArgs, const char **kwdlist, const char *fmt,
-        va_list va)
+static int parsePass2(PyObject *self, int selfarg, const sipArgsView *av,
+        const char **kwdlist, const char *fmt, va_list va)
 {
-    int a, ok, isstatic = FALSE;
+    int a, ok, have_kwds, isstatic = FALSE;
     Py_ssize_t nr_pos_args;
 
     /* Handle the conversions of "self" first. */
@@ -4828,7 +5655,8 @@ static int parsePass2(PyObject *self, int selfarg, PyObject *sipArgs,
     }
 
     ok = TRUE;
-    nr_pos_args = PyTuple_GET_SIZE(sipArgs);
+    nr_pos_args = av->nr_pos_args;
+    have_kwds = (kwdlist != NULL && args_view_nr_kwds(av) != 0);
 
     for (a = (selfarg ? 1 : 0); *fmt != '\0' && *fmt != 'W' && ok; ++a)
     {
@@ -4844,14 +5672,14 @@ static int parsePass2(PyObject *self, int selfarg, PyObject *sipArgs,
 
         if (a < nr_pos_args)
         {
-            arg = PyTuple_GET_ITEM(sipArgs, a);
+            arg = av->args[a];
         }
-        else if (sipKwdArgs != NULL)
+        else if (have_kwds)
         {
             const char *name = kwdlist[a - selfarg];
 
             if (name != NULL)
-                arg = PyDict_GetItemString(sipKwdArgs, name);
+                arg = args_view_get_kwd(av, name);
         }
 
         /*
@@ -5123,7 +5951,7 @@ static int parsePass2(PyObject *self, int selfarg, PyObject *sipArgs,
 
         while (a < nr_pos_args)
         {
-            PyObject *arg = PyTuple_GET_ITEM(sipArgs, a);
+            PyObject *arg = av->args[a];
 
             /* Add the remaining argument to the tuple. */
             Py_INCREF(arg);
@@ -5142,94 +5970,768 @@ static int parsePass2(PyObject *self, int selfarg, PyObject *sipArgs,
 
 
 /*
- * See if a Python object is a sequence of a particular type.
+ * Return the number of outputs of a parse plan used by an entry.
  */
-static int canConvertFromSequence(PyObject *seq, const sipTypeDef *td)
+static int plan_nr_outputs(const sipParsePlanDef *pd)
 {
-    Py_ssize_t i, size = PySequence_Size(seq);
+    int nr;
 
-    if (size < 0)
-        return FALSE;
-
-    /*
-     * Check the type of each element.  Note that this is inconsistent with how
-     * similiar situations are handled elsewhere.  We should instead just check
-     * we have an iterator and assume (until the second pass) that the type is
-     * correct.
-     */
-    for (i = 0; i < size; ++i)
+    switch (pd->pd_kind)
     {
-        int ok;
-        PyObject *val_obj;
+    case sipPlanSelf:
+    case sipPlanProtectedSelf:
+        return 2;
 
-        if ((val_obj = PySequence_GetItem(seq, i)) == NULL)
-            return FALSE;
+    case sipPlanInstance:
+        /* The C++ pointer and the state. */
+        nr = 2;
 
-        ok = sip_api_can_convert_to_type(val_obj, td,
-                SIP_NO_CONVERTORS|SIP_NOT_NONE);
+        if (pd->pd_flags & SIP_PLAN_TRANSFER_THIS)
+            ++nr;
 
-        Py_DECREF(val_obj);
+        if (pd->pd_flags & SIP_PLAN_NO_CONVERTORS)
+            --nr;
 
-        if (!ok)
-            return FALSE;
+        if (sipTypeNeedsUserState(*pd->pd_type))
+            ++nr;
+
+        return nr;
+
+    default:
+        break;
     }
 
-    return TRUE;
+    return 1;
 }
 
 
 /*
- * Convert a Python sequence to an array that has already "passed"
- * canConvertFromSequence().  Return TRUE if the conversion was successful.
+ * First pass of a planned argument parse, converting those that can be done
+ * so without any side effects.  Return TRUE if the arguments matched.  This
+ * is the equivalent of parsePass1() but is driven by a table rather than a
+ * format string.
  */
-static int convertFromSequence(PyObject *seq, const sipTypeDef *td,
-        void **array, Py_ssize_t *nr_elem)
+static int parsePlanPass1(PyObject **parseErrp, PyObject **selfp,
+        int *selfargp, const sipArgsView *av, const char **kwdlist,
+        PyObject **unused, const sipParsePlanDef *plan, void **outputs)
 {
-    int iserr = 0;
-    Py_ssize_t i, size = PySequence_Size(seq);
-    sipArrayFunc array_helper;
-    sipAssignFunc assign_helper;
-    void *array_mem;
-
-    /* Get the type's helpers. */
-    if (sipTypeIsMapped(td))
-    {
-        array_helper = ((const sipMappedTypeDef *)td)->mtd_array;
-        assign_helper = ((const sipMappedTypeDef *)td)->mtd_assign;
-    }
-    else
-    {
-        array_helper = ((const sipClassTypeDef *)td)->ctd_array;
-        assign_helper = ((const sipClassTypeDef *)td)->ctd_assign;
-    }
+    int argnr, nr_args;
+    Py_ssize_t nr_pos_args, nr_kwd_args, nr_kwd_args_used;
+    sipParseFailure failure;
 
-    assert(array_helper != NULL);
-    assert(assign_helper != NULL);
+    failure.reason = Ok;
+    failure.detail_obj = NULL;
+    argnr = 0;
+    nr_args = 0;
+    nr_pos_args = av->nr_pos_args;
+    nr_kwd_args = args_view_nr_kwds(av);
+    nr_kwd_args_used = 0;
 
-    /*
-     * Create the memory for the array of values.  Note that this will leak if
-     * there is an error.
-     */
-    array_mem = array_helper(size);
+    /* Handle any "self" argument.  It will always be the first one. */
+    *selfp = NULL;
+    *selfargp = FALSE;
 
-    for (i = 0; i < size; ++i)
+    switch (plan->pd_kind)
     {
-        PyObject *val_obj;
-        void *val;
-
-        if ((val_obj = PySequence_GetItem(seq, i)) == NULL)
-            return FALSE;
-
-        val = sip_api_convert_to_type_us(val_obj, td, NULL,
-                SIP_NO_CONVERTORS|SIP_NOT_NONE, NULL, NULL, &iserr);
-
-        Py_DECREF(val_obj);
-
-        if (iserr)
-            return FALSE;
+    case sipPlanSelf:
+    case sipPlanProtectedSelf:
+        {
+            PyObject *self = *(PyObject **)outputs[0];
+            sipTypeDef *td = *plan->pd_type;
 
-        assign_helper(array_mem, i, val);
-    }
+            if (PyObject_TypeCheck(self, (PyTypeObject *)&sipSimpleWrapper_Type))
+            {
+                /* The call was self.method(...). */
+                *selfp = self;
+            }
+            else if (getSelfFromArgs(td, av, argnr, selfp))
+            {
+                /* The call was cls.method(self, ...). */
+                *selfargp = TRUE;
+                ++argnr;
+            }
+            else
+            {
+                failure.reason = Unbound;
+                failure.detail_str = sipPyNameOfContainer(
+                        &((sipClassTypeDef *)td)->ctd_container, td);
+            }
+
+            outputs += 2;
+            ++plan;
+
+            break;
+        }
+
+    case sipPlanCls:
+        {
+            PyObject *self = *(PyObject **)outputs[0];
+
+            /*
+             * If the call was self.method(...) rather than cls.method(...)
+             * then get cls from self.
+             */
+            if (PyObject_TypeCheck(self, (PyTypeObject *)&sipWrapper_Type))
+                self = (PyObject *)Py_TYPE(self);
+
+            *selfp = self;
+
+            ++outputs;
+            ++plan;
+
+            break;
+        }
+
+    default:
+        break;
+    }
+
+    /*
+     * Now handle the remaining arguments.  We continue to parse if we get an
+     * overflow because that is, strictly speaking, a second pass error.
+     */
+    for (; failure.reason == Ok || failure.reason == Overflow; ++plan)
+    {
+        PyObject *arg;
+        void *p;
+
+        PyErr_Clear();
+
+        /* See if we don't expect anything else. */
+        if (plan->pd_kind == sipPlanEnd)
+        {
+            if (argnr < nr_pos_args)
+            {
+                /* There are still positional arguments. */
+                failure.reason = TooMany;
+            }
+            else if (nr_kwd_args_used != nr_kwd_args)
+            {
+                check_unused_kwds(av, kwdlist, nr_args, *selfargp,
+                        nr_kwd_args_used, unused, &failure);
+            }
+
+            break;
+        }
+
+        /* Get the next argument. */
+        arg = NULL;
+        failure.arg_nr = -1;
+        failure.arg_name = NULL;
+
+        if (argnr < nr_pos_args)
+        {
+            arg = av->args[argnr];
+            failure.arg_nr = argnr + 1;
+        }
+        else if (nr_kwd_args != 0 && kwdlist != NULL)
+        {
+            const char *name = kwdlist[argnr - *selfargp];
+
+            if (name != NULL)
+            {
+                arg = args_view_get_kwd(av, name);
+
+                if (arg != NULL)
+                    ++nr_kwd_args_used;
+
+                failure.arg_name = name;
+            }
+        }
+
+        ++argnr;
+        ++nr_args;
+
+        p = outputs[0];
+        outputs += plan_nr_outputs(plan);
+
+        if (arg == NULL)
+        {
+            if (plan->pd_flags & SIP_PLAN_OPTIONAL)
+                continue;
+
+            /* An argument was required. */
+            failure.reason = TooFew;
+
+            if (unused == NULL && nr_kwd_args_used != nr_kwd_args)
+                check_unknown_kwds(av, kwdlist, nr_args, &failure);
+
+            break;
+        }
+
+        switch (plan->pd_kind)
+        {
+        case sipPlanBool:
+            {
+                int v = sip_api_convert_to_bool(arg);
+
+                if (v < 0)
+                    handle_failed_type_conversion(&failure, arg);
+                else
+                    sip_set_bool(p, v);
+
+                break;
+            }
+
+        case sipPlanInt:
+            {
+                int v = sip_api_long_as_int(arg);
+
+                if (PyErr_Occurred())
+                    handle_failed_int_conversion(&failure, arg);
+                else
+                    *(int *)p = v;
+
+                break;
+            }
+
+        case sipPlanUnsignedInt:
+            {
+                unsigned v = sip_api_long_as_unsigned_int(arg);
+
+                if (PyErr_Occurred())
+                    handle_failed_int_conversion(&failure, arg);
+                else
+                    *(unsigned *)p = v;
+
+                break;
+            }
+
+        case sipPlanShort:
+            {
+                signed short v = sip_api_long_as_short(arg);
+
+                if (PyErr_Occurred())
+                    handle_failed_int_conversion(&failure, arg);
+                else
+                    *(signed short *)p = v;
+
+                break;
+            }
+
+        case sipPlanUnsignedShort:
+            {
+                unsigned short v = sip_api_long_as_unsigned_short(arg);
+
+                if (PyErr_Occurred())
+                    handle_failed_int_conversion(&failure, arg);
+                else
+                    *(unsigned short *)p = v;
+
+                break;
+            }
+
+        case sipPlanLong:
+            {
+                long v = sip_api_long_as_long(arg);
+
+                if (PyErr_Occurred())
+                    handle_failed_int_conversion(&failure, arg);
+                else
+                    *(long *)p = v;
+
+                break;
+            }
+
+        case sipPlanUnsignedLong:
+            {
+                unsigned long v = sip_api_long_as_unsigned_long(arg);
+
+                if (PyErr_Occurred())
+                    handle_failed_int_conversion(&failure, arg);
+                else
+                    *(unsigned long *)p = v;
+
+                break;
+            }
+
+        case sipPlanLongLong:
+            {
+                long long v = sip_api_long_as_long_long(arg);
+
+                if (PyErr_Occurred())
+                    handle_failed_int_conversion(&failure, arg);
+                else
+                    *(long long *)p = v;
+
+                break;
+            }
+
+        case sipPlanUnsignedLongLong:
+            {
+                unsigned long long v = sip_api_long_as_unsigned_long_long(arg);
+
+                if (PyErr_Occurred())
+                    handle_failed_int_conversion(&failure, arg);
+                else
+                    *(unsigned long long *)p = v;
+
+                break;
+            }
+
+        case sipPlanSize:
+            {
+                size_t v = sip_api_long_as_size_t(arg);
+
+                if (PyErr_Occurred())
+                    handle_failed_int_conversion(&failure, arg);
+                else
+                    *(size_t *)p = v;
+
+                break;
+            }
+
+        case sipPlanChar:
+            {
+                char v = sip_api_long_as_char(arg);
+
+                if (PyErr_Occurred())
+                    handle_failed_int_conversion(&failure, arg);
+                else
+                    *(char *)p = v;
+
+                break;
+            }
+
+        case sipPlanSignedChar:
+            {
+                signed char v = sip_api_long_as_signed_char(arg);
+
+                if (PyErr_Occurred())
+                    handle_failed_int_conversion(&failure, arg);
+                else
+                    *(signed char *)p = v;
+
+                break;
+            }
+
+        case sipPlanUnsignedChar:
+            {
+                unsigned char v = sip_api_long_as_unsigned_char(arg);
+
+                if (PyErr_Occurred())
+                    handle_failed_int_conversion(&failure, arg);
+                else
+                    *(unsigned char *)p = v;
+
+                break;
+            }
+
+        case sipPlanFloat:
+            {
+                double v = PyFloat_AsDouble(arg);
+
+                if (PyErr_Occurred())
+                    handle_failed_type_conversion(&failure, arg);
+                else
+                    *(float *)p = (float)v;
+
+                break;
+            }
+
+        case sipPlanDouble:
+            {
+                double v = PyFloat_AsDouble(arg);
+
+                if (PyErr_Occurred())
+                    handle_failed_type_conversion(&failure, arg);
+                else
+                    *(double *)p = v;
+
+                break;
+            }
+
+        case sipPlanEnum:
+            {
+                int v = sip_api_convert_to_enum(arg, *plan->pd_type);
+
+                if (PyErr_Occurred())
+                    handle_failed_type_conversion(&failure, arg);
+                else
+                    *(int *)p = v;
+
+                break;
+            }
+
+        case sipPlanInstance:
+            {
+                int iflgs = 0;
+
+                if (plan->pd_flags & SIP_PLAN_DEREF)
+                    iflgs |= SIP_NOT_NONE;
+
+                if (plan->pd_flags & SIP_PLAN_NO_CONVERTORS)
+                    iflgs |= SIP_NO_CONVERTORS;
+
+                if (!sip_api_can_convert_to_type(arg, *plan->pd_type, iflgs))
+                    handle_failed_type_conversion(&failure, arg);
+
+                break;
+            }
+
+        default:
+            /* The code generator will only create valid plans. */
+            break;
+        }
+    }
+
+    /* Handle parse failures appropriately. */
+
+    if (failure.reason == Ok)
+        return TRUE;
+
+    report_failure(parseErrp, &failure);
+
+    return FALSE;
+}
+
+
+/*
+ * Second pass of a planned argument parse, converting the remaining ones that
+ * might have side effects.  Return TRUE if there was no error.
+ */
+static int parsePlanPass2(PyObject *self, int selfarg, const sipArgsView *av,
+        const char **kwdlist, const sipParsePlanDef *plan, void **outputs)
+{
+    int a, have_kwds, isstatic = FALSE;
+    Py_ssize_t nr_pos_args;
+
+    /* Handle the conversions of "self" first. */
+    switch (plan->pd_kind)
+    {
+    case sipPlanSelf:
+        *(PyObject **)outputs[0] = self;
+
+        if ((*(void **)outputs[1] = sip_api_get_cpp_ptr((sipSimpleWrapper *)self, *plan->pd_type)) == NULL)
+            return FALSE;
+
+        outputs += 2;
+        ++plan;
+
+        break;
+
+    case sipPlanProtectedSelf:
+        *(PyObject **)outputs[0] = self;
+
+        if ((*(void **)outputs[1] = getComplexCppPtr((sipSimpleWrapper *)self, *plan->pd_type)) == NULL)
+            return FALSE;
+
+        outputs += 2;
+        ++plan;
+
+        break;
+
+    case sipPlanCls:
+        *(PyObject **)outputs[0] = self;
+        isstatic = TRUE;
+
+        ++outputs;
+        ++plan;
+
+        break;
+
+    default:
+        break;
+    }
+
+    nr_pos_args = av->nr_pos_args;
+    have_kwds = (kwdlist != NULL && args_view_nr_kwds(av) != 0);
+
+    /* Only instances have any outstanding conversions. */
+    for (a = (selfarg ? 1 : 0); plan->pd_kind != sipPlanEnd; ++a, ++plan)
+    {
+        if (plan->pd_kind == sipPlanInstance)
+        {
+            int flags = plan->pd_flags;
+            const sipTypeDef *td = *plan->pd_type;
+            void **p, **user_statep;
+            int iflgs = 0, iserr = FALSE;
+            int *statep;
+            PyObject *arg, *xfer, **owner;
+
+            /* Get the argument. */
+            arg = NULL;
+
+            if (a < nr_pos_args)
+            {
+                arg = av->args[a];
+            }
+            else if (have_kwds)
+            {
+                const char *name = kwdlist[a - selfarg];
+
+                if (name != NULL)
+                    arg = args_view_get_kwd(av, name);
+            }
+
+            if (arg == NULL)
+            {
+                outputs += plan_nr_outputs(plan);
+                continue;
+            }
+
+            p = (void **)*outputs++;
+
+            if (flags & SIP_PLAN_TRANSFER)
+                xfer = ((isstatic || self == NULL) ? arg : self);
+            else if (flags & SIP_PLAN_TRANSFER_BACK)
+                xfer = Py_None;
+            else
+                xfer = NULL;
+
+            if (flags & SIP_PLAN_DEREF)
+                iflgs |= SIP_NOT_NONE;
+
+            if (flags & SIP_PLAN_TRANSFER_THIS)
+                owner = (PyObject **)*outputs++;
+            else
+                owner = NULL;
+
+            if (flags & SIP_PLAN_NO_CONVERTORS)
+            {
+                iflgs |= SIP_NO_CONVERTORS;
+                statep = NULL;
+            }
+            else
+            {
+                statep = (int *)*outputs++;
+            }
+
+            if (sipTypeNeedsUserState(td))
+                user_statep = (void **)*outputs++;
+            else
+                user_statep = NULL;
+
+            *p = sip_api_convert_to_type_us(arg, td, xfer, iflgs, statep,
+                    user_statep, &iserr);
+
+            if (iserr)
+                return FALSE;
+
+            if (owner != NULL && *p != NULL)
+                *owner = arg;
+        }
+        else
+        {
+            outputs += plan_nr_outputs(plan);
+        }
+    }
+
+    return TRUE;
+}
+
+
+/*
+ * Exact lists and tuples give direct access to their items.  Only tuples are
+ * used with free-threaded Python as a list may be modified concurrently.
+ */
+#if defined(Py_GIL_DISABLED)
+#define is_fast_sequence(o)     PyTuple_CheckExact(o)
+#else
+#define is_fast_sequence(o)     (PyList_CheckExact(o) || PyTuple_CheckExact(o))
+#endif
+
+
+/*
+ * Return a new reference to an item of a sequence.
+ */
+static PyObject *get_sequence_item(PyObject *seq, Py_ssize_t i)
+{
+    PyObject *item;
+
+    if (!is_fast_sequence(seq))
+        return PySequence_GetItem(seq, i);
+
+    /* A convertor may have run Python code that changed the size of a list. */
+    if (i >= PySequence_Fast_GET_SIZE(seq))
+    {
+        PyErr_SetString(PyExc_IndexError, "sequence index out of range");
+        return NULL;
+    }
+
+    item = PySequence_Fast_GET_ITEM(seq, i);
+    Py_INCREF(item);
+
+    return item;
+}
+
+
+/*
+ * Get a C contiguous buffer from an object that can be copied to an array of a
+ * plain old data type.  Return the number of elements or -1 if the object
+ * isn't suitable.  The buffer must be released by the caller if it was got.
+ */
+static Py_ssize_t get_pod_buffer(PyObject *obj, const sipTypeDef *td,
+        Py_buffer *view)
+{
+    size_t elem_size;
+
+    if (!sipTypeIsMapped(td) || !sipTypeIsPOD(td) || !PyObject_CheckBuffer(obj))
+        return -1;
+
+    elem_size = ((const sipMappedTypeDef *)td)->mtd_sizeof;
+
+    if (PyObject_GetBuffer(obj, view, PyBUF_C_CONTIGUOUS) < 0)
+    {
+        PyErr_Clear();
+        return -1;
+    }
+
+    if (elem_size == 0 || view->len % elem_size != 0)
+    {
+        PyBuffer_Release(view);
+        return -1;
+    }
+
+    return view->len / elem_size;
+}
+
+
+/*
+ * See if a Python object is a sequence of a particular type.
+ */
+static int canConvertFromSequence(PyObject *seq, const sipTypeDef *td)
+{
+    Py_ssize_t i, size;
+    Py_buffer view;
+
+    /* A buffer can be copied directly to an array of a plain old data type. */
+    if (get_pod_buffer(seq, td, &view) >= 0)
+    {
+        PyBuffer_Release(&view);
+        return TRUE;
+    }
+
+    if ((size = PySequence_Size(seq)) < 0)
+        return FALSE;
+
+    /*
+     * Check the type of each element.  Note that this is inconsistent with how
+     * similiar situations are handled elsewhere.  We should instead just check
+     * we have an iterator and assume (until the second pass) that the type is
+     * correct.
+     */
+    for (i = 0; i < size; ++i)
+    {
+        int ok;
+        PyObject *val_obj;
+
+        if ((val_obj = get_sequence_item(seq, i)) == NULL)
+            return FALSE;
+
+        ok = sip_api_can_convert_to_type(val_obj, td,
+                SIP_NO_CONVERTORS|SIP_NOT_NONE);
+
+        Py_DECREF(val_obj);
+
+        if (!ok)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+/*
+ * Convert a Python sequence to an array that has already "passed"
+ * canConvertFromSequence().  Return TRUE if the conversion was successful.
+ */
+static int convertFromSequence(PyObject *seq, const sipTypeDef *td,
+        void **array, Py_ssize_t *nr_elem)
+{
+    int iserr = 0;
+    Py_ssize_t i, size;
+    sipArrayFunc array_helper;
+    sipAssignFunc assign_helper;
+    sipConvertToFunc cto;
+    Py_buffer view;
+    void *array_mem;
+
+    /* Get the type's helpers. */
+    if (sipTypeIsMapped(td))
+    {
+        array_helper = ((const sipMappedTypeDef *)td)->mtd_array;
+        assign_helper = ((const sipMappedTypeDef *)td)->mtd_assign;
+        cto = ((const sipMappedTypeDef *)td)->mtd_cto;
+
+        /* Handwritten code that needs user state takes the long way round. */
+        if (sipTypeNeedsUserState(td))
+            cto = NULL;
+    }
+    else
+    {
+        array_helper = ((const sipClassTypeDef *)td)->ctd_array;
+        assign_helper = ((const sipClassTypeDef *)td)->ctd_assign;
+        cto = NULL;
+    }
+
+    assert(array_helper != NULL);
+    assert(assign_helper != NULL);
+
+    /* Copy a buffer to an array of a plain old data type in one go. */
+    if ((size = get_pod_buffer(seq, td, &view)) >= 0)
+    {
+        if ((array_mem = array_helper(size)) == NULL)
+        {
+            PyBuffer_Release(&view);
+            PyErr_NoMemory();
+            return FALSE;
+        }
+
+        memcpy(array_mem, view.buf, view.len);
+        PyBuffer_Release(&view);
+
+        *array = array_mem;
+        *nr_elem = size;
+
+        return TRUE;
+    }
+
+    if ((size = PySequence_Size(seq)) < 0)
+        return FALSE;
+
+    /*
+     * Create the memory for the array of values.  Note that this will leak if
+     * there is an error.
+     */
+    array_mem = array_helper(size);
+
+    for (i = 0; i < size; ++i)
+    {
+        PyObject *val_obj;
+        void *val;
+        int state = 0;
+
+        if ((val_obj = get_sequence_item(seq, i)) == NULL)
+            return FALSE;
+
+        /*
+         * Use the convertor (for mapped types) or the C/C++ pointer (for
+         * classes) directly rather than decode the same flags for every
+         * element.
+         */
+        if (val_obj == Py_None)
+            val = sip_api_convert_to_type_us(val_obj, td, NULL,
+                    SIP_NO_CONVERTORS|SIP_NOT_NONE, &state, NULL, &iserr);
+        else if (cto != NULL)
+            state = cto(val_obj, &val, &iserr, NULL, NULL);
+        else if (sipTypeIsClass(td))
+            iserr = ((val = sip_api_get_cpp_ptr((sipSimpleWrapper *)val_obj, td)) == NULL);
+        else
+            val = sip_api_convert_to_type_us(val_obj, td, NULL,
+                    SIP_NO_CONVERTORS|SIP_NOT_NONE, &state, NULL, &iserr);
+
+        Py_DECREF(val_obj);
+
+        if (iserr)
+            return FALSE;
+
+        assign_helper(array_mem, i, val);
+
+        /* The array has its own copy of any temporary value. */
+        if (state & SIP_TEMPORARY)
+            release(val, td, state, NULL);
+    }
 
     *array = array_mem;
     *nr_elem = size;
@@ -5247,6 +6749,7 @@ static PyObject *convertToSequence(void *array, Py_ssize_t nr_elem,
     Py_ssize_t i;
     PyObject *seq;
     sipCopyFunc copy_helper;
+    sipConvertFromFunc cfrom;
 
     /* Get the type's copy helper. */
     if (sipTypeIsMapped(td))
@@ -5256,18 +6759,38 @@ static PyObject *convertToSequence(void *array, Py_ssize_t nr_elem,
 
     assert(copy_helper != NULL);
 
+    /*
+     * Get any convertor once rather than for every element (unless a proxy
+     * may need resolving first).
+     */
+    cfrom = (proxyResolvers == NULL ? get_from_convertor(td) : NULL);
+
     if ((seq = PyTuple_New(nr_elem)) == NULL)
         return NULL;
 
     for (i = 0; i < nr_elem; ++i)
     {
         void *el = copy_helper(array, i);
-        PyObject *el_obj = sip_api_convert_from_new_type(el, td, NULL);
+        PyObject *el_obj;
 
-        if (el_obj == NULL)
+        if (cfrom != NULL)
         {
+            /* This is equivalent to sip_api_convert_from_new_type(). */
+            el_obj = cfrom(el, NULL);
             release(el, td, 0, NULL);
+        }
+        else
+        {
+            el_obj = sip_api_convert_from_new_type(el, td, NULL);
+
+            if (el_obj == NULL)
+                release(el, td, 0, NULL);
+        }
+
+        if (el_obj == NULL)
+        {
             Py_DECREF(seq);
+            return NULL;
         }
 
         PyTuple_SET_ITEM(seq, i, el_obj);
@@ -5408,6 +6931,9 @@ static void addToParent(sipWrapper *self, sipWrapper *owner)
     owner->first_child = self;
     self->parent = owner;
 
+    /* The owner now has a reference to a child. */
+    track((sipSimpleWrapper *)owner);
+
     /*
      * The owner holds a real reference so that the cyclic garbage collector
      * works properly.
@@ -5417,131 +6943,506 @@ static void addToParent(sipWrapper *self, sipWrapper *owner)
 
 
 /*
- * Remove a wrapper from it's parent if it has one.
+ * Remove a wrapper from it's parent if it has one.
+ */
+static void removeFromParent(sipWrapper *self)
+{
+    if (self->parent != NULL)
+    {
+        if (self->parent->first_child == self)
+            self->parent->first_child = self->sibling_next;
+
+        if (self->sibling_next != NULL)
+            self->sibling_next->sibling_prev = self->sibling_prev;
+
+        if (self->sibling_prev != NULL)
+            self->sibling_prev->sibling_next = self->sibling_next;
+
+        self->parent = NULL;
+        self->sibling_next = NULL;
+        self->sibling_prev = NULL;
+
+        /*
+         * We must do this last, after all the pointers are correct, because
+         * this is used by the clear slot.
+         */
+        Py_DECREF((sipSimpleWrapper *)self);
+    }
+}
+
+
+/*
+ * Detach and children of a parent.
+ */
+static void detachChildren(sipWrapper *self)
+{
+    while (self->first_child != NULL)
+        removeFromParent(self->first_child);
+}
+
+
+/*
+ * Convert a sequence index.  Return the index or a negative value if there was
+ * an error.
+ */
+static Py_ssize_t sip_api_convert_from_sequence_index(Py_ssize_t idx,
+        Py_ssize_t len)
+{
+    /* Negative indices start from the other end. */
+    if (idx < 0)
+        idx = len + idx;
+
+    if (idx < 0 || idx >= len)
+    {
+        PyErr_Format(PyExc_IndexError, "sequence index out of range");
+        return -1;
+    }
+
+    return idx;
+}
+
+
+/*
+ * Return a tuple of the base class of a type that has no explicit super-type.
+ */
+static PyObject *getDefaultBase(void)
+{
+    static PyObject *default_base = NULL;
+
+    /* Only do this once. */
+    if (default_base == NULL)
+    {
+        if ((default_base = PyTuple_Pack(1, (PyObject *)&sipWrapper_Type)) == NULL)
+            return NULL;
+    }
+
+    Py_INCREF(default_base);
+
+    return default_base;
+}
+
+
+/*
+ * Return a tuple of the base class of a simple type that has no explicit
+ * super-type.
+ */
+static PyObject *getDefaultSimpleBase(void)
+{
+    static PyObject *default_simple_base = NULL;
+
+    /* Only do this once. */
+    if (default_simple_base == NULL)
+    {
+        if ((default_simple_base = PyTuple_Pack(1, (PyObject *)&sipSimpleWrapper_Type)) == NULL)
+            return NULL;
+    }
+
+    Py_INCREF(default_simple_base);
+
+    return default_simple_base;
+}
+
+
+/*
+ * Return the dictionary of a type.
+ */
+static PyObject *getScopeDict(sipTypeDef *td, PyObject *mod_dict,
+        sipExportedModuleDef *client)
+{
+    /*
+     * Initialise the scoping type if necessary.  It will always be in the
+     * same module if it needs doing.
+     */
+    if (sipTypeIsMapped(td))
+    {
+        if (createMappedType(client, (sipMappedTypeDef *)td, mod_dict) < 0)
+            return NULL;
+
+        /* Check that the mapped type can act as a container. */
+        assert(sipTypeAsPyTypeObject(td) != NULL);
+    }
+    else
+    {
+        if (createClassType(client, (sipClassTypeDef *)td, mod_dict) < 0)
+            return NULL;
+    }
+
+    return (sipTypeAsPyTypeObject(td))->tp_dict;
+}
+
+
+/*
+ * Register a module that uses lazy types.  A negative value is returned and an
+ * exception raised if there was an error.
+ */
+static int registerLazyModule(sipExportedModuleDef *client,
+        PyObject *mod_dict)
+{
+    static PyMethodDef getattr_md = {
+        "__getattr__", lazy_module_getattr, METH_O, NULL
+    };
+    static PyMethodDef dir_md = {
+        "__dir__", lazy_module_dir, METH_NOARGS, NULL
+    };
+
+    sipLazyModule *lm;
+    PyObject *self, *type_names;
+    int rc;
+
+    if ((type_names = createLazyTypeNames(client)) == NULL)
+        return -1;
+
+    if ((lm = sip_api_malloc(sizeof (sipLazyModule))) == NULL)
+    {
+        Py_DECREF(type_names);
+        return -1;
+    }
+
+    Py_INCREF(mod_dict);
+
+    lm->em = client;
+    lm->mod_dict = mod_dict;
+    lm->type_names = type_names;
+    lm->next = lazyModules;
+
+    lazyModules = lm;
+
+    /*
+     * The module scoped types are created when they are first looked up using
+     * the module's __getattr__ (see PEP 562).  Any handwritten implementation
+     * is left alone.
+     */
+    if ((self = PyCapsule_New(lm, NULL, NULL)) == NULL)
+        return -1;
+
+    rc = 0;
+
+    if (PyDict_GetItemString(mod_dict, getattr_md.ml_name) == NULL)
+        rc = sip_dict_set_and_discard(mod_dict, getattr_md.ml_name,
+                PyCFunction_New(&getattr_md, self));
+
+    if (rc == 0 && PyDict_GetItemString(mod_dict, dir_md.ml_name) == NULL)
+        rc = sip_dict_set_and_discard(mod_dict, dir_md.ml_name,
+                PyCFunction_New(&dir_md, self));
+
+    Py_DECREF(self);
+
+    return rc;
+}
+
+
+/*
+ * Return the dictionary of a module that uses lazy types.
+ */
+static PyObject *getLazyModuleDict(const sipExportedModuleDef *em)
+{
+    sipLazyModule *lm;
+
+    for (lm = lazyModules; lm != NULL; lm = lm->next)
+        if (lm->em == em)
+            return lm->mod_dict;
+
+    /* This should never happen. */
+    return NULL;
+}
+
+
+/*
+ * Create the type object of a type whose module uses lazy types.  A negative
+ * value is returned and an exception raised if there was an error.
+ */
+static int createLazyType(sipTypeDef *td)
+{
+    sipExportedModuleDef *client = td->td_module;
+    PyObject *mod_dict = getLazyModuleDict(client);
+
+    if (sipTypeIsStub(td))
+        return 0;
+
+    if (sipTypeIsEnum(td))
+    {
+        sipEnumTypeDef *etd = (sipEnumTypeDef *)td;
+        sipIntInstanceDef *next_int;
+        int i;
+
+        /* A scoped enum is created with the other attributes of its scope. */
+        if (etd->etd_scope >= 0)
+            return sip_add_all_lazy_attrs(client->em_types[etd->etd_scope]);
+
+        /* The members follow those of any earlier module scoped enums. */
+        next_int = client->em_instances.id_int;
+
+        for (i = 0; client->em_types[i] != td; ++i)
+        {
+            sipTypeDef *enum_td = client->em_types[i];
+
+            if (enum_td != NULL && sipTypeIsEnum(enum_td) && ((sipEnumTypeDef *)enum_td)->etd_scope < 0)
+                next_int += ((sipEnumTypeDef *)enum_td)->etd_nr_members;
+        }
+
+        return sip_enum_create(client, etd, &next_int, mod_dict);
+    }
+
+    if (sipTypeIsMapped(td))
+    {
+        /* Only a mapped type with a name has a type object. */
+        if (((sipMappedTypeDef *)td)->mtd_container.cod_name < 0)
+            return 0;
+
+        return createMappedType(client, (sipMappedTypeDef *)td, mod_dict);
+    }
+
+    /* A namespace extender doesn't have a type object of its own. */
+    if (((sipClassTypeDef *)td)->ctd_container.cod_name < 0)
+        return 0;
+
+    return createClassType(client, (sipClassTypeDef *)td, mod_dict);
+}
+
+
+/*
+ * Create the type objects of any classes and mapped types nested in a type
+ * that haven't been created yet because their module uses lazy types.  This
+ * includes any defined by the extenders of a namespace.  A negative value is
+ * returned and an exception raised if there was an error.
+ */
+static int createNestedTypes(const sipTypeDef *td)
+{
+    sipExportedModuleDef *em = td->td_module;
+    sipClassTypeDef *nsx = NULL;
+
+    if (sipTypeIsNamespace(td))
+        nsx = ((sipClassTypeDef *)td)->ctd_nsextender;
+
+    for (;;)
+    {
+        if (sipModuleHasLazyTypes(em))
+        {
+            int i;
+
+            for (i = 0; i < em->em_nrtypes; ++i)
+            {
+                sipTypeDef *nested_td = em->em_types[i];
+
+                if (nested_td == NULL || nested_td->td_module != em || nested_td->td_py_type != NULL)
+                    continue;
+
+                if (sipTypeIsEnum(nested_td) || sipTypeIsStub(nested_td))
+                    continue;
+
+                if (sip_api_type_scope(nested_td) == td && createLazyType(nested_td) < 0)
+                    return -1;
+            }
+        }
+
+        if (nsx == NULL)
+            break;
+
+        em = nsx->ctd_base.td_module;
+        nsx = nsx->ctd_nsextender;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Return the name of a module scoped type of a module that uses lazy types or
+ * NULL if it isn't such a type.
+ */
+static const char *lazyModuleTypeName(sipExportedModuleDef *em,
+        sipTypeDef *td)
+{
+    sipContainerDef *cod;
+
+    if (td == NULL || td->td_module != em || sipTypeIsStub(td))
+        return NULL;
+
+    if (sipTypeIsEnum(td))
+    {
+        if (((sipEnumTypeDef *)td)->etd_scope >= 0)
+            return NULL;
+
+        return sipPyNameOfEnum((sipEnumTypeDef *)td);
+    }
+
+    if (sipTypeIsMapped(td))
+        cod = &((sipMappedTypeDef *)td)->mtd_container;
+    else
+        cod = &((sipClassTypeDef *)td)->ctd_container;
+
+    if (cod->cod_name < 0 || !cod->cod_scope.sc_flag)
+        return NULL;
+
+    return sipPyNameOfContainer(cod, td);
+}
+
+
+/*
+ * Return a new dictionary that maps the Python name of each module scoped type
+ * of a module that uses lazy types to the type's index in the module's table
+ * of types.  NULL is returned and an exception raised if there was an error.
  */
-static void removeFromParent(sipWrapper *self)
+static PyObject *createLazyTypeNames(sipExportedModuleDef *em)
 {
-    if (self->parent != NULL)
+    PyObject *type_names;
+    int i;
+
+    if ((type_names = PyDict_New()) == NULL)
+        return NULL;
+
+    for (i = 0; i < em->em_nrtypes; ++i)
     {
-        if (self->parent->first_child == self)
-            self->parent->first_child = self->sibling_next;
+        const char *name;
+        PyObject *name_obj, *index_obj;
+        int rc;
 
-        if (self->sibling_next != NULL)
-            self->sibling_next->sibling_prev = self->sibling_prev;
+        if ((name = lazyModuleTypeName(em, em->em_types[i])) == NULL)
+            continue;
 
-        if (self->sibling_prev != NULL)
-            self->sibling_prev->sibling_next = self->sibling_next;
+        if ((name_obj = PyUnicode_FromString(name)) == NULL)
+        {
+            Py_DECREF(type_names);
+            return NULL;
+        }
 
-        self->parent = NULL;
-        self->sibling_next = NULL;
-        self->sibling_prev = NULL;
+        if ((index_obj = PyLong_FromLong(i)) == NULL)
+        {
+            Py_DECREF(name_obj);
+            Py_DECREF(type_names);
+            return NULL;
+        }
 
-        /*
-         * We must do this last, after all the pointers are correct, because
-         * this is used by the clear slot.
-         */
-        Py_DECREF((sipSimpleWrapper *)self);
-    }
-}
+        /* The first type with a name takes precedence. */
+        rc = (PyDict_SetDefault(type_names, name_obj, index_obj) != NULL ? 0 : -1);
 
+        Py_DECREF(name_obj);
+        Py_DECREF(index_obj);
 
-/*
- * Detach and children of a parent.
- */
-static void detachChildren(sipWrapper *self)
-{
-    while (self->first_child != NULL)
-        removeFromParent(self->first_child);
+        if (rc < 0)
+        {
+            Py_DECREF(type_names);
+            return NULL;
+        }
+    }
+
+    return type_names;
 }
 
 
 /*
- * Convert a sequence index.  Return the index or a negative value if there was
- * an error.
+ * Return the module scoped type with a particular name whose type object
+ * hasn't been created yet or NULL if there is none.  NULL is also returned
+ * and an exception raised if there was an error.
  */
-static Py_ssize_t sip_api_convert_from_sequence_index(Py_ssize_t idx,
-        Py_ssize_t len)
+static sipTypeDef *findLazyModuleType(sipLazyModule *lm, PyObject *name)
 {
-    /* Negative indices start from the other end. */
-    if (idx < 0)
-        idx = len + idx;
+    PyObject *index_obj;
+    sipTypeDef *td;
 
-    if (idx < 0 || idx >= len)
-    {
-        PyErr_Format(PyExc_IndexError, "sequence index out of range");
-        return -1;
-    }
+    if ((index_obj = PyDict_GetItemWithError(lm->type_names, name)) == NULL)
+        return NULL;
 
-    return idx;
+    td = lm->em->em_types[PyLong_AsLong(index_obj)];
+
+    return (td->td_py_type == NULL ? td : NULL);
 }
 
 
 /*
- * Return a tuple of the base class of a type that has no explicit super-type.
+ * The module __getattr__ of a module that uses lazy types.
  */
-static PyObject *getDefaultBase(void)
+static PyObject *lazy_module_getattr(PyObject *self, PyObject *name)
 {
-    static PyObject *default_base = NULL;
+    sipLazyModule *lm = (sipLazyModule *)PyCapsule_GetPointer(self, NULL);
+    sipExportedModuleDef *em = lm->em;
+    sipTypeDef *td;
 
-    /* Only do this once. */
-    if (default_base == NULL)
+    if ((td = findLazyModuleType(lm, name)) != NULL)
     {
-        if ((default_base = PyTuple_Pack(1, (PyObject *)&sipWrapper_Type)) == NULL)
+        PyObject *attr;
+
+        if (createLazyType(td) < 0)
             return NULL;
+
+        if ((attr = PyDict_GetItemWithError(lm->mod_dict, name)) != NULL)
+        {
+            Py_INCREF(attr);
+            return attr;
+        }
     }
 
-    Py_INCREF(default_base);
+    if (PyErr_Occurred())
+        return NULL;
 
-    return default_base;
+    PyErr_Format(PyExc_AttributeError, "module '%s' has no attribute '%U'",
+            sipNameOfModule(em), name);
+
+    return NULL;
 }
 
 
 /*
- * Return a tuple of the base class of a simple type that has no explicit
- * super-type.
+ * The module __dir__ of a module that uses lazy types.
  */
-static PyObject *getDefaultSimpleBase(void)
+static PyObject *lazy_module_dir(PyObject *self, PyObject *args)
 {
-    static PyObject *default_simple_base = NULL;
+    sipLazyModule *lm = (sipLazyModule *)PyCapsule_GetPointer(self, NULL);
+    sipExportedModuleDef *em = lm->em;
+    PyObject *names;
+    int i;
 
-    /* Only do this once. */
-    if (default_simple_base == NULL)
+    (void)args;
+
+    if ((names = PyDict_Keys(lm->mod_dict)) == NULL)
+        return NULL;
+
+    /* Add the types that haven't been created yet. */
+    for (i = 0; i < em->em_nrtypes; ++i)
     {
-        if ((default_simple_base = PyTuple_Pack(1, (PyObject *)&sipSimpleWrapper_Type)) == NULL)
+        sipTypeDef *td = em->em_types[i];
+        const char *name;
+        PyObject *name_obj;
+        int rc;
+
+        if (td == NULL || td->td_py_type != NULL)
+            continue;
+
+        if ((name = lazyModuleTypeName(em, td)) == NULL)
+            continue;
+
+        if ((name_obj = PyUnicode_FromString(name)) == NULL)
+        {
+            Py_DECREF(names);
             return NULL;
-    }
+        }
 
-    Py_INCREF(default_simple_base);
+        rc = PyList_Append(names, name_obj);
+        Py_DECREF(name_obj);
 
-    return default_simple_base;
+        if (rc < 0)
+        {
+            Py_DECREF(names);
+            return NULL;
+        }
+    }
+
+    return names;
 }
 
 
 /*
- * Return the dictionary of a type.
+ * Return the Python type object of a type, creating it first if its module
+ * uses lazy types.  NULL is returned if the type doesn't have a type object
+ * and an exception raised if there was an error creating it.
  */
-static PyObject *getScopeDict(sipTypeDef *td, PyObject *mod_dict,
-        sipExportedModuleDef *client)
+PyTypeObject *sip_api_type_as_py_type_object(const sipTypeDef *td)
 {
-    /*
-     * Initialise the scoping type if necessary.  It will always be in the
-     * same module if it needs doing.
-     */
-    if (sipTypeIsMapped(td))
-    {
-        if (createMappedType(client, (sipMappedTypeDef *)td, mod_dict) < 0)
-            return NULL;
-
-        /* Check that the mapped type can act as a container. */
-        assert(sipTypeAsPyTypeObject(td) != NULL);
-    }
-    else
-    {
-        if (createClassType(client, (sipClassTypeDef *)td, mod_dict) < 0)
+    if (td->td_py_type == NULL && td->td_module != NULL && sipModuleHasLazyTypes(td->td_module))
+        if (createLazyType((sipTypeDef *)td) < 0)
             return NULL;
-    }
 
-    return (sipTypeAsPyTypeObject(td))->tp_dict;
+    return td->td_py_type;
 }
 
 
@@ -5639,10 +7540,19 @@ static int createClassType(sipExportedModuleDef *client, sipClassTypeDef *ctd,
 
     /* Handle the trivial case where we have already been initialised. */
     if (ctd->ctd_base.td_module != NULL)
-        return 0;
+    {
+        if (ctd->ctd_base.td_py_type != NULL || !sipModuleHasLazyTypes(ctd->ctd_base.td_module))
+            return 0;
 
-    /* Set this up now to gain access to the string pool. */
-    ctd->ctd_base.td_module = client;
+        /* A lazy type is created in the context of its own module. */
+        if (ctd->ctd_base.td_module != client)
+            return createLazyType(&ctd->ctd_base);
+    }
+    else
+    {
+        /* Set this up now to gain access to the string pool. */
+        ctd->ctd_base.td_module = client;
+    }
 
     /* Create the tuple of super-types. */
     if ((sup = ctd->ctd_supers) == NULL)
@@ -5743,6 +7653,37 @@ static int createClassType(sipExportedModuleDef *client, sipClassTypeDef *ctd,
     if (ctd->ctd_pyslots != NULL)
         fix_slots((PyTypeObject *)py_type, ctd->ctd_pyslots);
 
+    /* Create the data private to this module. */
+    if ((((sipWrapperType *)py_type)->wt_private = sip_api_malloc(sizeof (sipWrapperTypePrivate))) == NULL)
+        goto reltype;
+
+    /* Flatten the class hierarchy. */
+    if (set_ancestors(ctd, (sipWrapperType *)py_type) < 0)
+        goto reltype;
+
+    ((sipWrapperType *)py_type)->wt_private->wp_freelist = NULL;
+    ((sipWrapperType *)py_type)->wt_private->wp_nr_free = 0;
+    ((sipWrapperType *)py_type)->wt_private->wp_freelist_size = 0;
+
+#if !defined(Py_GIL_DISABLED) && !defined(Py_TRACE_REFS)
+    /* Allow released instances to be reused. */
+    if (!sipTypeIsNamespace(&ctd->ctd_base))
+    {
+        ((PyTypeObject *)py_type)->tp_alloc = wrapper_alloc;
+        ((PyTypeObject *)py_type)->tp_free = wrapper_free;
+    }
+#endif
+
+#if !defined(Py_GIL_DISABLED)
+    /*
+     * Make sure that the instance dictionary of an instance that isn't tracked
+     * by the garbage collector can't be created unnoticed.  A type that
+     * implements __setattr__ is always tracked.
+     */
+    if (sipTypeIsGCUntracked(&ctd->ctd_base) && ((PyTypeObject *)py_type)->tp_setattro == PyObject_GenericSetAttr)
+        ((PyTypeObject *)py_type)->tp_setattro = untracked_setattro;
+#endif
+
     /* Handle the pickle function. */
     if (ctd->ctd_pickle != NULL)
     {
@@ -5772,11 +7713,170 @@ relbases:
     Py_DECREF(bases);
 
 reterr:
-    ctd->ctd_base.td_module = NULL;
+    if (!sipModuleHasLazyTypes(client))
+        ctd->ctd_base.td_module = NULL;
+
     return -1;
 }
 
 
+/*
+ * Create the flattened table of the ancestors of a class.  The tables of any
+ * super-classes will already have been created.  A negative value is returned
+ * and an exception raised if there was an error.
+ */
+static int set_ancestors(const sipClassTypeDef *ctd, sipWrapperType *wt)
+{
+    const sipEncodedTypeDef *sup;
+    const sipAncestorDef *an;
+    sipAncestorDef *ancestors;
+    int nr_ancestors, max_ancestors, i;
+
+    /* Find the maximum number of ancestors, ignoring any duplicates. */
+    max_ancestors = 1;
+
+    if ((sup = ctd->ctd_supers) != NULL)
+    {
+        do
+        {
+            an = sipClassAncestors(sipGetGeneratedClassType(sup, ctd));
+
+            assert(an != NULL);
+
+            while (an++->an_ctd != NULL)
+                ++max_ancestors;
+        }
+        while (!sup++->sc_flag);
+    }
+
+    /* Allow for the sentinel. */
+    ancestors = sip_api_malloc((max_ancestors + 1) * sizeof (sipAncestorDef));
+    if (ancestors == NULL)
+        return -1;
+
+    ancestors[0].an_ctd = ctd;
+    ancestors[0].an_needs_cast = FALSE;
+    nr_ancestors = 1;
+
+    if ((sup = ctd->ctd_supers) != NULL)
+    {
+        int first = TRUE;
+
+        do
+        {
+            const sipClassTypeDef *sup_ctd = sipGetGeneratedClassType(sup,
+                    ctd);
+
+            for (an = sipClassAncestors(sup_ctd); an->an_ctd != NULL; ++an)
+            {
+                /*
+                 * The address of a super-class can only be different if it
+                 * isn't the first one.  Any other ancestor has the same
+                 * address as the super-class unless it needs a cast from the
+                 * super-class.
+                 */
+                int needs_cast = (an->an_ctd == sup_ctd ? !first : an->an_needs_cast);
+
+                for (i = 0; i < nr_ancestors; ++i)
+                    if (ancestors[i].an_ctd == an->an_ctd)
+                        break;
+
+                if (i < nr_ancestors)
+                {
+                    if (needs_cast)
+                        ancestors[i].an_needs_cast = TRUE;
+                }
+                else
+                {
+                    ancestors[nr_ancestors].an_ctd = an->an_ctd;
+                    ancestors[nr_ancestors].an_needs_cast = needs_cast;
+                    ++nr_ancestors;
+                }
+            }
+
+            first = FALSE;
+        }
+        while (!sup++->sc_flag);
+    }
+
+    ancestors[nr_ancestors].an_ctd = NULL;
+    ancestors[nr_ancestors].an_needs_cast = FALSE;
+
+    wt->wt_private->wp_ancestors = ancestors;
+
+    return 0;
+}
+
+
+#if !defined(Py_GIL_DISABLED) && !defined(Py_TRACE_REFS)
+/*
+ * The tp_alloc slot of a generated type.  A previously released instance is
+ * reused if there is one.
+ */
+static PyObject *wrapper_alloc(PyTypeObject *py_type, Py_ssize_t nitems)
+{
+    sipWrapperTypePrivate *wp = ((sipWrapperType *)py_type)->wt_private;
+    sipSimpleWrapper *sw;
+
+    if (wp == NULL || (sw = wp->wp_freelist) == NULL || nitems != 0)
+        return PyType_GenericAlloc(py_type, nitems);
+
+    wp->wp_freelist = sw->next;
+    --wp->wp_nr_free;
+
+    sipStatsInc(sipStatReusedWrappers);
+
+    /*
+     * This mimics PyType_GenericAlloc().  The instance was untracked when it
+     * was released.
+     */
+    memset(sw, 0, py_type->tp_basicsize);
+    PyObject_Init((PyObject *)sw, py_type);
+    PyObject_GC_Track(sw);
+
+    return (PyObject *)sw;
+}
+
+
+/*
+ * The tp_free slot of a generated type.  The instance is kept for later reuse
+ * if the type's freelist isn't full.
+ */
+static void wrapper_free(void *self)
+{
+    sipSimpleWrapper *sw = (sipSimpleWrapper *)self;
+    sipWrapperTypePrivate *wp = ((sipWrapperType *)Py_TYPE(sw))->wt_private;
+
+    if (wp == NULL || wp->wp_nr_free >= wp->wp_freelist_size)
+    {
+        PyObject_GC_Del(self);
+        return;
+    }
+
+    sw->next = wp->wp_freelist;
+    wp->wp_freelist = sw;
+    ++wp->wp_nr_free;
+}
+
+
+/*
+ * Release any instances of a type that the freelist no longer has room for.
+ */
+static void trim_freelist(sipWrapperTypePrivate *wp)
+{
+    while (wp->wp_nr_free > wp->wp_freelist_size)
+    {
+        sipSimpleWrapper *sw = wp->wp_freelist;
+
+        wp->wp_freelist = sw->next;
+        --wp->wp_nr_free;
+
+        PyObject_GC_Del(sw);
+    }
+}
+#endif
+
+
 /*
  * Create a single mapped type object.
  */
@@ -5787,10 +7887,19 @@ static int createMappedType(sipExportedModuleDef *client,
 
     /* Handle the trivial case where we have already been initialised. */
     if (mtd->mtd_base.td_module != NULL)
-        return 0;
+    {
+        if (mtd->mtd_base.td_py_type != NULL || !sipModuleHasLazyTypes(mtd->mtd_base.td_module))
+            return 0;
 
-    /* Set this up now to gain access to the string pool. */
-    mtd->mtd_base.td_module = client;
+        /* A lazy type is created in the context of its own module. */
+        if (mtd->mtd_base.td_module != client)
+            return createLazyType(&mtd->mtd_base);
+    }
+    else
+    {
+        /* Set this up now to gain access to the string pool. */
+        mtd->mtd_base.td_module = client;
+    }
 
     /* Create the tuple of super-types. */
     if ((bases = getDefaultBase()) == NULL)
@@ -5818,7 +7927,9 @@ relbases:
     Py_DECREF(bases);
 
 reterr:
-    mtd->mtd_base.td_module = NULL;
+    if (!sipModuleHasLazyTypes(client))
+        mtd->mtd_base.td_module = NULL;
+
     return -1;
 }
 
@@ -5880,7 +7991,14 @@ static PyObject *unpickle_type(PyObject *obj, PyObject *args)
                     &((sipClassTypeDef *)td)->ctd_container, td);
 
             if (strcmp(pyname, tname) == 0)
-                return PyObject_CallObject((PyObject *)sipTypeAsPyTypeObject(td), init_args);
+            {
+                PyTypeObject *py_type = sipTypeAsPyTypeObject(td);
+
+                if (py_type == NULL)
+                    return NULL;
+
+                return PyObject_CallObject((PyObject *)py_type, init_args);
+            }
         }
     }
 
@@ -5909,7 +8027,7 @@ static PyObject *pickle_type(PyObject *obj, PyObject *args)
             sipTypeDef *td = em->em_types[i];
 
             if (td != NULL && !sipTypeIsStub(td) && sipTypeIsClass(td))
-                if (sipTypeAsPyTypeObject(td) == Py_TYPE(obj))
+                if (td->td_py_type == Py_TYPE(obj))
                 {
                     PyObject *init_args;
                     sipClassTypeDef *ctd = (sipClassTypeDef *)td;
@@ -6055,19 +8173,19 @@ static int addInstances(PyObject *dict, sipInstancesDef *id)
  * Get "self" from the argument tuple for a method called as
  * Class.Method(self, ...) rather than self.Method(...).
  */
-static int getSelfFromArgs(sipTypeDef *td, PyObject *args, int argnr,
+static int getSelfFromArgs(sipTypeDef *td, const sipArgsView *av, int argnr,
         PyObject **selfp)
 {
     PyObject *self;
 
-    /* Get self from the argument tuple. */
+    /* Get self from the positional arguments. */
 
-    if (argnr >= PyTuple_GET_SIZE(args))
+    if (argnr >= av->nr_pos_args)
         return FALSE;
 
-    self = PyTuple_GET_ITEM(args, argnr);
+    self = av->args[argnr];
 
-    if (!PyObject_TypeCheck(self, sipTypeAsPyTypeObject(td)))
+    if (!sipTypeCheck(self, td))
         return FALSE;
 
     *selfp = self;
@@ -6251,6 +8369,9 @@ static int add_lazy_attrs(const sipTypeDef *td)
     PyObject *dict;
     sipAttrGetter *ag;
 
+    if (wt == NULL)
+        return -1;
+
     /* Handle the trivial case. */
     if (wt->wt_dict_complete)
         return 0;
@@ -6272,6 +8393,10 @@ static int add_lazy_attrs(const sipTypeDef *td)
                 return -1;
     }
 
+    /* Create any nested types that haven't been created yet. */
+    if (createNestedTypes(td) < 0)
+        return -1;
+
     /*
      * Get any lazy attributes from registered getters.  This must be done last
      * to allow any existing attributes to be replaced.
@@ -6373,12 +8498,16 @@ const sipTypeDef *sip_api_type_scope(const sipTypeDef *td)
 static int sip_api_register_attribute_getter(const sipTypeDef *td,
         sipAttrGetterFunc getter)
 {
-    sipAttrGetter *ag = sip_api_malloc(sizeof (sipAttrGetter));
+    PyTypeObject *py_type = sipTypeAsPyTypeObject(td);
+    sipAttrGetter *ag;
+
+    if (py_type == NULL)
+        return -1;
 
-    if (ag == NULL)
+    if ((ag = sip_api_malloc(sizeof (sipAttrGetter))) == NULL)
         return -1;
 
-    ag->type = sipTypeAsPyTypeObject(td);
+    ag->type = py_type;
     ag->getter = getter;
     ag->next = sipAttrGetters;
 
@@ -6541,6 +8670,16 @@ static void sip_api_no_method(PyObject *parseErr, const char *scope,
             Py_DECREF(exc);
         }
     }
+    else if (parseErr == unrecorded_failures)
+    {
+        /*
+         * The failures should have been diagnosed by the caller so this is
+         * the best we can do.
+         */
+        PyErr_Format(PyExc_TypeError,
+                "%s%s%s(): arguments did not match any overloaded call", scope,
+                sep, method);
+    }
     else
     {
         /*
@@ -6839,6 +8978,13 @@ static void sip_api_transfer_to(PyObject *self, PyObject *owner)
     {
         sipSimpleWrapper *sw = (sipSimpleWrapper *)self;
 
+        /* C/C++ may now refer to a value so make sure it can be found. */
+        if (sipIsUnmapped(sw))
+        {
+            sipResetUnmapped(sw);
+            sipOMAddObject(&cppPyMap, sw);
+        }
+
         if (owner == NULL)
         {
             /* There is no owner. */
@@ -7288,6 +9434,10 @@ static int addSingleTypeInstance(PyObject *dict, const char *name,
 static int sip_api_add_type_instance(PyObject *dict, const char *name,
         void *cppPtr, const sipTypeDef *td)
 {
+    /* This allows for the failure to create a lazy type that is the scope. */
+    if (dict == NULL)
+        return -1;
+
     return addSingleTypeInstance(getDictFromObject(dict), name, cppPtr, td, 0);
 }
 
@@ -7325,8 +9475,7 @@ static PyObject *sip_api_is_py_method_12_8(sip_gilstate_t *gil, char *pymc,
         sipSimpleWrapper **sipSelfp, const char *cname, const char *mname)
 {
     sipSimpleWrapper *sipSelf;
-    PyObject *mname_obj, *reimp, *mro, *cls;
-    Py_ssize_t i;
+    PyObject *mname_obj, *reimp, *cls;
 
     /*
      * This is the most common case (where there is no Python reimplementation)
@@ -7365,61 +9514,24 @@ static PyObject *sip_api_is_py_method_12_8(sip_gilstate_t *gil, char *pymc,
      * reference to it is the single instance of the type which is in the
      * process of being garbage collected.
      */
-    cls = (PyObject *)Py_TYPE(sipSelf);
-    mro = ((PyTypeObject *)cls)->tp_mro;
-
-    if (mro == NULL)
+    if (Py_TYPE(sipSelf)->tp_mro == NULL)
         goto release_gil;
 
     /* Get any reimplementation. */
-
-    if ((mname_obj = PyUnicode_FromString(mname)) == NULL)
-        goto release_gil;
-
-    /*
-     * We don't use PyObject_GetAttr() because that might find the generated
-     * C function before a reimplementation defined in a mixin (ie. later in
-     * the MRO).  However that means we must explicitly check that the class
-     * hierarchy is fully initialised.
-     */
-    if (sip_add_all_lazy_attrs(((sipWrapperType *)Py_TYPE(sipSelf))->wt_td) < 0)
-    {
-        Py_DECREF(mname_obj);
+    if (find_reimplementation(Py_TYPE(sipSelf), mname, &mname_obj, &reimp, &cls) < 0)
         goto release_gil;
-    }
 
     if (sipSelf->dict != NULL)
     {
         /* Check the instance dictionary in case it has been monkey patched. */
-        if ((reimp = PyDict_GetItem(sipSelf->dict, mname_obj)) != NULL && PyCallable_Check(reimp))
+        PyObject *inst_attr;
+
+        if ((inst_attr = PyDict_GetItem(sipSelf->dict, mname_obj)) != NULL && PyCallable_Check(inst_attr))
         {
             Py_DECREF(mname_obj);
 
-            Py_INCREF(reimp);
-            return reimp;
-        }
-    }
-
-    assert(PyTuple_Check(mro));
-
-    reimp = NULL;
-
-    for (i = 0; i < PyTuple_GET_SIZE(mro); ++i)
-    {
-        PyObject *cls_dict, *cls_attr;
-
-        cls = PyTuple_GET_ITEM(mro, i);
-
-        cls_dict = ((PyTypeObject *)cls)->tp_dict;
-
-        /*
-         * Check any possible reimplementation is not the wrapped C++ method or
-         * a default special method implementation.
-         */
-        if (cls_dict != NULL && (cls_attr = PyDict_GetItem(cls_dict, mname_obj)) != NULL && Py_TYPE(cls_attr) != &sipMethodDescr_Type && Py_TYPE(cls_attr) != &PyWrapperDescr_Type)
-        {
-            reimp = cls_attr;
-            break;
+            Py_INCREF(inst_attr);
+            return inst_attr;
         }
     }
 
@@ -7488,12 +9600,142 @@ release_gil:
 }
 
 
+/*
+ * Find any Python reimplementation of a C/C++ virtual in a Python type.  The
+ * results are cached for each type until the type (or one of its super-types)
+ * is modified.  A new reference to the interned name of the virtual is
+ * returned along with borrowed references to any reimplementation and the
+ * type that defines it.  Return -1 if there was an error.
+ */
+static int find_reimplementation(PyTypeObject *py_type, const char *mname,
+        PyObject **mname_objp, PyObject **reimpp, PyObject **clsp)
+{
+    PyObject *mname_obj, *mro, *reimp, *cls;
+    Py_ssize_t i;
+#if !defined(Py_GIL_DISABLED)
+    unsigned int version = get_type_version(py_type);
+    sipReimpCacheEntry *rce;
+
+    /* The name is generated and so its address is enough to identify it. */
+    rce = &reimp_cache[(((uintptr_t)py_type >> 4) ^ (uintptr_t)mname) % REIMP_CACHE_SIZE];
+
+    if (version != 0 && rce->version == version && rce->py_type == py_type && rce->mname == mname)
+    {
+        Py_INCREF(rce->mname_obj);
+        *mname_objp = rce->mname_obj;
+        *reimpp = rce->reimp;
+        *clsp = rce->cls;
+
+        sipStatsInc(sipStatVirtualCacheHits);
+
+        return 0;
+    }
+#endif
+
+    sipStatsInc(sipStatVirtualMROWalks);
+
+    if ((mname_obj = PyUnicode_InternFromString(mname)) == NULL)
+        return -1;
+
+    /*
+     * We don't use PyObject_GetAttr() because that might find the generated
+     * C function before a reimplementation defined in a mixin (ie. later in
+     * the MRO).  However that means we must explicitly check that the class
+     * hierarchy is fully initialised.
+     */
+    if (sip_add_all_lazy_attrs(((sipWrapperType *)py_type)->wt_td) < 0)
+    {
+        Py_DECREF(mname_obj);
+        return -1;
+    }
+
+    mro = py_type->tp_mro;
+    assert(PyTuple_Check(mro));
+
+    reimp = cls = NULL;
+
+    for (i = 0; i < PyTuple_GET_SIZE(mro); ++i)
+    {
+        PyObject *cls_dict, *cls_attr;
+
+        cls = PyTuple_GET_ITEM(mro, i);
+
+        cls_dict = ((PyTypeObject *)cls)->tp_dict;
+
+        /*
+         * Check any possible reimplementation is not the wrapped C++ method or
+         * a default special method implementation.
+         */
+        if (cls_dict != NULL && (cls_attr = PyDict_GetItem(cls_dict, mname_obj)) != NULL && Py_TYPE(cls_attr) != &sipMethodDescr_Type && Py_TYPE(cls_attr) != &PyWrapperDescr_Type)
+        {
+            reimp = cls_attr;
+            break;
+        }
+    }
+
+#if !defined(Py_GIL_DISABLED)
+    /*
+     * Cache the result if the type has a version tag.  Adding the lazy
+     * attributes may have changed it.
+     */
+    if ((version = get_type_version(py_type)) != 0)
+    {
+        Py_XDECREF(rce->mname_obj);
+
+        Py_INCREF(mname_obj);
+        rce->mname_obj = mname_obj;
+        rce->py_type = py_type;
+        rce->mname = mname;
+        rce->version = version;
+        rce->reimp = reimp;
+        rce->cls = cls;
+    }
+#endif
+
+    *mname_objp = mname_obj;
+    *reimpp = reimp;
+    *clsp = cls;
+
+    return 0;
+}
+
+
+#if !defined(Py_GIL_DISABLED)
+/*
+ * Return the version tag of a Python type or 0 if it doesn't have a valid one.
+ * A type's version tag is changed whenever it, or one of its super-types, is
+ * modified.
+ */
+static unsigned int get_type_version(PyTypeObject *py_type)
+{
+#if PY_VERSION_HEX >= 0x030c0000
+    if (!PyUnstable_Type_AssignVersionTag(py_type))
+        return 0;
+#else
+    if (!PyType_HasFeature(py_type, Py_TPFLAGS_VALID_VERSION_TAG))
+        return 0;
+#endif
+
+    return py_type->tp_version_tag;
+}
+#endif
+
+
 /*
  * Convert a C/C++ pointer to the object that wraps it.
  */
 static PyObject *sip_api_get_pyobject(void *cppPtr, const sipTypeDef *td)
 {
-    return (PyObject *)sipOMFindObject(&cppPyMap, cppPtr, td);
+    PyObject *py = (PyObject *)sipOMFindObject(&cppPyMap, cppPtr, td);
+
+    /*
+     * This is part of the public API and returns a borrowed reference.
+     * Callers that need a reference that is safe without a GIL should use
+     * sipConvertFromType() instead.
+     */
+    Py_XDECREF(py);
+
+    return py;
 }
 
 
@@ -7583,12 +9825,14 @@ void *sip_api_get_cpp_ptr(sipSimpleWrapper *sw, const sipTypeDef *td)
 {
     void *ptr = sip_api_get_address(sw);
 
+    sipStatsInc(sipStatUnwraps);
+
     if (checkPointer(ptr, sw) < 0)
         return NULL;
 
     if (td != NULL)
     {
-        if (PyObject_TypeCheck((PyObject *)sw, sipTypeAsPyTypeObject(td)))
+        if (sipTypeCheck((PyObject *)sw, td))
             ptr = cast_cpp_ptr(ptr, Py_TYPE(sw), td);
         else
             ptr = NULL;
@@ -7637,12 +9881,163 @@ static int checkPointer(void *ptr, sipSimpleWrapper *sw)
 }
 
 
+/*
+ * A reference kept for a wrapper.
+ */
+typedef struct {
+    int key;
+    PyObject *obj;
+} sipKeptReference;
+
+
+/*
+ * The extra references kept for a wrapper.  A wrapper normally only has a
+ * handful of keys so a small vector, searched linearly, is much more compact
+ * than a dictionary and avoids creating an integer object for each key.  The
+ * size of the object is the number of references it has room for.
+ */
+typedef struct {
+    PyObject_VAR_HEAD
+
+    /* The number of references. */
+    Py_ssize_t nr_refs;
+
+    /* The references. */
+    sipKeptReference refs[1];
+} sipKeptReferences;
+
+#define KEPT_REFERENCES_INITIAL_SIZE    2
+
+
+/*
+ * The kept references of a wrapper are held in its reserved member so that
+ * the extra_refs dict is left for any handwritten code that uses it.
+ */
+#define kept_references(sw)     ((sipKeptReferences *)(sw)->reserved)
+
+
+/*
+ * When there is no GIL the kept references are protected by the wrapper's
+ * critical section.
+ */
+#if defined(Py_GIL_DISABLED)
+#define begin_kept_references(sw)   Py_BEGIN_CRITICAL_SECTION(sw)
+#define end_kept_references()       Py_END_CRITICAL_SECTION()
+#else
+#define begin_kept_references(sw)
+#define end_kept_references()
+#endif
+
+
+/*
+ * The kept references traverse slot.
+ */
+static int sipKeptReferences_traverse(sipKeptReferences *self, visitproc visit,
+        void *arg)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < self->nr_refs; ++i)
+        Py_VISIT(self->refs[i].obj);
+
+    return 0;
+}
+
+
+/*
+ * The kept references clear slot.
+ */
+static int sipKeptReferences_clear(sipKeptReferences *self)
+{
+    /* Allow for the objects being destroyed re-entering. */
+    while (self->nr_refs > 0)
+    {
+        PyObject *obj = self->refs[--self->nr_refs].obj;
+
+        Py_DECREF(obj);
+    }
+
+    return 0;
+}
+
+
+/*
+ * The kept references dealloc slot.
+ */
+static void sipKeptReferences_dealloc(sipKeptReferences *self)
+{
+    PyObject_GC_UnTrack((PyObject *)self);
+    sipKeptReferences_clear(self);
+    PyObject_GC_Del(self);
+}
+
+
+/*
+ * The type of the extra references kept for a wrapper.  It is not exposed to
+ * Python.
+ */
+static PyTypeObject sipKeptReferences_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    _SIP_MODULE_FQ_NAME "._keptreferences", /* tp_name */
+    sizeof (sipKeptReferences) - sizeof (sipKeptReference), /* tp_basicsize */
+    sizeof (sipKeptReference),  /* tp_itemsize */
+    (destructor)sipKeptReferences_dealloc,  /* tp_dealloc */
+    0,                      /* tp_print */
+    0,                      /* tp_getattr */
+    0,                      /* tp_setattr */
+    0,                      /* tp_reserved */
+    0,                      /* tp_repr */
+    0,                      /* tp_as_number */
+    0,                      /* tp_as_sequence */
+    0,                      /* tp_as_mapping */
+    0,                      /* tp_hash */
+    0,                      /* tp_call */
+    0,                      /* tp_str */
+    0,                      /* tp_getattro */
+    0,                      /* tp_setattro */
+    0,                      /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,    /* tp_flags */
+    0,                      /* tp_doc */
+    (traverseproc)sipKeptReferences_traverse,   /* tp_traverse */
+    (inquiry)sipKeptReferences_clear,   /* tp_clear */
+    0,                      /* tp_richcompare */
+    0,                      /* tp_weaklistoffset */
+    0,                      /* tp_iter */
+    0,                      /* tp_iternext */
+    0,                      /* tp_methods */
+    0,                      /* tp_members */
+    0,                      /* tp_getset */
+    0,                      /* tp_base */
+    0,                      /* tp_dict */
+    0,                      /* tp_descr_get */
+    0,                      /* tp_descr_set */
+    0,                      /* tp_dictoffset */
+    0,                      /* tp_init */
+    0,                      /* tp_alloc */
+    0,                      /* tp_new */
+    0,                      /* tp_free */
+    0,                      /* tp_is_gc */
+    0,                      /* tp_bases */
+    0,                      /* tp_mro */
+    0,                      /* tp_cache */
+    0,                      /* tp_subclasses */
+    0,                      /* tp_weaklist */
+    0,                      /* tp_del */
+    0,                      /* tp_version_tag */
+    0,                      /* tp_finalize */
+    0,                      /* tp_vectorcall */
+};
+
+
 /*
  * Keep an extra reference to an object.
  */
 static void sip_api_keep_reference(PyObject *self, int key, PyObject *obj)
 {
-    PyObject *dict, *key_obj;
+    sipSimpleWrapper *sw = (sipSimpleWrapper *)self;
+    sipKeptReferences *kr;
+    PyObject *old = NULL;
+    Py_ssize_t i;
 
     /*
      * If there isn't a "self" to keep the extra reference for later garbage
@@ -7654,24 +10049,84 @@ static void sip_api_keep_reference(PyObject *self, int key, PyObject *obj)
         return;
     }
 
-    /* Create the extra references dictionary if needed. */
-    if ((dict = ((sipSimpleWrapper *)self)->extra_refs) == NULL)
+    /* This can happen if the argument was optional. */
+    if (obj == NULL)
+        obj = Py_None;
+
+    Py_INCREF(obj);
+
+    begin_kept_references(sw);
+
+    kr = kept_references(sw);
+
+    /* See if the key is already being used. */
+    if (kr != NULL)
     {
-        if ((dict = PyDict_New()) == NULL)
-            return;
+        for (i = 0; i < kr->nr_refs; ++i)
+        {
+            if (kr->refs[i].key == key)
+            {
+                old = kr->refs[i].obj;
+                kr->refs[i].obj = obj;
+                obj = NULL;
 
-        ((sipSimpleWrapper *)self)->extra_refs = dict;
+                break;
+            }
+        }
     }
 
-    if ((key_obj = PyLong_FromLong(key)) != NULL)
+    if (obj != NULL)
     {
-        /* This can happen if the argument was optional. */
-        if (obj == NULL)
-            obj = Py_None;
+        /* Make room for the reference if needed. */
+        if (kr == NULL || kr->nr_refs == Py_SIZE(kr))
+        {
+            sipKeptReferences *new_kr;
+
+            new_kr = PyObject_GC_NewVar(sipKeptReferences,
+                    &sipKeptReferences_Type,
+                    (kr != NULL ? Py_SIZE(kr) * 2 : KEPT_REFERENCES_INITIAL_SIZE));
+
+            if (new_kr != NULL)
+            {
+                new_kr->nr_refs = 0;
 
-        PyDict_SetItem(dict, key_obj, obj);
-        Py_DECREF(key_obj);
+                /* Move any existing references. */
+                if (kr != NULL)
+                {
+                    memcpy(new_kr->refs, kr->refs,
+                            kr->nr_refs * sizeof (sipKeptReference));
+                    new_kr->nr_refs = kr->nr_refs;
+                    kr->nr_refs = 0;
+                }
+
+                PyObject_GC_Track((PyObject *)new_kr);
+
+                sipStatsInc(sipStatAllocKeptReferences);
+
+                old = (PyObject *)kr;
+                sw->reserved = new_kr;
+                track(sw);
+            }
+
+            kr = new_kr;
+        }
+
+        if (kr != NULL)
+        {
+            kr->refs[kr->nr_refs].key = key;
+            kr->refs[kr->nr_refs].obj = obj;
+            ++kr->nr_refs;
+        }
+        else
+        {
+            old = obj;
+        }
     }
+
+    end_kept_references();
+
+    /* Do this last in case it re-enters. */
+    Py_XDECREF(old);
 }
 
 
@@ -7680,18 +10135,43 @@ static void sip_api_keep_reference(PyObject *self, int key, PyObject *obj)
  */
 static PyObject *sip_api_get_reference(PyObject *self, int key)
 {
-    PyObject *dict, *key_obj, *obj;
+    sipSimpleWrapper *sw = (sipSimpleWrapper *)self;
+    sipKeptReferences *kr;
+    PyObject *obj = NULL;
 
-    /* Get the extra references dictionary if there is one. */
-    if ((dict = ((sipSimpleWrapper *)self)->extra_refs) == NULL)
-        return NULL;
+    begin_kept_references(sw);
 
-    if ((key_obj = PyLong_FromLong(key)) == NULL)
-        return NULL;
+    if ((kr = kept_references(sw)) != NULL)
+    {
+        Py_ssize_t i;
+
+        for (i = 0; i < kr->nr_refs; ++i)
+        {
+            if (kr->refs[i].key == key)
+            {
+                obj = kr->refs[i].obj;
+                Py_INCREF(obj);
+
+                break;
+            }
+        }
+    }
+
+    end_kept_references();
+
+    /* Handwritten code may have stored the reference in the dict. */
+    if (obj == NULL && sw->extra_refs != NULL)
+    {
+        PyObject *key_obj;
+
+        if ((key_obj = PyLong_FromLong(key)) != NULL)
+        {
+            obj = PyDict_GetItem(sw->extra_refs, key_obj);
+            Py_XINCREF(obj);
 
-    obj = PyDict_GetItem(dict, key_obj);
-    Py_DECREF(key_obj);
-    Py_XINCREF(obj);
+            Py_DECREF(key_obj);
+        }
+    }
 
     return obj;
 }
@@ -7738,6 +10218,9 @@ static PyObject *sip_api_get_user_object(const sipSimpleWrapper *sw)
 static void sip_api_set_user_object(sipSimpleWrapper *sw, PyObject *user)
 {
     sw->user = user;
+
+    if (user != NULL)
+        track(sw);
 }
 
 
@@ -7776,7 +10259,7 @@ static int sip_api_can_convert_to_type(PyObject *pyObj, const sipTypeDef *td,
             cto = ((const sipClassTypeDef *)td)->ctd_cto;
 
             if (cto == NULL || (flags & SIP_NO_CONVERTORS) != 0)
-                ok = PyObject_TypeCheck(pyObj, sipTypeAsPyTypeObject(td));
+                ok = sipTypeCheck(pyObj, td);
             else
                 ok = cto(pyObj, NULL, NULL, NULL, NULL);
         }
@@ -8005,26 +10488,32 @@ PyObject *sip_api_convert_from_type(void *cpp, const sipTypeDef *td,
      * expensive so we check the cache first, even though the sub-class code
      * might perform a down-cast.
      */
-    if ((py = sip_api_get_pyobject(cpp, td)) == NULL && sipTypeHasSCC(td))
+    py = (PyObject *)sipOMFindObject(&cppPyMap, cpp, td);
+
+    if (py == NULL && sipTypeHasSCC(td))
     {
         void *orig_cpp = cpp;
         const sipTypeDef *orig_td = td;
 
         /* Apply the sub-class convertor. */
-        td = convertSubClass(td, &cpp);
+        if ((td = convertSubClass(td, &cpp)) == NULL)
+            return NULL;
 
         /*
          * If the sub-class convertor has done something then check the cache
          * again using the modified values.
          */
         if (cpp != orig_cpp || td != orig_td)
-            py = sip_api_get_pyobject(cpp, td);
+            py = (PyObject *)sipOMFindObject(&cppPyMap, cpp, td);
     }
 
-    if (py != NULL)
-        Py_INCREF(py);
-    else if ((py = wrap_simple_instance(cpp, td, NULL, SIP_SHARE_MAP)) == NULL)
-        return NULL;
+    if (py == NULL)
+    {
+        py = wrap_simple_instance(cpp, td, NULL, SIP_SHARE_MAP);
+
+        if (py == NULL)
+            return NULL;
+    }
 
     /* Handle any ownership transfer. */
     if (transferObj != NULL)
@@ -8086,7 +10575,8 @@ static PyObject *sip_api_convert_from_new_type(void *cpp, const sipTypeDef *td,
 
     /* Apply any sub-class convertor. */
     if (sipTypeHasSCC(td))
-        td = convertSubClass(td, &cpp);
+        if ((td = convertSubClass(td, &cpp)) == NULL)
+            return NULL;
 
     /* Handle any ownership transfer. */
     if (transferObj == NULL || transferObj == Py_None)
@@ -8110,72 +10600,216 @@ int sip_api_get_state(PyObject *transferObj)
 
 
 /*
- * This is set by sip_api_find_type() before calling bsearch() on the types
- * table for the module.  This is a hack that works around the problem of
- * unresolved externally defined types.
+ * An entry in the index of the names of all the types of all the registered
+ * modules.  The entry refers to the type's slot in its module's types table so
+ * that an externally defined type is found once it has been resolved.
+ */
+typedef struct {
+    size_t hash;            /* The hash of the name ignoring spaces. */
+    const char *name;       /* The name of the type. */
+    sipTypeDef **tdp;       /* The slot in the module's types table. */
+} sipTypeIndexEntry;
+
+#define TYPE_INDEX_INITIAL_SIZE     256
+
+static sipTypeIndexEntry *type_index = NULL;
+static size_t type_index_size = 0;
+static size_t type_index_used = 0;
+
+/*
+ * When there is no GIL the index has its own lock.
  */
-static sipExportedModuleDef *module_searched;
+#if defined(Py_GIL_DISABLED)
+static PyMutex type_index_mutex;
+#define lock_type_index()   PyMutex_Lock(&type_index_mutex)
+#define unlock_type_index() PyMutex_Unlock(&type_index_mutex)
+#else
+#define lock_type_index()
+#define unlock_type_index()
+#endif
 
 
 /*
- * The bsearch() helper function for searching the types table.
+ * Return the hash of the first len characters of a type name.  Spaces are
+ * ignored so that we don't impose a rigorous naming standard.  This only
+ * really affects template-based mapped types.
  */
-static int compareTypeDef(const void *key, const void *el)
+static size_t hash_type_name(const char *name, size_t len)
 {
-    const char *s1 = (const char *)key;
-    const char *s2 = NULL;
-    const sipTypeDef *td;
-    char ch1, ch2;
+    /* This is FNV-1a. */
+    size_t hash = (size_t)2166136261U;
 
-    /* Allow for unresolved externally defined types. */
-    td = *(const sipTypeDef **)el;
+    while (len-- > 0)
+    {
+        char ch = *name++;
 
-    if (td != NULL)
+        if (ch != ' ')
+        {
+            hash ^= (unsigned char)ch;
+            hash *= 16777619U;
+        }
+    }
+
+    return hash;
+}
+
+
+/*
+ * Return TRUE if the first len characters of a type name match a name in the
+ * index while ignoring spaces.
+ */
+static int type_name_matches(const char *s1, size_t len, const char *s2)
+{
+    const char *end = s1 + len;
+
+    for (;;)
     {
-        s2 = sipTypeName(td);
+        while (s1 < end && *s1 == ' ')
+            ++s1;
+
+        while (*s2 == ' ')
+            ++s2;
+
+        if (s1 == end)
+            return (*s2 == '\0');
+
+        if (*s1++ != *s2++)
+            return FALSE;
     }
-    else
+}
+
+
+/*
+ * Return the index entry for the first len characters of a type name.  The
+ * entry is empty if the name isn't in the index.
+ */
+static sipTypeIndexEntry *find_type_index_entry(sipTypeIndexEntry *index,
+        size_t size, const char *name, size_t len, size_t hash)
+{
+    size_t mask = size - 1;
+    size_t i = hash & mask;
+
+    while (index[i].name != NULL)
+    {
+        sipTypeIndexEntry *tie = &index[i];
+
+        if (tie->hash == hash && type_name_matches(name, len, tie->name))
+            break;
+
+        i = (i + 1) & mask;
+    }
+
+    return &index[i];
+}
+
+
+/*
+ * Add the types of a newly registered module to the index.  A type in the new
+ * module replaces any type of the same name in an earlier module.  A negative
+ * value is returned and an exception raised if there was an error.
+ */
+static int add_types_to_index(sipExportedModuleDef *em)
+{
+    int i;
+
+    lock_type_index();
+
+    /* Make sure the load factor will be no more than 0.5. */
+    if ((type_index_used + em->em_nrtypes) * 2 > type_index_size)
     {
-        sipExternalTypeDef *etd = module_searched->em_external;
+        sipTypeIndexEntry *new_index;
+        size_t new_size, n;
 
-        assert(etd != NULL);
+        new_size = (type_index_size != 0) ? type_index_size : TYPE_INDEX_INITIAL_SIZE;
 
-        /* Find which external type it is. */
-        while (etd->et_nr >= 0)
+        while ((type_index_used + em->em_nrtypes) * 2 > new_size)
+            new_size <<= 1;
+
+        if ((new_index = sip_api_malloc(new_size * sizeof (sipTypeIndexEntry))) == NULL)
         {
-            const void *tdp = &module_searched->em_types[etd->et_nr];
+            unlock_type_index();
+            return -1;
+        }
 
-            if (tdp == el)
-            {
-                s2 = etd->et_name;
-                break;
-            }
+        memset(new_index, 0, new_size * sizeof (sipTypeIndexEntry));
+
+        for (n = 0; n < type_index_size; ++n)
+        {
+            sipTypeIndexEntry *tie = &type_index[n];
 
-            ++etd;
+            if (tie->name != NULL)
+                *find_type_index_entry(new_index, new_size, tie->name,
+                        strlen(tie->name), tie->hash) = *tie;
         }
 
-        assert(s2 != NULL);
+        sip_api_free(type_index);
+        type_index = new_index;
+        type_index_size = new_size;
     }
 
-    /*
-     * Compare while ignoring spaces so that we don't impose a rigorous naming
-     * standard.  This only really affects template-based mapped types.
-     */
-    do
+    for (i = 0; i < em->em_nrtypes; ++i)
     {
-        while ((ch1 = *s1++) == ' ')
-            ;
+        sipTypeDef *td = em->em_types[i];
+        sipTypeIndexEntry *tie;
+        const char *name = NULL;
+        size_t len;
 
-        while ((ch2 = *s2++) == ' ')
-            ;
+        if (td != NULL)
+        {
+            /* The type won't have its module set yet. */
+            name = sipNameFromPool(em, td->td_cname);
+        }
+        else
+        {
+            sipExternalTypeDef *etd;
 
-        /* We might be looking for a pointer or a reference. */
-        if ((ch1 == '*' || ch1 == '&' || ch1 == '\0') && ch2 == '\0')
-            return 0;
+            /* Find which external type it is. */
+            for (etd = em->em_external; etd->et_nr >= 0; ++etd)
+            {
+                if (etd->et_nr == i)
+                {
+                    name = etd->et_name;
+                    break;
+                }
+            }
+
+            assert(name != NULL);
+        }
+
+        len = strlen(name);
+
+        tie = find_type_index_entry(type_index, type_index_size, name, len,
+                hash_type_name(name, len));
+
+        if (tie->name == NULL)
+        {
+            tie->hash = hash_type_name(name, len);
+            ++type_index_used;
+        }
+
+        tie->name = name;
+        tie->tdp = &em->em_types[i];
     }
-    while (ch1 == ch2);
 
-    return (ch1 < ch2 ? -1 : 1);
+    unlock_type_index();
+
+    return 0;
+}
+
+
+/*
+ * Remove all types from the index.
+ */
+static void clear_type_index(void)
+{
+    lock_type_index();
+
+    sip_api_free(type_index);
+    type_index = NULL;
+    type_index_size = 0;
+    type_index_used = 0;
+
+    unlock_type_index();
 }
 
 
@@ -8184,30 +10818,44 @@ static int compareTypeDef(const void *key, const void *el)
  */
 static const sipTypeDef *sip_api_find_type(const char *type)
 {
-    sipExportedModuleDef *em;
+    const sipTypeDef *td = NULL;
+    size_t len = strlen(type);
 
-    for (em = moduleList; em != NULL; em = em->em_next)
+    lock_type_index();
+
+    if (type_index_size != 0)
     {
-        sipTypeDef **tdp;
+        for (;;)
+        {
+            sipTypeIndexEntry *tie = find_type_index_entry(type_index,
+                    type_index_size, type, len, hash_type_name(type, len));
 
-        /* The backdoor to the comparison helper. */
-        module_searched = em;
+            if (tie->name != NULL)
+            {
+                /*
+                 * Note that this will be NULL for unresolved externally
+                 * defined types.
+                 */
+                td = *tie->tdp;
+                break;
+            }
 
-        tdp = (sipTypeDef **)bsearch((const void *)type,
-                (const void *)em->em_types, em->em_nrtypes,
-                sizeof (sipTypeDef *), compareTypeDef);
+            /* We might be looking for a pointer or a reference. */
+            while (len > 0 && type[len - 1] != '*' && type[len - 1] != '&')
+                --len;
 
-        if (tdp != NULL)
-        {
-            /*
-             * Note that this will be NULL for unresolved externally defined
-             * types.
-             */
-            return *tdp;
+            if (len == 0)
+                break;
+
+            /* Drop any trailing pointers or references. */
+            while (len > 0 && (type[len - 1] == '*' || type[len - 1] == '&'))
+                --len;
         }
     }
 
-    return NULL;
+    unlock_type_index();
+
+    return td;
 }
 
 
@@ -8244,30 +10892,98 @@ static void sip_api_call_hook(const char *hookname)
 /*
  * Call any sub-class convertors for a given type returning a pointer to the
  * sub-type object, and possibly modifying the C++ address (in the case of
- * multiple inheritence).
+ * multiple inheritence).  NULL is returned and an exception raised if a type
+ * object couldn't be created.
  */
 static const sipTypeDef *convertSubClass(const sipTypeDef *td, void **cppPtr)
 {
+    int rc;
+#if !defined(Py_GIL_DISABLED)
+    sipDynamicTypeFunc dynamic_type_func;
+    sipSubClassCacheEntry *scce = NULL;
+    const sipTypeDef *orig_td = td;
+    const void *dynamic_type = NULL;
+    void *orig_cpp;
+#endif
+
     /* Handle the trivial case. */
     if (*cppPtr == NULL)
         return NULL;
 
+#if !defined(Py_GIL_DISABLED)
+    /*
+     * If the C++ dynamic type can be identified then see if the result of the
+     * convertors is already known.  This depends on the result being
+     * determined solely by the dynamic type.
+     */
+    if ((dynamic_type_func = get_dynamic_type(td)) != NULL)
+    {
+        dynamic_type = dynamic_type_func(*cppPtr);
+
+        scce = &subclass_cache[(((uintptr_t)td >> 4) ^ ((uintptr_t)dynamic_type >> 4)) % SUBCLASS_CACHE_SIZE];
+
+        if (scce->td == td && scce->dynamic_type == dynamic_type)
+        {
+            sipStatsInc(sipStatSubClassCacheHits);
+
+            *cppPtr = (char *)*cppPtr + scce->offset;
+
+            return scce->sub_td;
+        }
+    }
+
+    orig_cpp = *cppPtr;
+#endif
+
     /* Try the conversions until told to stop. */
-    while (convertPass(&td, cppPtr))
+    while ((rc = convertPass(&td, cppPtr)) > 0)
         ;
 
+    if (rc < 0)
+        return NULL;
+
+#if !defined(Py_GIL_DISABLED)
+    if (scce != NULL)
+    {
+        scce->td = orig_td;
+        scce->dynamic_type = dynamic_type;
+        scce->sub_td = td;
+        scce->offset = (char *)*cppPtr - (char *)orig_cpp;
+    }
+#endif
+
     return td;
 }
 
 
+#if !defined(Py_GIL_DISABLED)
+/*
+ * Return the function that identifies the C++ dynamic type of an instance of a
+ * class, if it has one.
+ */
+static sipDynamicTypeFunc get_dynamic_type(const sipTypeDef *td)
+{
+    /* The function was added in ABI v13.9. */
+    if (!sipTypeIsClass(td) || td->td_module->em_api_minor < 9)
+        return NULL;
+
+    return ((const sipClassTypeDef *)td)->ctd_dynamic_type;
+}
+#endif
+
+
 /*
- * Do a single pass through the available convertors.
+ * Do a single pass through the available convertors.  A negative value is
+ * returned and an exception raised if a type object couldn't be created.
  */
 static int convertPass(const sipTypeDef **tdp, void **cppPtr)
 {
     PyTypeObject *py_type = sipTypeAsPyTypeObject(*tdp);
     sipExportedModuleDef *em;
 
+    if (py_type == NULL)
+        return -1;
+
     /*
      * Note that this code depends on the fact that a module appears in the
      * list of modules before any module it imports, ie. sub-class convertors
@@ -8282,7 +10998,11 @@ static int convertPass(const sipTypeDef **tdp, void **cppPtr)
 
         while (scc->scc_convertor != NULL)
         {
-            PyTypeObject *base_type = sipTypeAsPyTypeObject(scc->scc_basetype);
+            /*
+             * If the type object of the root hasn't been created then the
+             * target can't be a sub-class of it.
+             */
+            PyTypeObject *base_type = scc->scc_basetype->td_py_type;
 
             /*
              * The base type is the "root" class that may have a number of
@@ -8293,17 +11013,22 @@ static int convertPass(const sipTypeDef **tdp, void **cppPtr)
              * sub-class of the root, ie. see if the convertor might be able to
              * convert the target type to something more specific.
              */
-            if (PyType_IsSubtype(py_type, base_type))
+            if (base_type != NULL && PyType_IsSubtype(py_type, base_type))
             {
                 void *ptr;
                 const sipTypeDef *sub_td;
 
                 ptr = cast_cpp_ptr(*cppPtr, py_type, scc->scc_basetype);
 
+                sipStatsInc(sipStatSubClassConvertors);
+
                 if ((sub_td = (*scc->scc_convertor)(&ptr)) != NULL)
                 {
                     PyTypeObject *sub_type = sipTypeAsPyTypeObject(sub_td);
 
+                    if (sub_type == NULL)
+                        return -1;
+
                     /*
                      * We are only interested in types that are not
                      * super-classes of the target.  This happens either
@@ -8373,11 +11098,12 @@ static void sip_api_raise_type_exception(const sipTypeDef *td, void *ptr)
 
     SIP_BLOCK_THREADS
 
-    self = wrap_simple_instance(ptr, td, NULL, SIP_PY_OWNED);
-
-    PyErr_SetObject((PyObject *)sipTypeAsPyTypeObject(td), self);
-
-    Py_XDECREF(self);
+    /* If the instance couldn't be created then that exception is raised. */
+    if ((self = wrap_simple_instance(ptr, td, NULL, SIP_PY_OWNED)) != NULL)
+    {
+        PyErr_SetObject((PyObject *)Py_TYPE(self), self);
+        Py_DECREF(self);
+    }
 
     SIP_UNBLOCK_THREADS
 }
@@ -8611,61 +11337,180 @@ static PyObject *sipWrapperType_alloc(PyTypeObject *self, Py_ssize_t nitems)
 
             ((PyTypeObject *)o)->tp_doc = docstring;
 
-            addClassSlots((sipWrapperType *)o, ctd);
+            addClassSlots((sipWrapperType *)o, ctd);
+
+            /* Patch any mixin initialiser. */
+            if (ctd->ctd_init_mixin != NULL)
+                ((PyTypeObject *)o)->tp_init = ctd->ctd_init_mixin;
+        }
+    }
+
+    return o;
+}
+
+
+/*
+ * The metatype init slot.
+ */
+static int sipWrapperType_init(sipWrapperType *self, PyObject *args,
+        PyObject *kwds)
+{
+    /* Call the standard super-metatype init. */
+    if (PyType_Type.tp_init((PyObject *)self, args, kwds) < 0)
+        return -1;
+
+    /*
+     * If we don't yet have any extra type specific information (because we are
+     * a programmer defined sub-class) then get it from the (first) super-type.
+     */
+    if (self->wt_td == NULL)
+    {
+        PyTypeObject *base = ((PyTypeObject *)self)->tp_base;
+
+        self->wt_user_type = TRUE;
+
+        /*
+         * We allow the class to use this as a meta-type without being derived
+         * from a class that uses it.  This allows mixin classes that need
+         * their own meta-type to work so long as their meta-type is derived
+         * from this meta-type.  This condition is indicated by the pointer to
+         * the generated type structure being NULL.
+         */
+        if (base != NULL && PyObject_TypeCheck((PyObject *)base, (PyTypeObject *)&sipWrapperType_Type))
+            self->wt_td = ((sipWrapperType *)base)->wt_td;
+    }
+    else
+    {
+        /*
+         * We must be a generated type so remember the type object in the
+         * generated type structure.
+         */
+        assert(self->wt_td->td_py_type == NULL);
+
+        self->wt_td->td_py_type = (PyTypeObject *)self;
+
+#if PY_VERSION_HEX >= 0x03090000
+        /*
+         * Use the vectorcall protocol to create instances if the type's ctors
+         * support it.  Note that this is never inherited by sub-classes.
+         */
+        if (sipTypeIsClass(self->wt_td) && get_init_vectorcall((sipClassTypeDef *)self->wt_td) != NULL)
+            ((PyTypeObject *)self)->tp_vectorcall = sipWrapperType_vectorcall;
+#endif
+    }
+
+    return 0;
+}
+
+
+#if PY_VERSION_HEX >= 0x03090000
+/*
+ * The metatype vectorcall slot used when creating an instance of a generated
+ * type.  The ctor's arguments are parsed directly from the vector.
+ */
+static PyObject *sipWrapperType_vectorcall(PyObject *callable,
+        PyObject *const *args, size_t nargsf, PyObject *kwnames)
+{
+    sipWrapperType *wt = (sipWrapperType *)callable;
+    PyTypeObject *py_type = (PyTypeObject *)callable;
+    sipClassTypeDef *ctd = (sipClassTypeDef *)wt->wt_td;
+    Py_ssize_t nargs = PyVectorcall_NARGS(nargsf);
+    sipInitVectorcallFunc init = get_init_vectorcall(ctd);
+    PyObject *self, *parseErr = NULL;
+    sipWrapper *owner = NULL;
+    void *sipNew;
+
+    /*
+     * Use the standard protocol for anything other than the simple (but most
+     * common) case of creating an instance of a generated type whose __new__
+     * and __init__ haven't been replaced, that isn't wrapping an existing C++
+     * instance and that doesn't need the dict of any unused keyword
+     * arguments.
+     */
+    if (init == NULL || wt->wt_user_type || wt->wt_iextend != NULL ||
+            py_type->tp_new != (newfunc)sipSimpleWrapper_new ||
+            py_type->tp_init != (initproc)sipSimpleWrapper_init ||
+            sipTypeCallSuperInit(&ctd->ctd_base) ||
+            find_finalisation(ctd) != NULL || unused_backdoor != NULL ||
+            sipIsPending())
+        return vectorcall_fallback(callable, args, nargs, kwnames);
+
+    if ((self = sipSimpleWrapper_new(wt, empty_tuple, NULL)) == NULL)
+        return NULL;
+
+    /* Call the C++ ctor. */
+    sipNew = init_vectorcall(init, (sipSimpleWrapper *)self, args, nargs,
+            kwnames, NULL, (PyObject **)&owner, &parseErr);
+
+    if (sipNew == NULL)
+    {
+        /*
+         * If there was no parse error then the C++ ctor must have raised an
+         * exception which has been translated to a Python exception.
+         */
+        if (parseErr != NULL)
+            raise_no_ctor(ctd, parseErr);
+
+        Py_DECREF(self);
 
-            /* Patch any mixin initialiser. */
-            if (ctd->ctd_init_mixin != NULL)
-                ((PyTypeObject *)o)->tp_init = ctd->ctd_init_mixin;
-        }
+        return NULL;
     }
 
-    return o;
+    bind_new_instance((sipSimpleWrapper *)self, sipNew,
+            SIP_DERIVED_CLASS | get_ownership_flags((sipSimpleWrapper *)self, &owner),
+            owner);
+
+    return self;
 }
 
 
 /*
- * The metatype init slot.
+ * Call a type using the standard protocol with arguments that were passed
+ * using the vectorcall protocol.
  */
-static int sipWrapperType_init(sipWrapperType *self, PyObject *args,
-        PyObject *kwds)
+static PyObject *vectorcall_fallback(PyObject *callable,
+        PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames)
 {
-    /* Call the standard super-metatype init. */
-    if (PyType_Type.tp_init((PyObject *)self, args, kwds) < 0)
-        return -1;
+    PyObject *targs, *kwds, *res;
+    Py_ssize_t i;
 
-    /*
-     * If we don't yet have any extra type specific information (because we are
-     * a programmer defined sub-class) then get it from the (first) super-type.
-     */
-    if (self->wt_td == NULL)
+    if ((targs = PyTuple_New(nargs)) == NULL)
+        return NULL;
+
+    for (i = 0; i < nargs; ++i)
     {
-        PyTypeObject *base = ((PyTypeObject *)self)->tp_base;
+        Py_INCREF(args[i]);
+        PyTuple_SET_ITEM(targs, i, args[i]);
+    }
 
-        self->wt_user_type = TRUE;
+    if (kwnames != NULL && PyTuple_GET_SIZE(kwnames) != 0)
+    {
+        sipArgsView av;
 
-        /*
-         * We allow the class to use this as a meta-type without being derived
-         * from a class that uses it.  This allows mixin classes that need
-         * their own meta-type to work so long as their meta-type is derived
-         * from this meta-type.  This condition is indicated by the pointer to
-         * the generated type structure being NULL.
-         */
-        if (base != NULL && PyObject_TypeCheck((PyObject *)base, (PyTypeObject *)&sipWrapperType_Type))
-            self->wt_td = ((sipWrapperType *)base)->wt_td;
+        av.args = args;
+        av.nr_pos_args = nargs;
+        av.kwd_dict = NULL;
+        av.kwd_names = kwnames;
+
+        if ((kwds = args_view_kwd_dict(&av)) == NULL)
+        {
+            Py_DECREF(targs);
+            return NULL;
+        }
     }
     else
     {
-        /*
-         * We must be a generated type so remember the type object in the
-         * generated type structure.
-         */
-        assert(self->wt_td->td_py_type == NULL);
-
-        self->wt_td->td_py_type = (PyTypeObject *)self;
+        kwds = NULL;
     }
 
-    return 0;
+    res = Py_TYPE(callable)->tp_call(callable, targs, kwds);
+
+    Py_DECREF(targs);
+    Py_XDECREF(kwds);
+
+    return res;
 }
+#endif
 
 
 /*
@@ -8749,7 +11594,7 @@ static PyObject *sipSimpleWrapper_new(sipWrapperType *wt, PyObject *args,
          * it's an opaque class.  Some restrictions might be overcome with
          * better SIP support.
          */
-        if (((sipClassTypeDef *)td)->ctd_init == NULL)
+        if (((sipClassTypeDef *)td)->ctd_init == NULL && get_init_vectorcall((sipClassTypeDef *)td) == NULL)
         {
             PyErr_Format(PyExc_TypeError,
                     "%s.%s cannot be instantiated or sub-classed",
@@ -8806,8 +11651,12 @@ static int sipSimpleWrapper_init(sipSimpleWrapper *self, PyObject *args,
         /* Call the C++ ctor. */
         owner = NULL;
 
-        sipNew = ctd->ctd_init(self, args, kwds, unused_p, (PyObject **)&owner,
-                &parseErr);
+        if (ctd->ctd_init != NULL)
+            sipNew = ctd->ctd_init(self, args, kwds, unused_p,
+                    (PyObject **)&owner, &parseErr);
+        else
+            sipNew = call_init_vectorcall(get_init_vectorcall(ctd), self,
+                    args, kwds, unused_p, (PyObject **)&owner, &parseErr);
 
         if (sipNew != NULL)
         {
@@ -8842,44 +11691,171 @@ static int sipSimpleWrapper_init(sipSimpleWrapper *self, PyObject *args,
 
             if (sipNew == NULL)
             {
-                const char *docstring = ctd->ctd_docstring;
+                raise_no_ctor(ctd, parseErr);
 
-                /*
-                 * Use the docstring for errors if it was automatically
-                 * generated.
-                 */
-                if (docstring != NULL)
+                return -1;
+            }
+
+            sipFlags = 0;
+        }
+
+        sipFlags |= get_ownership_flags(self, &owner);
+
+        /* The instance was created from Python. */
+        from_cpp = FALSE;
+    }
+
+    bind_new_instance(self, sipNew, sipFlags, owner);
+
+    /* If we are wrapping an instance returned from C/C++ then we are done. */
+    if (from_cpp)
+    {
+        /*
+         * Invoke any event handlers for instances that are accessed directly.
+         */
+        if (self->access_func == NULL)
+        {
+            sipEventHandler *eh;
+
+            for (eh = event_handlers[sipEventWrappedInstance]; eh != NULL; eh = eh->next)
+            {
+                if (is_subtype(ctd, eh->ctd))
                 {
-                    if (*docstring == AUTO_DOCSTRING)
-                        ++docstring;
-                    else
-                        docstring = NULL;
+                    sipWrappedInstanceEventHandler handler = (sipWrappedInstanceEventHandler)eh->handler;
+
+                    handler(sipNew);
                 }
+            }
+        }
 
-                sip_api_no_function(parseErr,
-                        sipPyNameOfContainer(&ctd->ctd_container, td),
-                        docstring);
+        return 0;
+    }
 
-                return -1;
-            }
+    /* Call any finalisation code. */
+    if (final_func != NULL)
+    {
+        PyObject *new_unused = NULL, **new_unused_p;
 
-            sipFlags = 0;
+        if (unused == NULL || unused != kwds)
+        {
+            /*
+             * There are no unused arguments or we have already created a dict
+             * containing the unused sub-set, so there is no need to create
+             * another.
+             */
+            new_unused_p = NULL;
+        }
+        else
+        {
+            /*
+             * All of the keyword arguments are unused, so if some of them are
+             * now going to be used then a new dict will be needed.
+             */
+            new_unused_p = &new_unused;
+        }
+            
+        if (final_func((PyObject *)self, sipNew, unused, new_unused_p) < 0)
+        {
+            Py_XDECREF(unused);
+            return -1;
         }
 
-        if (owner == NULL)
-            sipFlags |= SIP_PY_OWNED;
-        else if ((PyObject *)owner == Py_None)
+        if (new_unused != NULL)
         {
-            /* This is the hack that means that C++ owns the new instance. */
-            sipFlags |= SIP_CPP_HAS_REF;
-            Py_INCREF(self);
-            owner = NULL;
+            Py_DECREF(unused);
+            unused = new_unused;
         }
+    }
 
-        /* The instance was created from Python. */
-        from_cpp = FALSE;
+    /* See if we should call the equivalent of super().__init__(). */
+    if (sipTypeCallSuperInit(&ctd->ctd_base))
+    {
+        PyObject *next;
+
+        /* Find the next type in the MRO. */
+        next = next_in_mro((PyObject *)self,
+                (PyObject *)&sipSimpleWrapper_Type);
+
+        /*
+         * If the next type in the MRO is object then take a shortcut by not
+         * calling super().__init__() but emulating object.__init__() instead.
+         * This will be the most common case and also allows us to generate a
+         * better exception message if there are unused keyword arguments.  The
+         * disadvantage is that the exception message will be different if
+         * there is a mixin.
+         */
+        if (next != (PyObject *)&PyBaseObject_Type)
+        {
+            int rc = super_init((PyObject *)self, empty_tuple, unused, next);
+
+            Py_XDECREF(unused);
+
+            return rc;
+        }
+    }
+
+    if (unused_backdoor != NULL)
+    {
+        /*
+         * We are being called by a mixin's __init__ so save any unused
+         * arguments for it to pass on to the main class's __init__.
+         */
+        *unused_backdoor = unused;
+    }
+    else if (unused != NULL)
+    {
+        /* We shouldn't have any unused keyword arguments. */
+        if (PyDict_Size(unused) != 0)
+        {
+            PyObject *key, *value;
+            Py_ssize_t pos = 0;
+
+            /* Just report one of the unused arguments. */
+            PyDict_Next(unused, &pos, &key, &value);
+
+            PyErr_Format(PyExc_TypeError,
+                    "'%S' is an unknown keyword argument", key);
+
+            Py_DECREF(unused);
+
+            return -1;
+        }
+
+        Py_DECREF(unused);
+    }
+
+    return 0;
+}
+
+
+/*
+ * Return the flags describing the ownership of an instance of a wrapped class
+ * that has just been created from Python.  The owner is updated accordingly.
+ */
+static int get_ownership_flags(sipSimpleWrapper *self, sipWrapper **ownerp)
+{
+    if (*ownerp == NULL)
+        return SIP_PY_OWNED;
+
+    if ((PyObject *)*ownerp == Py_None)
+    {
+        /* This is the hack that means that C++ owns the new instance. */
+        Py_INCREF(self);
+        *ownerp = NULL;
+
+        return SIP_CPP_HAS_REF;
     }
 
+    return 0;
+}
+
+
+/*
+ * Bind a C/C++ instance to the Python object that wraps it.
+ */
+static void bind_new_instance(sipSimpleWrapper *self, void *sipNew,
+        int sipFlags, sipWrapper *owner)
+{
     /* Handler any owner if the type supports the concept. */
     if (PyObject_TypeCheck((PyObject *)self, (PyTypeObject *)&sipWrapper_Type))
     {
@@ -8890,146 +11866,224 @@ static int sipSimpleWrapper_init(sipSimpleWrapper *self, PyObject *args,
          */
         removeFromParent((sipWrapper *)self);
 
-        if (owner != NULL)
-        {
-            assert(PyObject_TypeCheck((PyObject *)owner, (PyTypeObject *)&sipWrapper_Type));
+        if (owner != NULL)
+        {
+            assert(PyObject_TypeCheck((PyObject *)owner, (PyTypeObject *)&sipWrapper_Type));
+
+            addToParent((sipWrapper *)self, (sipWrapper *)owner);
+        }
+    }
+
+    sipStatsInc(sipStatWraps);
+
+    self->data = sipNew;
+    self->sw_flags = sipFlags | SIP_CREATED | (self->sw_flags & SIP_UNTRACKED);
+
+    /*
+     * A new instance of a value type that is owned by Python can't be known
+     * to C/C++ so there is no need to be able to find it from its address.
+     */
+    if (owner == NULL && (sipFlags & (SIP_PY_OWNED | SIP_NOT_IN_MAP)) == SIP_PY_OWNED && sipTypeIsValue(((sipWrapperType *)Py_TYPE(self))->wt_td))
+        self->sw_flags |= SIP_UNMAPPED;
+
+    /* Set the access function. */
+    if (sipIsAccessFunc(self))
+        self->access_func = explicit_access_func;
+    else if (sipIsIndirect(self))
+        self->access_func = indirect_access_func;
+    else
+        self->access_func = NULL;
+
+    if (!sipNotInMap(self) && !sipIsUnmapped(self))
+        sipOMAddObject(&cppPyMap, self);
+
+    untrack_leaf(self);
+}
+
+
+/*
+ * Stop the garbage collector tracking a new instance of a type that has
+ * /GCUntracked/ if it has no references to other Python objects and so can't
+ * be part of a reference cycle.  It will be tracked again as soon as it
+ * acquires such a reference.
+ */
+static void untrack_leaf(sipSimpleWrapper *sw)
+{
+#if !defined(Py_GIL_DISABLED)
+    PyTypeObject *py_type = Py_TYPE(sw);
+    sipWrapperType *wt = (sipWrapperType *)py_type;
+
+    if (sipIsUntracked(sw))
+        return;
+
+    /*
+     * The type must be exactly the generated type.  In particular Python
+     * sub-classes may have any number of additional references.
+     */
+    if (wt->wt_user_type || !sipTypeIsGCUntracked(wt->wt_td) || py_type->tp_setattro != untracked_setattro)
+        return;
+
+    if (((sipClassTypeDef *)wt->wt_td)->ctd_traverse != NULL)
+        return;
+
+    /*
+     * Some versions of Python eagerly create an instance dictionary.  If it is
+     * still empty then discard it.
+     */
+    if (sw->dict != NULL && Py_REFCNT(sw->dict) == 1 && PyDict_GET_SIZE(sw->dict) == 0)
+        Py_CLEAR(sw->dict);
+
+    if (sw->dict != NULL || sw->extra_refs != NULL || sw->reserved != NULL || sw->user != NULL || sw->mixin_main != NULL)
+        return;
+
+    if (PyObject_TypeCheck((PyObject *)sw, (PyTypeObject *)&sipWrapper_Type) && ((sipWrapper *)sw)->first_child != NULL)
+        return;
+
+    PyObject_GC_UnTrack(sw);
+    sipSetUntracked(sw);
+#else
+    (void)sw;
+#endif
+}
+
+
+/*
+ * Make sure that the garbage collector is tracking an instance that may now be
+ * part of a reference cycle.
+ */
+static void track(sipSimpleWrapper *sw)
+{
+    if (sipIsUntracked(sw))
+    {
+        sipResetUntracked(sw);
+        PyObject_GC_Track(sw);
+    }
+}
+
 
-            addToParent((sipWrapper *)self, (sipWrapper *)owner);
-        }
-    }
+/*
+ * The setattro slot of a type that has /GCUntracked/.
+ */
+#if !defined(Py_GIL_DISABLED)
+static int untracked_setattro(PyObject *self, PyObject *name, PyObject *value)
+{
+    int rc = PyObject_GenericSetAttr(self, name, value);
 
-    self->data = sipNew;
-    self->sw_flags = sipFlags | SIP_CREATED;
+    /* The instance dictionary may have just been created. */
+    if (((sipSimpleWrapper *)self)->dict != NULL)
+        track((sipSimpleWrapper *)self);
 
-    /* Set the access function. */
-    if (sipIsAccessFunc(self))
-        self->access_func = explicit_access_func;
-    else if (sipIsIndirect(self))
-        self->access_func = indirect_access_func;
-    else
-        self->access_func = NULL;
+    return rc;
+}
+#endif
 
-    if (!sipNotInMap(self))
-        sipOMAddObject(&cppPyMap, self);
 
-    /* If we are wrapping an instance returned from C/C++ then we are done. */
-    if (from_cpp)
+/*
+ * Raise an exception because the arguments didn't match any of a wrapped
+ * class's ctors.
+ */
+static void raise_no_ctor(sipClassTypeDef *ctd, PyObject *parseErr)
+{
+    const char *docstring = ctd->ctd_docstring;
+
+    /* Use the docstring for errors if it was automatically generated. */
+    if (docstring != NULL)
     {
-        /*
-         * Invoke any event handlers for instances that are accessed directly.
-         */
-        if (self->access_func == NULL)
-        {
-            sipEventHandler *eh;
+        if (*docstring == AUTO_DOCSTRING)
+            ++docstring;
+        else
+            docstring = NULL;
+    }
 
-            for (eh = event_handlers[sipEventWrappedInstance]; eh != NULL; eh = eh->next)
-            {
-                if (is_subtype(ctd, eh->ctd))
-                {
-                    sipWrappedInstanceEventHandler handler = (sipWrappedInstanceEventHandler)eh->handler;
+    sip_api_no_function(parseErr,
+            sipPyNameOfContainer(&ctd->ctd_container, &ctd->ctd_base),
+            docstring);
+}
 
-                    handler(sipNew);
-                }
-            }
-        }
 
-        return 0;
-    }
+/*
+ * Return the vectorcall initialisation function of a class, if it has one.
+ */
+static sipInitVectorcallFunc get_init_vectorcall(const sipClassTypeDef *ctd)
+{
+    /* The function was added in ABI v13.9. */
+    if (ctd->ctd_base.td_module->em_api_minor < 9)
+        return NULL;
 
-    /* Call any finalisation code. */
-    if (final_func != NULL)
-    {
-        PyObject *new_unused = NULL, **new_unused_p;
+    return ctd->ctd_init_vectorcall;
+}
 
-        if (unused == NULL || unused != kwds)
-        {
-            /*
-             * There are no unused arguments or we have already created a dict
-             * containing the unused sub-set, so there is no need to create
-             * another.
-             */
-            new_unused_p = NULL;
-        }
-        else
-        {
-            /*
-             * All of the keyword arguments are unused, so if some of them are
-             * now going to be used then a new dict will be needed.
-             */
-            new_unused_p = &new_unused;
-        }
-            
-        if (final_func((PyObject *)self, sipNew, unused, new_unused_p) < 0)
-        {
-            Py_XDECREF(unused);
-            return -1;
-        }
 
-        if (new_unused != NULL)
-        {
-            Py_DECREF(unused);
-            unused = new_unused;
-        }
-    }
+/*
+ * Call a vectorcall initialisation function.  If the arguments don't match any
+ * of the ctors then they are parsed again so that the reasons are recorded.
+ */
+static void *init_vectorcall(sipInitVectorcallFunc init,
+        sipSimpleWrapper *self, PyObject *const *args, Py_ssize_t nargs,
+        PyObject *kwnames, PyObject **unused, PyObject **owner,
+        PyObject **parseErr)
+{
+    void *sipNew = init(self, args, nargs, kwnames, unused, owner, parseErr);
 
-    /* See if we should call the equivalent of super().__init__(). */
-    if (sipTypeCallSuperInit(&ctd->ctd_base))
+    if (sipNew == NULL && sip_api_start_parse_diagnosis(parseErr))
     {
-        PyObject *next;
+        sipNew = init(self, args, nargs, kwnames, unused, owner, parseErr);
+        sip_api_end_parse_diagnosis();
+    }
 
-        /* Find the next type in the MRO. */
-        next = next_in_mro((PyObject *)self,
-                (PyObject *)&sipSimpleWrapper_Type);
+    return sipNew;
+}
 
-        /*
-         * If the next type in the MRO is object then take a shortcut by not
-         * calling super().__init__() but emulating object.__init__() instead.
-         * This will be the most common case and also allows us to generate a
-         * better exception message if there are unused keyword arguments.  The
-         * disadvantage is that the exception message will be different if
-         * there is a mixin.
-         */
-        if (next != (PyObject *)&PyBaseObject_Type)
-        {
-            int rc = super_init((PyObject *)self, empty_tuple, unused, next);
 
-            Py_XDECREF(unused);
+/*
+ * Call a vectorcall initialisation function with a tuple of positional
+ * arguments and an optional dict of keyword arguments.
+ */
+static void *call_init_vectorcall(sipInitVectorcallFunc init,
+        sipSimpleWrapper *self, PyObject *args, PyObject *kwds,
+        PyObject **unused, PyObject **owner, PyObject **parseErr)
+{
+    PyObject *const *pos_args = ((PyTupleObject *)args)->ob_item;
+    Py_ssize_t nargs = PyTuple_GET_SIZE(args), nr_kwds, pos, i;
+    PyObject **all_args, *kwnames, *key, *value;
+    void *sipNew;
 
-            return rc;
-        }
-    }
+    /* The positional arguments can be passed directly. */
+    if (kwds == NULL || (nr_kwds = PyDict_Size(kwds)) == 0)
+        return init_vectorcall(init, self, pos_args, nargs, NULL, unused,
+                owner, parseErr);
 
-    if (unused_backdoor != NULL)
+    /* Otherwise the values are appended and the names put in a tuple. */
+    if ((kwnames = PyTuple_New(nr_kwds)) == NULL)
+        return NULL;
+
+    if ((all_args = sip_api_malloc(sizeof (PyObject *) * (nargs + nr_kwds))) == NULL)
     {
-        /*
-         * We are being called by a mixin's __init__ so save any unused
-         * arguments for it to pass on to the main class's __init__.
-         */
-        *unused_backdoor = unused;
+        Py_DECREF(kwnames);
+        return NULL;
     }
-    else if (unused != NULL)
-    {
-        /* We shouldn't have any unused keyword arguments. */
-        if (PyDict_Size(unused) != 0)
-        {
-            PyObject *key, *value;
-            Py_ssize_t pos = 0;
 
-            /* Just report one of the unused arguments. */
-            PyDict_Next(unused, &pos, &key, &value);
+    for (i = 0; i < nargs; ++i)
+        all_args[i] = pos_args[i];
 
-            PyErr_Format(PyExc_TypeError,
-                    "'%S' is an unknown keyword argument", key);
+    pos = 0;
+    i = 0;
 
-            Py_DECREF(unused);
+    while (PyDict_Next(kwds, &pos, &key, &value))
+    {
+        Py_INCREF(key);
+        PyTuple_SET_ITEM(kwnames, i, key);
+        all_args[nargs + i] = value;
+        ++i;
+    }
 
-            return -1;
-        }
+    sipNew = init_vectorcall(init, self, all_args, nargs, kwnames, unused,
+            owner, parseErr);
 
-        Py_DECREF(unused);
-    }
+    sip_api_free(all_args);
+    Py_DECREF(kwnames);
 
-    return 0;
+    return sipNew;
 }
 
 
@@ -9070,6 +12124,9 @@ static int sip_api_init_mixin(PyObject *self, PyObject *args, PyObject *kwds,
 
     static PyObject *double_us = NULL;
 
+    if (self_wt == NULL || wt == NULL)
+        return -1;
+
     if (sip_objectify("__", &double_us) < 0)
         return -1;
 
@@ -9094,6 +12151,7 @@ static int sip_api_init_mixin(PyObject *self, PyObject *args, PyObject *kwds,
     /* Make sure the mixin can find the main instance. */
     ((sipSimpleWrapper *)mixin)->mixin_main = self;
     Py_INCREF(self);
+    track((sipSimpleWrapper *)mixin);
 
     if ((mixin_name = PyUnicode_FromString(sipTypeName(&ctd->ctd_base))) == NULL)
     {
@@ -9283,6 +12341,10 @@ static int sipSimpleWrapper_traverse(sipSimpleWrapper *self, visitproc visit,
         if ((vret = visit(self->extra_refs, arg)) != 0)
             return vret;
 
+    if (self->reserved != NULL)
+        if ((vret = visit((PyObject *)self->reserved, arg)) != 0)
+            return vret;
+
     if (self->user != NULL)
         if ((vret = visit(self->user, arg)) != 0)
             return vret;
@@ -9315,11 +12377,15 @@ static int sipSimpleWrapper_clear(sipSimpleWrapper *self)
     self->dict = NULL;
     Py_XDECREF(tmp);
 
-    /* Remove any extra references dictionary. */
+    /* Remove any extra references. */
     tmp = self->extra_refs;
     self->extra_refs = NULL;
     Py_XDECREF(tmp);
 
+    tmp = (PyObject *)self->reserved;
+    self->reserved = NULL;
+    Py_XDECREF(tmp);
+
     /* Remove any user object. */
     tmp = self->user;
     self->user = NULL;
@@ -9545,6 +12611,8 @@ static PyObject *sipSimpleWrapper_get_dict(sipSimpleWrapper *sw, void *closure)
 
         if (sw->dict == NULL)
             return NULL;
+
+        track(sw);
     }
 
     Py_INCREF(sw->dict);
@@ -9574,6 +12642,9 @@ static int sipSimpleWrapper_set_dict(sipSimpleWrapper *sw, PyObject *value,
     Py_XINCREF(value);
     sw->dict = value;
 
+    if (value != NULL)
+        track(sw);
+
     return 0;
 }
 
@@ -9732,7 +12803,7 @@ sipWrapperType sipSimpleWrapper_Type = {
     0,                      /* wt_td */
     0,                      /* wt_iextend */
     0,                      /* wt_user_data */
-    0,                      /* wt_reserved */
+    0,                      /* wt_private */
 };
 
 
@@ -10290,10 +13361,21 @@ static char sip_api_string_as_ascii_char(PyObject *obj)
  */
 static int parseString_AsASCIIChar(PyObject *obj, char *ap)
 {
+    const char *s;
+
+    /* Avoid encoding the string if possible. */
+    if ((s = parseString_BorrowASCII(obj)) != NULL && PyUnicode_GET_LENGTH(obj) == 1)
+    {
+        if (ap != NULL)
+            *ap = *s;
+
+        return 0;
+    }
+
     if (parseString_AsEncodedChar(PyUnicode_AsASCIIString(obj), obj, ap) < 0)
     {
         /* Use the exception set if it was an encoding error. */
-        if (!PyUnicode_Check(obj) || PyUnicode_GET_LENGTH(obj) != 1)
+        if (!PyUnicode_Check(obj) || PyUnicode_GET_LENGTH(obj) != 1 || !PyErr_Occurred())
             PyErr_SetString(PyExc_TypeError,
                     "bytes or ASCII string of length 1 expected");
 
@@ -10324,10 +13406,21 @@ static char sip_api_string_as_latin1_char(PyObject *obj)
  */
 static int parseString_AsLatin1Char(PyObject *obj, char *ap)
 {
+    const char *s;
+
+    /* Avoid encoding the string if possible. */
+    if ((s = parseString_BorrowLatin1(obj)) != NULL && PyUnicode_GET_LENGTH(obj) == 1)
+    {
+        if (ap != NULL)
+            *ap = *s;
+
+        return 0;
+    }
+
     if (parseString_AsEncodedChar(PyUnicode_AsLatin1String(obj), obj, ap) < 0)
     {
         /* Use the exception set if it was an encoding error. */
-        if (!PyUnicode_Check(obj) || PyUnicode_GET_LENGTH(obj) != 1)
+        if (!PyUnicode_Check(obj) || PyUnicode_GET_LENGTH(obj) != 1 || !PyErr_Occurred())
             PyErr_SetString(PyExc_TypeError,
                     "bytes or Latin-1 string of length 1 expected");
 
@@ -10358,10 +13451,21 @@ static char sip_api_string_as_utf8_char(PyObject *obj)
  */
 static int parseString_AsUTF8Char(PyObject *obj, char *ap)
 {
+    const char *s;
+
+    /* Avoid encoding the string if possible. */
+    if ((s = parseString_BorrowASCII(obj)) != NULL && PyUnicode_GET_LENGTH(obj) == 1)
+    {
+        if (ap != NULL)
+            *ap = *s;
+
+        return 0;
+    }
+
     if (parseString_AsEncodedChar(PyUnicode_AsUTF8String(obj), obj, ap) < 0)
     {
         /* Use the exception set if it was an encoding error. */
-        if (!PyUnicode_Check(obj) || PyUnicode_GET_LENGTH(obj) != 1)
+        if (!PyUnicode_Check(obj) || PyUnicode_GET_LENGTH(obj) != 1 || !PyErr_Occurred())
             PyErr_SetString(PyExc_TypeError,
                     "bytes or UTF-8 string of length 1 expected");
 
@@ -10434,6 +13538,17 @@ static const char *sip_api_string_as_ascii_string(PyObject **obj)
  */
 static PyObject *parseString_AsASCIIString(PyObject *obj, const char **ap)
 {
+    const char *s;
+
+    /* Avoid encoding the string if possible. */
+    if ((s = parseString_BorrowASCII(obj)) != NULL)
+    {
+        *ap = s;
+
+        Py_INCREF(obj);
+        return obj;
+    }
+
     return parseString_AsEncodedString(PyUnicode_AsASCIIString(obj), obj, ap);
 }
 
@@ -10469,6 +13584,17 @@ static const char *sip_api_string_as_latin1_string(PyObject **obj)
  */
 static PyObject *parseString_AsLatin1String(PyObject *obj, const char **ap)
 {
+    const char *s;
+
+    /* Avoid encoding the string if possible. */
+    if ((s = parseString_BorrowLatin1(obj)) != NULL)
+    {
+        *ap = s;
+
+        Py_INCREF(obj);
+        return obj;
+    }
+
     return parseString_AsEncodedString(PyUnicode_AsLatin1String(obj), obj, ap);
 }
 
@@ -10504,10 +13630,72 @@ static const char *sip_api_string_as_utf8_string(PyObject **obj)
  */
 static PyObject *parseString_AsUTF8String(PyObject *obj, const char **ap)
 {
+    const char *s;
+
+    /* Avoid encoding the string if possible. */
+    if ((s = parseString_BorrowUTF8(obj)) != NULL)
+    {
+        *ap = s;
+
+        Py_INCREF(obj);
+        return obj;
+    }
+
     return parseString_AsEncodedString(PyUnicode_AsUTF8String(obj), obj, ap);
 }
 
 
+/*
+ * Return a borrowed pointer to the ASCII representation of a string if it can
+ * be obtained without encoding the string, otherwise return NULL.  The pointer
+ * is valid for the lifetime of the string.
+ */
+static const char *parseString_BorrowASCII(PyObject *obj)
+{
+    if (PyUnicode_Check(obj) && PyUnicode_IS_COMPACT_ASCII(obj))
+        return (const char *)PyUnicode_DATA(obj);
+
+    return NULL;
+}
+
+
+/*
+ * Return a borrowed pointer to the Latin-1 representation of a string if it
+ * can be obtained without encoding the string, otherwise return NULL.  The
+ * pointer is valid for the lifetime of the string.
+ */
+static const char *parseString_BorrowLatin1(PyObject *obj)
+{
+    /* A string that only uses one byte per character is stored as Latin-1. */
+    if (PyUnicode_Check(obj) && PyUnicode_IS_COMPACT(obj) && PyUnicode_KIND(obj) == PyUnicode_1BYTE_KIND)
+        return (const char *)PyUnicode_DATA(obj);
+
+    return NULL;
+}
+
+
+/*
+ * Return a borrowed pointer to the UTF-8 representation of a string if it can
+ * be obtained without encoding the string, otherwise return NULL.  The pointer
+ * is valid for the lifetime of the string.
+ */
+static const char *parseString_BorrowUTF8(PyObject *obj)
+{
+    const char *s;
+
+    if ((s = parseString_BorrowASCII(obj)) != NULL)
+        return s;
+
+#if !defined(Py_GIL_DISABLED)
+    /* Use any UTF-8 representation that has already been cached. */
+    if (PyUnicode_Check(obj) && PyUnicode_IS_COMPACT(obj))
+        return ((PyCompactUnicodeObject *)obj)->utf8;
+#endif
+
+    return NULL;
+}
+
+
 /*
  * Parse an encoded string and return it and a new reference to the object that
  * owns the string.
@@ -10719,7 +13907,7 @@ static int convertToWCharArray(PyObject *obj, wchar_t **ap, Py_ssize_t *aszp)
     if ((wc = sip_api_malloc(ulen * sizeof (wchar_t))) == NULL)
         return -1;
 
-    if ((ulen = PyUnicode_AsWideChar(obj, wc, ulen)) < 0)
+    if (copyWideChars(obj, wc, ulen) < 0)
     {
         sip_api_free(wc);
         return -1;
@@ -10732,6 +13920,26 @@ static int convertToWCharArray(PyObject *obj, wchar_t **ap, Py_ssize_t *aszp)
 }
 
 
+/*
+ * Copy the characters of a Unicode object to a wide character array of the
+ * same length.
+ */
+static int copyWideChars(PyObject *obj, wchar_t *wc, Py_ssize_t ulen)
+{
+    /*
+     * If the string is stored using characters of the same size as wchar_t
+     * then it can simply be copied.
+     */
+    if (PyUnicode_IS_COMPACT(obj) && PyUnicode_KIND(obj) == sizeof (wchar_t))
+    {
+        memcpy(wc, PyUnicode_DATA(obj), ulen * sizeof (wchar_t));
+        return 0;
+    }
+
+    return (PyUnicode_AsWideChar(obj, wc, ulen) < 0 ? -1 : 0);
+}
+
+
 /*
  * Parse a wide character and return it.
  */
@@ -10813,7 +14021,7 @@ static int convertToWCharString(PyObject *obj, wchar_t **ap)
     if ((wc = sip_api_malloc((ulen + 1) * sizeof (wchar_t))) == NULL)
         return -1;
 
-    if ((ulen = PyUnicode_AsWideChar(obj, wc, ulen)) < 0)
+    if (copyWideChars(obj, wc, ulen) < 0)
     {
         sip_api_free(wc);
         return -1;
@@ -10982,7 +14190,12 @@ static int sip_api_enable_autoconversion(const sipTypeDef *td, int enable)
     else
     {
         /* Add it to the list. */
-        if (addPyObjectToList(&sipDisabledAutoconversions, (PyObject *)sipTypeAsPyTypeObject(td)) < 0)
+        PyObject *type = (PyObject *)sipTypeAsPyTypeObject(td);
+
+        if (type == NULL)
+            return -1;
+
+        if (addPyObjectToList(&sipDisabledAutoconversions, type) < 0)
             return -1;
     }
 
@@ -10996,9 +14209,13 @@ static int sip_api_enable_autoconversion(const sipTypeDef *td, int enable)
  */
 static sipPyObject **autoconversion_disabled(const sipTypeDef *td)
 {
-    PyObject *type = (PyObject *)sipTypeAsPyTypeObject(td);
+    /* A type object that hasn't been created won't be in the list. */
+    PyObject *type = (PyObject *)td->td_py_type;
     sipPyObject **pop;
 
+    if (type == NULL)
+        return NULL;
+
     for (pop = &sipDisabledAutoconversions; *pop != NULL; pop = &(*pop)->next)
         if ((*pop)->object == type)
             return pop;
@@ -11079,8 +14296,12 @@ static sipSimpleWrapper *deref_mixin(sipSimpleWrapper *w)
 static PyObject *wrap_simple_instance(void *cpp, const sipTypeDef *td,
         sipWrapper *owner, int flags)
 {
-    return sipWrapInstance(cpp, sipTypeAsPyTypeObject(td), empty_tuple, owner,
-            flags);
+    PyTypeObject *py_type = sipTypeAsPyTypeObject(td);
+
+    if (py_type == NULL)
+        return NULL;
+
+    return sipWrapInstance(cpp, py_type, empty_tuple, owner, flags);
 }
 
 
@@ -11558,6 +14779,13 @@ static int importTypes(sipExportedModuleDef *client, sipImportedModuleDef *im,
         while (td == NULL);
 
         im->im_imported_types[i].it_td = td;
+
+        /*
+         * Modules built against an earlier ABI read the type object of an
+         * imported type directly so make sure that it has been created.
+         */
+        if (client->em_api_minor < 9 && sipModuleHasLazyTypes(em) && sipTypeAsPyTypeObject(td) == NULL && PyErr_Occurred())
+            return -1;
     }
 
     return 0;
@@ -11767,24 +14995,11 @@ static int sip_api_register_event_handler(sipEventType type,
 static int is_subtype(const sipClassTypeDef *ctd,
         const sipClassTypeDef *base_ctd)
 {
-    const sipEncodedTypeDef *sup;
-
-    /* Handle the trivial cases. */
-    if (ctd == base_ctd)
-        return TRUE;
-
-    if ((sup = ctd->ctd_supers) == NULL)
-        return FALSE;
-
-    /* Search the super-types. */
-    do
-    {
-        const sipClassTypeDef *sup_ctd = sipGetGeneratedClassType(sup, ctd);
+    const sipAncestorDef *an;
 
-        if (is_subtype(sup_ctd, base_ctd))
+    for (an = sipClassAncestors(ctd); an->an_ctd != NULL; ++an)
+        if (an->an_ctd == base_ctd)
             return TRUE;
-    }
-    while (!sup++->sc_flag);
 
     return FALSE;
 }
@@ -11828,7 +15043,8 @@ PyObject *sip_get_qualname(const sipTypeDef *td, PyObject *name)
     PyTypeObject *scope_type;
 
     /* Get the type that is the scope. */
-    scope_type = sipTypeAsPyTypeObject(td);
+    if ((scope_type = sipTypeAsPyTypeObject(td)) == NULL)
+        return NULL;
 
     return PyUnicode_FromFormat("%U.%U",
             ((PyHeapTypeObject *)scope_type)->ht_qualname, name);
@@ -11857,19 +15073,7 @@ int sip_api_convert_from_slice_object(PyObject *slice, Py_ssize_t length,
 static void sip_api_visit_wrappers(sipWrapperVisitorFunc visitor,
         void *closure)
 {
-    const sipHashEntry *he;
-    unsigned long i;
-
-    for (he = cppPyMap.hash_array, i = 0; i < cppPyMap.size; ++i, ++he)
-    {
-        if (he->key != NULL)
-        {
-            sipSimpleWrapper *sw;
-
-            for (sw = he->first; sw != NULL; sw = sw->next)
-                visitor(sw, closure);
-        }
-    }
+    sipOMVisitWrappers(&cppPyMap, visitor, closure);
 }
 
 
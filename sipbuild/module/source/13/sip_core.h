@@ -32,6 +32,43 @@ extern "C" {
 #define FALSE       0
 
 
+/*
+ * The storage class of a thread-local variable if the compiler supports them.
+ */
+#if defined(_MSC_VER)
+#define SIP_THREAD_LOCAL    __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define SIP_THREAD_LOCAL    _Thread_local
+#elif defined(__GNUC__)
+#define SIP_THREAD_LOCAL    __thread
+#endif
+
+
+/*
+ * Within the sip module the type object of a type whose module uses lazy types
+ * is created when it is first needed.
+ */
+#undef  sipTypeAsPyTypeObject
+#define sipTypeAsPyTypeObject(td) \
+        ((td)->td_py_type != NULL ? (td)->td_py_type : sip_api_type_as_py_type_object(td))
+
+/*
+ * An object can't be an instance of a type whose type object hasn't been
+ * created so checking an object's type never needs to create it.
+ */
+#define sipTypeCheck(obj, td) \
+        ((td)->td_py_type != NULL && PyObject_TypeCheck((obj), (td)->td_py_type))
+
+#if !defined(Py_GIL_DISABLED)
+#define sipModuleHasLazyTypes(em) \
+        ((em)->em_api_minor >= 9 && ((em)->em_flags & SIP_MODULE_LAZY_TYPES))
+#else
+/* Types are always created up front rather than racing to create them. */
+#define sipModuleHasLazyTypes(em)   FALSE
+#endif
+
+
+#if defined(SIP_PRIME_OBJECT_MAP)
 /*
  * This defines a single entry in an object map's hash table.
  */
@@ -40,22 +77,149 @@ typedef struct
     void *key;                  /* The C/C++ address. */
     sipSimpleWrapper *first;    /* The first object at this address. */
 } sipHashEntry;
+#else
+/*
+ * This defines one of an object map's hash tables.  The keys are kept
+ * separate from the values so that probing only touches the keys.
+ */
+typedef struct
+{
+    uintptr_t size;             /* Size of hash table (a power of 2). */
+    uintptr_t unused;           /* Nr. unused in hash table. */
+    uintptr_t stale;            /* Nr. stale in hash table. */
+    void **keys;                /* The C/C++ addresses. */
+    sipSimpleWrapper **firsts;  /* The first object at each address. */
+} sipHashTable;
+#endif
 
 
 /*
- * This defines the interface to a hash table class for mapping C/C++ addresses
- * to the corresponding wrapped Python object.
+ * This defines an alias of a wrapper for an address that is different when the
+ * C/C++ instance is cast to a super-type.  In the list of wrappers at an
+ * address a pointer to an alias is tagged by setting its least significant
+ * bit.
+ */
+typedef struct _sipAlias
+{
+    union {
+        sipSimpleWrapper *wrapper;  /* The wrapper. */
+        struct _sipAlias *next_free;    /* The next free alias in the pool. */
+    } u;
+    sipSimpleWrapper *next;     /* The next wrapper at the address. */
+} sipAlias;
+
+
+/*
+ * This defines a slab of aliases allocated in one go.
+ */
+#define SIP_OM_ALIAS_SLAB_SIZE  255
+
+typedef struct _sipAliasSlab
+{
+    struct _sipAliasSlab *next; /* The next slab. */
+    sipAlias aliases[SIP_OM_ALIAS_SLAB_SIZE];   /* The aliases. */
+} sipAliasSlab;
+
+
+/*
+ * This defines a shard of an object map.  A map is split into shards that can
+ * be locked independently when there is no GIL.
  */
 typedef struct
 {
+#if defined(Py_GIL_DISABLED)
+    PyMutex mutex;              /* The lock for the shard. */
+#endif
+#if defined(SIP_PRIME_OBJECT_MAP)
     int primeIdx;               /* Index into table sizes. */
     uintptr_t size;             /* Size of hash table. */
     uintptr_t unused;           /* Nr. unused in hash table. */
     uintptr_t stale;            /* Nr. stale in hash table. */
     sipHashEntry *hash_array;   /* Current hash table. */
+#else
+    sipHashTable current;       /* The table that entries are added to. */
+    sipHashTable previous;      /* The table being migrated during a resize. */
+    uintptr_t migrated;         /* Nr. of slots of previous migrated. */
+#endif
+    unsigned long nr_lookups;   /* Nr. of times the map was searched. */
+    unsigned long nr_probes;    /* Nr. of slots looked at while searching. */
+    unsigned long max_probes;   /* The most slots looked at by one search. */
+    unsigned long nr_resizes;   /* Nr. of times the map was resized. */
+    sipAliasSlab *alias_slabs;  /* The slabs of aliases, newest first. */
+    int alias_slab_used;        /* Nr. of aliases used in the newest slab. */
+    sipAlias *free_aliases;     /* The list of free aliases. */
+    uintptr_t nr_aliases;       /* Nr. of aliases in use. */
+} sipObjectMapShard;
+
+
+/*
+ * This defines the interface to a hash table class for mapping C/C++ addresses
+ * to the corresponding wrapped Python object.
+ */
+#if defined(Py_GIL_DISABLED)
+#define SIP_OM_SHARD_BITS   4
+#define SIP_OM_NR_SHARDS    (1 << SIP_OM_SHARD_BITS)
+#else
+#define SIP_OM_NR_SHARDS    1
+#endif
+
+typedef struct
+{
+    sipObjectMapShard shards[SIP_OM_NR_SHARDS]; /* The shards. */
 } sipObjectMap;
 
 
+/*
+ * This defines the statistics about an object map.
+ */
+typedef struct
+{
+    const char *implementation; /* The name of the implementation. */
+    uintptr_t size;             /* The total number of slots. */
+    uintptr_t nr_entries;       /* The number of slots in use. */
+    uintptr_t nr_stale;         /* The number of stale slots. */
+    unsigned long nr_lookups;   /* The number of searches. */
+    unsigned long nr_probes;    /* The number of slots looked at. */
+    unsigned long max_probes;   /* The most slots looked at by one search. */
+    unsigned long nr_resizes;   /* The number of resizes. */
+    int resizing;               /* Set if a resize is in progress. */
+    int nr_shards;              /* The number of shards. */
+    uintptr_t nr_aliases;       /* The number of aliases. */
+} sipObjectMapStats;
+
+
+/*
+ * This defines an entry in the flattened table of the ancestors of a class.
+ * The first entry is the class itself and the table is terminated by an entry
+ * with a NULL class.
+ */
+typedef struct _sipAncestorDef
+{
+    const sipClassTypeDef *an_ctd;  /* The ancestor. */
+    int an_needs_cast;          /* Set if its address may be different. */
+} sipAncestorDef;
+
+
+
+/*
+ * This defines the data of a generated type that is private to the sip module.
+ */
+typedef struct _sipWrapperTypePrivate
+{
+    sipAncestorDef *wp_ancestors;   /* The flattened table of ancestors. */
+    sipSimpleWrapper *wp_freelist;  /* The released instances. */
+    int wp_nr_free;             /* The number of released instances. */
+    int wp_freelist_size;       /* The maximum number of released instances. */
+} sipWrapperTypePrivate;
+
+/*
+ * The ancestors are only needed for a class that has an instance or a
+ * sub-class, so its type object will already have been created.
+ */
+#define sipClassAncestors(ctd) \
+        (((sipWrapperType *)(ctd)->ctd_base.td_py_type)->wt_private->wp_ancestors)
+
+
 /*
  * Support for the descriptors.
  */
@@ -97,6 +261,8 @@ unsigned long sip_api_long_as_unsigned_long(PyObject *o);
 long long sip_api_long_as_long_long(PyObject *o);
 unsigned long long sip_api_long_as_unsigned_long_long(PyObject *o);
 size_t sip_api_long_as_size_t(PyObject *o);
+void *sip_api_long_as_array(PyObject *o, const char *format,
+        Py_ssize_t *len);
 
 
 extern PyTypeObject sipWrapperType_Type;        /* The wrapper type type. */
@@ -122,6 +288,7 @@ int sip_api_convert_from_slice_object(PyObject *slice, Py_ssize_t length,
         Py_ssize_t *slicelength);
 int sip_api_deprecated(const char *classname, const char *method);
 const sipTypeDef *sip_api_type_scope(const sipTypeDef *td);
+PyTypeObject *sip_api_type_as_py_type_object(const sipTypeDef *td);
 
 
 /*
@@ -146,10 +313,76 @@ sipSimpleWrapper *sipOMFindObject(sipObjectMap *om, void *key,
         const sipTypeDef *td);
 void sipOMAddObject(sipObjectMap *om, sipSimpleWrapper *val);
 int sipOMRemoveObject(sipObjectMap *om, sipSimpleWrapper *val);
+void sipOMVisitWrappers(sipObjectMap *om, sipWrapperVisitorFunc visitor,
+        void *closure);
+void sipOMGetStats(sipObjectMap *om, sipObjectMapStats *stats);
+void sipOMResetStats(sipObjectMap *om);
 
 #define sip_set_bool(p, v)    (*(_Bool *)(p) = (v))
 
 
+/*
+ * The runtime statistics that are counted if SIP_STATS is defined when the
+ * module is built.  Each thread has its own counters so that counting doesn't
+ * need a lock.  If SIP_STATS_TRACEPOINTS is also defined then each count also
+ * fires a "sip:stat" USDT tracepoint whose argument is the statistic.
+ */
+typedef enum {
+    sipStatWraps,               /* C/C++ instances bound to new wrappers. */
+    sipStatUnwraps,             /* C/C++ pointers taken from wrappers. */
+    sipStatReusedWrappers,      /* Wrappers taken from a freelist. */
+    sipStatFailedOverloads,     /* Overloads that didn't accept arguments. */
+    sipStatSubClassConvertors,  /* Calls to sub-class convertors. */
+    sipStatSubClassCacheHits,   /* Sub-class conversions that were cached. */
+    sipStatVirtualCacheHits,    /* Reimplementation lookups that were cached. */
+    sipStatVirtualMROWalks,     /* Reimplementation lookups that were not. */
+    sipStatEnumCacheHits,       /* Enum conversions that were cached. */
+    sipStatEnumCacheMisses,     /* Enum conversions that were not. */
+    sipStatAllocations,         /* All calls to sip_api_malloc(). */
+    sipStatAllocObjectMap,      /* Object map tables allocated. */
+    sipStatAllocAliases,        /* Object map alias slabs allocated. */
+    sipStatAllocKeptReferences, /* Kept reference vectors allocated. */
+    sipStatAllocParseFailures,  /* Recorded parse failures allocated. */
+    sipStatAllocDelayedDtors,   /* Delayed dtor chunks allocated. */
+    sipStatNrStats              /* This must be last. */
+} sipStat;
+
+#if defined(SIP_STATS)
+typedef struct _sipThreadStats {
+    unsigned long counts[sipStatNrStats];   /* The counts. */
+    struct _sipThreadStats *next;   /* The next in the list of all threads. */
+} sipThreadStats;
+
+#if defined(SIP_THREAD_LOCAL)
+extern SIP_THREAD_LOCAL sipThreadStats *sip_thread_stats;
+#else
+extern sipThreadStats *sip_thread_stats;
+#endif
+
+sipThreadStats *sip_stats_new_thread(void);
+
+#if defined(SIP_STATS_TRACEPOINTS)
+#include <sys/sdt.h>
+#define sip_stats_tracepoint(stat)  DTRACE_PROBE1(sip, stat, (int)(stat))
+#else
+#define sip_stats_tracepoint(stat)
+#endif
+
+#define sipStatsInc(stat) \
+    do { \
+        sipThreadStats *ts = sip_thread_stats; \
+        if (ts != NULL || (ts = sip_stats_new_thread()) != NULL) \
+            ++ts->counts[stat]; \
+        sip_stats_tracepoint(stat); \
+    } while (0)
+#else
+#define sipStatsInc(stat)
+#endif
+
+void sip_stats_get(unsigned long *counts);
+void sip_stats_reset(void);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -40,7 +40,34 @@ static PyObject *str_qualname = NULL;           /* 'qualname' */
 static PyObject *str_value = NULL;              /* 'value' */
 
 
+#if !defined(Py_GIL_DISABLED)
+/*
+ * The caches of the mappings between enum members and their C/C++ values.
+ * They are direct-mapped, ie. a new entry simply replaces any existing entry
+ * with the same hash.  An entry holds a reference to the member so that its
+ * identity cannot be reused by another object.
+ */
+#define ENUM_CACHE_SIZE     512
+
+typedef struct {
+    PyObject *member;
+    PyTypeObject *type;
+    int value;
+} sipEnumCacheEntry;
+
+static sipEnumCacheEntry member_cache[ENUM_CACHE_SIZE]; /* Keyed by member. */
+static sipEnumCacheEntry value_cache[ENUM_CACHE_SIZE];  /* Keyed by value. */
+
+#define MEMBER_HASH(m)      (((size_t)(m) >> 4) % ENUM_CACHE_SIZE)
+#define VALUE_HASH(t, v)    ((((size_t)(t) >> 4) ^ ((size_t)(unsigned)(v) * 2654435761U)) % ENUM_CACHE_SIZE)
+#endif
+
+
 /* Forward references. */
+#if !defined(Py_GIL_DISABLED)
+static void cache_member(sipEnumCacheEntry *entry, PyObject *member,
+        int value);
+#endif
 static PyObject *create_enum_object(sipExportedModuleDef *client,
         sipEnumTypeDef *etd, sipIntInstanceDef **next_int_p, PyObject *name);
 static void enum_expected(PyObject *obj, const sipTypeDef *td);
@@ -55,14 +82,44 @@ static PyObject *missing_int_enum(PyObject *cls, PyObject *value);
  */
 PyObject *sip_api_convert_from_enum(int member, const sipTypeDef *td)
 {
-    PyObject *et;
+    PyObject *et, *obj;
+#if !defined(Py_GIL_DISABLED)
+    sipEnumCacheEntry *entry;
+#endif
 
     assert(sipTypeIsEnum(td));
 
-    et = get_enum_type(td);
+    if ((et = get_enum_type(td)) == NULL)
+        return NULL;
+
+#if !defined(Py_GIL_DISABLED)
+    /* See if the member (including any pseudo-member) is cached. */
+    entry = &value_cache[VALUE_HASH(et, member)];
+
+    if (entry->member != NULL && entry->type == (PyTypeObject *)et && entry->value == member)
+    {
+        sipStatsInc(sipStatEnumCacheHits);
+
+        Py_INCREF(entry->member);
+        return entry->member;
+    }
 
-    return PyObject_CallFunction(et,
+    sipStatsInc(sipStatEnumCacheMisses);
+#endif
+
+    obj = PyObject_CallFunction(et,
             IS_UNSIGNED_ENUM((sipEnumTypeDef *)td) ? "(I)" : "(i)", member);
+
+#if !defined(Py_GIL_DISABLED)
+    /*
+     * Enum members (and the pseudo-members of flags and of missing values) are
+     * singletons so the result can be reused.
+     */
+    if (obj != NULL && Py_TYPE(obj) == (PyTypeObject *)et)
+        cache_member(entry, obj, member);
+#endif
+
+    return obj;
 }
 
 
@@ -78,10 +135,29 @@ int sip_api_convert_to_enum(PyObject *obj, const sipTypeDef *td)
     assert(sipTypeIsEnum(td));
 
     /* Make sure the enum object has been created. */
-    type_obj = get_enum_type(td);
+    if ((type_obj = get_enum_type(td)) == NULL)
+        return -1;
+
+    /*
+     * Check the type of the Python object.  An enum with members cannot be
+     * sub-classed so a member will always have the exact type.
+     */
+    if (Py_TYPE(obj) == (PyTypeObject *)type_obj)
+    {
+#if !defined(Py_GIL_DISABLED)
+        /* See if the value of the member is cached. */
+        sipEnumCacheEntry *entry = &member_cache[MEMBER_HASH(obj)];
+
+        if (entry->member == obj)
+        {
+            sipStatsInc(sipStatEnumCacheHits);
+            return entry->value;
+        }
 
-    /* Check the type of the Python object. */
-    if (PyObject_IsInstance(obj, type_obj) <= 0)
+        sipStatsInc(sipStatEnumCacheMisses);
+#endif
+    }
+    else if (PyObject_IsInstance(obj, type_obj) <= 0)
     {
         enum_expected(obj, td);
         return -1;
@@ -99,6 +175,11 @@ int sip_api_convert_to_enum(PyObject *obj, const sipTypeDef *td)
 
     Py_DECREF(val_obj);
 
+#if !defined(Py_GIL_DISABLED)
+    if (!PyErr_Occurred() && Py_TYPE(obj) == (PyTypeObject *)type_obj)
+        cache_member(&member_cache[MEMBER_HASH(obj)], obj, val);
+#endif
+
     return val;
 }
 
@@ -250,6 +331,26 @@ int sip_enum_is_enum(PyObject *obj)
 
 
 
+#if !defined(Py_GIL_DISABLED)
+/*
+ * Save an enum member and its value in a cache entry.
+ */
+static void cache_member(sipEnumCacheEntry *entry, PyObject *member,
+        int value)
+{
+    PyObject *old_member = entry->member;
+
+    Py_INCREF(member);
+    entry->member = member;
+    entry->type = Py_TYPE(member);
+    entry->value = value;
+
+    /* This is done last in case it causes the entry to be re-used. */
+    Py_XDECREF(old_member);
+}
+#endif
+
+
 /*
  * Create an enum object.
  */
@@ -429,10 +530,11 @@ static PyObject *get_enum_type(const sipTypeDef *td)
 {
     PyObject *type_obj;
 
-    /* Make sure the enum object has been created. */
-    type_obj = (PyObject *)sipTypeAsPyTypeObject(td);
-
-    if (type_obj == NULL)
+    /*
+     * Make sure the enum object has been created.  The scope's lazy
+     * attributes are added first as they may include the enum.
+     */
+    if ((type_obj = (PyObject *)td->td_py_type) == NULL)
     {
         if (sip_add_all_lazy_attrs(sip_api_type_scope(td)) < 0)
             return NULL;
@@ -12,14 +12,18 @@
 #include <Python.h>
 
 #include <limits.h>
+#include <string.h>
 
 #include "sip_core.h"
 
 
+static int convert_values(PyObject *seq, char format, void *values);
+static int get_small_long(PyObject *o, Py_ssize_t *value);
 static long long long_as_long_long(PyObject *o, long long min, long long max);
 static unsigned long long_as_unsigned_long(PyObject *o, unsigned long max);
 static void raise_signed_overflow(long long min, long long max);
 static void raise_unsigned_overflow(unsigned long long max);
+static size_t value_size(char format);
 
 
 /*
@@ -163,6 +167,15 @@ long long sip_api_long_as_long_long(PyObject *o)
 unsigned long long sip_api_long_as_unsigned_long_long(PyObject *o)
 {
     unsigned long long value;
+    Py_ssize_t small;
+
+    if (get_small_long(o, &small))
+    {
+        if (small < 0)
+            raise_unsigned_overflow(ULLONG_MAX);
+
+        return (unsigned long long)small;
+    }
 
     PyErr_Clear();
 
@@ -179,6 +192,185 @@ unsigned long long sip_api_long_as_unsigned_long_long(PyObject *o)
 }
 
 
+/*
+ * Convert a sequence of Python objects, or an object that implements the
+ * buffer protocol, to a newly allocated C array of integers.  The format of an
+ * element is as defined by the struct module, ie. one of "bBhHiIlLqQ".  The
+ * array should be freed using sip_api_free().
+ */
+void *sip_api_long_as_array(PyObject *o, const char *format,
+        Py_ssize_t *len)
+{
+    size_t size;
+    void *values;
+    PyObject *seq;
+
+    if ((size = value_size(*format)) == 0)
+    {
+        PyErr_Format(PyExc_ValueError, "'%c' is not a supported format",
+                *format);
+        return NULL;
+    }
+
+    /* A buffer with exactly the same layout is simply copied. */
+    if (PyObject_CheckBuffer(o))
+    {
+        Py_buffer view;
+        const char *view_format;
+
+        if (PyObject_GetBuffer(o, &view, PyBUF_FORMAT) < 0)
+        {
+            PyErr_Clear();
+        }
+        else
+        {
+            if ((view_format = view.format) == NULL)
+                view_format = "B";
+            else if (*view_format == '@')
+                ++view_format;
+
+            if (view_format[0] == *format && view_format[1] == '\0' && (size_t)view.itemsize == size)
+            {
+                *len = view.len / view.itemsize;
+
+                if ((values = sip_api_malloc(view.len > 0 ? view.len : 1)) != NULL)
+                    memcpy(values, view.buf, view.len);
+
+                PyBuffer_Release(&view);
+
+                return values;
+            }
+
+            PyBuffer_Release(&view);
+        }
+    }
+
+    if ((seq = PySequence_Fast(o, "a sequence of integers is expected")) == NULL)
+        return NULL;
+
+    *len = PySequence_Fast_GET_SIZE(seq);
+
+    if ((values = sip_api_malloc(*len > 0 ? *len * size : 1)) != NULL)
+    {
+        if (convert_values(seq, *format, values) < 0)
+        {
+            sip_api_free(values);
+            values = NULL;
+        }
+    }
+
+    Py_DECREF(seq);
+
+    return values;
+}
+
+
+/*
+ * Convert the items of a fast sequence to a C array of integers.
+ */
+#define CONVERT_VALUES(type, convertor) \
+    { \
+        type *vp = (type *)values; \
+        for (i = 0; i < len; ++i) \
+        { \
+            vp[i] = convertor(items[i]); \
+            if (PyErr_Occurred()) \
+                return -1; \
+        } \
+    }
+
+static int convert_values(PyObject *seq, char format, void *values)
+{
+    PyObject **items = PySequence_Fast_ITEMS(seq);
+    Py_ssize_t i, len = PySequence_Fast_GET_SIZE(seq);
+
+    PyErr_Clear();
+
+    switch (format)
+    {
+    case 'b': CONVERT_VALUES(signed char, sip_api_long_as_signed_char); break;
+    case 'B': CONVERT_VALUES(unsigned char, sip_api_long_as_unsigned_char); break;
+    case 'h': CONVERT_VALUES(short, sip_api_long_as_short); break;
+    case 'H': CONVERT_VALUES(unsigned short, sip_api_long_as_unsigned_short); break;
+    case 'i': CONVERT_VALUES(int, sip_api_long_as_int); break;
+    case 'I': CONVERT_VALUES(unsigned int, sip_api_long_as_unsigned_int); break;
+    case 'l': CONVERT_VALUES(long, sip_api_long_as_long); break;
+    case 'L': CONVERT_VALUES(unsigned long, sip_api_long_as_unsigned_long); break;
+    case 'q': CONVERT_VALUES(long long, sip_api_long_as_long_long); break;
+    case 'Q': CONVERT_VALUES(unsigned long long, sip_api_long_as_unsigned_long_long); break;
+    }
+
+    return 0;
+}
+
+#undef CONVERT_VALUES
+
+
+/*
+ * Get the value of a Python int that is small enough to be read directly
+ * without calling the generic convertors and without touching the error
+ * state.  FALSE is returned if a generic convertor must be used.
+ */
+static int get_small_long(PyObject *o, Py_ssize_t *value)
+{
+#if PY_VERSION_HEX >= 0x030c0000
+    if (PyLong_Check(o) && PyUnstable_Long_IsCompact((PyLongObject *)o))
+    {
+        *value = PyUnstable_Long_CompactValue((PyLongObject *)o);
+        return TRUE;
+    }
+#else
+    (void)o;
+    (void)value;
+#endif
+
+    return FALSE;
+}
+
+
+/*
+ * Return the size of an integer element of a C array or 0 if the format isn't
+ * supported.
+ */
+static size_t value_size(char format)
+{
+    switch (format)
+    {
+    case 'b':
+        return sizeof (signed char);
+
+    case 'B':
+        return sizeof (unsigned char);
+
+    case 'h':
+        return sizeof (short);
+
+    case 'H':
+        return sizeof (unsigned short);
+
+    case 'i':
+        return sizeof (int);
+
+    case 'I':
+        return sizeof (unsigned int);
+
+    case 'l':
+        return sizeof (long);
+
+    case 'L':
+        return sizeof (unsigned long);
+
+    case 'q':
+        return sizeof (long long);
+
+    case 'Q':
+        return sizeof (unsigned long long);
+    }
+
+    return 0;
+}
+
+
 /*
  * Convert a Python object to a long long checking that the value is within a
  * range if overflow checking is enabled.
@@ -186,6 +378,15 @@ unsigned long long sip_api_long_as_unsigned_long_long(PyObject *o)
 static long long long_as_long_long(PyObject *o, long long min, long long max)
 {
     long long value;
+    Py_ssize_t small;
+
+    if (get_small_long(o, &small))
+    {
+        if (small < min || small > max)
+            raise_signed_overflow(min, max);
+
+        return small;
+    }
 
     PyErr_Clear();
 
@@ -213,6 +414,15 @@ static long long long_as_long_long(PyObject *o, long long min, long long max)
 static unsigned long long_as_unsigned_long(PyObject *o, unsigned long max)
 {
     unsigned long value;
+    Py_ssize_t small;
+
+    if (get_small_long(o, &small))
+    {
+        if (small < 0 || (size_t)small > max)
+            raise_unsigned_overflow(max);
+
+        return (unsigned long)small;
+    }
 
     PyErr_Clear();
 
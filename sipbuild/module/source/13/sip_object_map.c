@@ -4,6 +4,19 @@
  * This module implements a hash table class for mapping C/C++ addresses to the
  * corresponding wrapped Python object.
  *
+ * By default the hash table sizes are powers of 2 and linear probing is used.
+ * The keys are kept in a separate array from the values so that probing only
+ * touches the keys.  A table is resized incrementally, ie. while a resize is
+ * in progress the entries of the previous table are migrated a few at a time
+ * each time an entry is added.  If SIP_PRIME_OBJECT_MAP is defined then the
+ * hash table sizes are prime numbers and double hashing is used.  In this case
+ * a table is resized all at once.
+ *
+ * When there is no GIL a map is split into a number of shards, each of which
+ * has its own lock and is chosen using the most significant bits of the hash
+ * of the C/C++ address.  Without free-threading there is a single shard and no
+ * locking.
+ *
  * Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
  */
 
@@ -14,6 +27,45 @@
 #include "sip_core.h"
 
 
+/*
+ * When there is no GIL each shard of a map has its own lock.
+ */
+#if defined(Py_GIL_DISABLED)
+#define lock_shard(s)       PyMutex_Lock(&(s)->mutex)
+#define unlock_shard(s)     PyMutex_Unlock(&(s)->mutex)
+#else
+#define lock_shard(s)
+#define unlock_shard(s)
+#endif
+
+
+/*
+ * Take a strong reference to a wrapper found in a map while its shard is
+ * locked.  When there is no GIL another thread may be releasing the last
+ * reference so the increment must fail if the count has already reached 0.
+ */
+#if defined(Py_GIL_DISABLED) && PY_VERSION_HEX >= 0x030e0000
+#define enable_try_incref(o)    PyUnstable_EnableTryIncRef((PyObject *)(o))
+#define try_incref(o)           PyUnstable_TryIncRef((PyObject *)(o))
+#else
+#define enable_try_incref(o)
+#define try_incref(o)           (Py_INCREF(o), 1)
+#endif
+
+
+/*
+ * An entry in the list of wrappers at an address is either a wrapper or a
+ * tagged pointer to an alias.
+ */
+#define is_alias(sw)        ((uintptr_t)(sw) & 1)
+#define as_alias(sw)        ((sipAlias *)((uintptr_t)(sw) & ~(uintptr_t)1))
+#define tag_alias(a)        ((sipSimpleWrapper *)((uintptr_t)(a) | 1))
+#define next_wrapper(sw)    (is_alias(sw) ? as_alias(sw)->next : (sw)->next)
+#define unaliased(sw)       (is_alias(sw) ? as_alias(sw)->u.wrapper : (sw))
+
+
+#if defined(SIP_PRIME_OBJECT_MAP)
+
 #define hash_1(k,s) (((uintptr_t)(k)) % (s))
 #define hash_2(k,s) ((s) - 2 - (hash_1((k),(s)) % ((s) - 2)))
 
@@ -29,35 +81,73 @@ static uintptr_t hash_primes[] = {
 
 
 static sipHashEntry *newHashTable(uintptr_t);
-static sipHashEntry *findHashEntry(sipObjectMap *,void *);
-static void add_object(sipObjectMap *om, void *addr, sipSimpleWrapper *val);
+static sipHashEntry *findHashEntry(sipObjectMapShard *,void *);
+static void reorganiseMap(sipObjectMapShard *oms);
+
+#else
+
+#define INITIAL_SIZE    512     /* The initial size of a hash table. */
+#define MIGRATE_STEP    8       /* The nr. of slots migrated at a time. */
+
+
+static int new_table(sipHashTable *tab, uintptr_t size);
+static void free_table(sipHashTable *tab);
+static uintptr_t probe_table(sipObjectMapShard *oms, const sipHashTable *tab,
+        void *key);
+static int resize_map(sipObjectMapShard *oms);
+static void migrate_slots(sipObjectMapShard *oms, uintptr_t nr_slots);
+
+#endif
+
+static void init_shard(sipObjectMapShard *oms);
+static void finalise_shard(sipObjectMapShard *oms);
+static void visit_shard(sipObjectMapShard *oms, sipWrapperVisitorFunc visitor,
+        void *closure);
+static void add_shard_stats(sipObjectMapShard *oms, sipObjectMapStats *stats);
+#if !defined(SIP_PRIME_OBJECT_MAP) || SIP_OM_NR_SHARDS > 1
+static uintptr_t hash_address(void *key);
+#endif
+static sipObjectMapShard *get_shard(sipObjectMap *om, void *key);
+static void init_stats(sipObjectMapShard *oms);
+static void update_stats(sipObjectMapShard *oms, unsigned long nr_probes);
+static sipSimpleWrapper **find_bucket(sipObjectMapShard *oms, void *key);
+static sipSimpleWrapper **add_bucket(sipObjectMapShard *oms, void *key);
+static void bucket_emptied(sipObjectMapShard *oms, sipSimpleWrapper **bucket);
+static void add_object(sipObjectMap *om, void *addr, sipSimpleWrapper *val,
+        int alias);
 static void add_aliases(sipObjectMap *om, void *addr, sipSimpleWrapper *val,
-        const sipClassTypeDef *base_ctd, const sipClassTypeDef *ctd);
+        const sipClassTypeDef *base_ctd);
+static sipAlias *new_alias(sipObjectMapShard *oms, sipSimpleWrapper *val);
+static void free_alias(sipObjectMapShard *oms, sipAlias *alias);
+static void free_alias_pool(sipObjectMapShard *oms);
 static int remove_object(sipObjectMap *om, void *addr, sipSimpleWrapper *val);
 static void remove_aliases(sipObjectMap *om, void *addr, sipSimpleWrapper *val,
-        const sipClassTypeDef *base_ctd, const sipClassTypeDef *ctd);
-static void reorganiseMap(sipObjectMap *om);
+        const sipClassTypeDef *base_ctd);
 static void *getUnguardedPointer(sipSimpleWrapper *w);
 
 
+#if defined(SIP_PRIME_OBJECT_MAP)
+
 /*
- * Initialise an object map.
+ * Initialise a shard of an object map.
  */
-void sipOMInit(sipObjectMap *om)
+static void init_shard(sipObjectMapShard *oms)
 {
-    om -> primeIdx = 0;
-    om -> unused = om -> size = hash_primes[om -> primeIdx];
-    om -> stale = 0;
-    om -> hash_array = newHashTable(om -> size);
+    oms -> primeIdx = 0;
+    oms -> unused = oms -> size = hash_primes[oms -> primeIdx];
+    oms -> stale = 0;
+    oms -> hash_array = newHashTable(oms -> size);
+
+    init_stats(oms);
 }
 
 
 /*
- * Finalise an object map.
+ * Finalise a shard of an object map.
  */
-void sipOMFinalise(sipObjectMap *om)
+static void finalise_shard(sipObjectMapShard *oms)
 {
-    sip_api_free(om -> hash_array);
+    sip_api_free(oms -> hash_array);
 }
 
 
@@ -71,6 +161,8 @@ static sipHashEntry *newHashTable(uintptr_t size)
 
     nbytes = sizeof (sipHashEntry) * size;
 
+    sipStatsInc(sipStatAllocObjectMap);
+
     if ((hashtab = (sipHashEntry *)sip_api_malloc(nbytes)) != NULL)
         memset(hashtab,0,nbytes);
 
@@ -82,38 +174,701 @@ static sipHashEntry *newHashTable(uintptr_t size)
  * Return a pointer to the hash entry that is used, or should be used, for the
  * given C/C++ address.
  */
-static sipHashEntry *findHashEntry(sipObjectMap *om,void *key)
+static sipHashEntry *findHashEntry(sipObjectMapShard *oms,void *key)
 {
     uintptr_t hash, inc;
+    unsigned long nr_probes = 1;
     void *hek;
 
-    hash = hash_1(key,om -> size);
-    inc = hash_2(key,om -> size);
+    hash = hash_1(key,oms -> size);
+    inc = hash_2(key,oms -> size);
+
+    while ((hek = oms -> hash_array[hash].key) != NULL && hek != key)
+    {
+        hash = (hash + inc) % oms -> size;
+        ++nr_probes;
+    }
+
+    update_stats(oms, nr_probes);
+
+    return &oms -> hash_array[hash];
+}
+
+
+/*
+ * Return the list of wrappers for a C/C++ address or NULL if there isn't one.
+ */
+static sipSimpleWrapper **find_bucket(sipObjectMapShard *oms, void *key)
+{
+    sipHashEntry *he = findHashEntry(oms, key);
+
+    return (he->key != NULL ? &he->first : NULL);
+}
+
+
+/*
+ * Return the list of wrappers for a C/C++ address, creating it if necessary.
+ * NULL is returned if there was no memory.
+ */
+static sipSimpleWrapper **add_bucket(sipObjectMapShard *oms, void *key)
+{
+    sipHashEntry *he = findHashEntry(oms, key);
+
+    if (he->first == NULL)
+    {
+        /* See if the bucket was unused or stale. */
+        if (he->key == NULL)
+        {
+            /* Make sure there will still be space after this one. */
+            reorganiseMap(oms);
+            he = findHashEntry(oms, key);
+
+            he->key = key;
+            oms->unused--;
+        }
+        else
+        {
+            oms->stale--;
+        }
+    }
+
+    return &he->first;
+}
+
+
+/*
+ * Note that the list of wrappers for a C/C++ address is now empty.
+ */
+static void bucket_emptied(sipObjectMapShard *oms, sipSimpleWrapper **bucket)
+{
+    (void)bucket;
+
+    /*
+     * Note that we do not NULL the key and count it as unused because that
+     * might throw out the search for another entry that wanted to go here,
+     * found it already occupied, and was put somewhere else.  In other words,
+     * searches must be repeatable until we reorganise the table.
+     */
+    oms->stale++;
+}
+
+
+/*
+ * Reorganise a map if it is running short of space.
+ */
+static void reorganiseMap(sipObjectMapShard *oms)
+{
+    uintptr_t old_size, i;
+    sipHashEntry *ohe, *old_tab;
+
+    /* Don't bother if it still has more than 12% available. */
+    if (oms -> unused > oms -> size >> 3)
+        return;
+
+    /*
+     * If reorganising (ie. making the stale buckets unused) using the same
+     * sized table would make 25% available then do that.  Otherwise use a
+     * bigger table (if possible).
+     */
+    if (oms -> unused + oms -> stale < oms -> size >> 2 && hash_primes[oms -> primeIdx + 1] != 0)
+        oms -> primeIdx++;
+
+    ++oms->nr_resizes;
+
+    old_size = oms -> size;
+    old_tab = oms -> hash_array;
+
+    oms -> unused = oms -> size = hash_primes[oms -> primeIdx];
+    oms -> stale = 0;
+    oms -> hash_array = newHashTable(oms -> size);
+
+    /* Transfer the entries from the old table to the new one. */
+    ohe = old_tab;
+
+    for (i = 0; i < old_size; ++i)
+    {
+        if (ohe -> key != NULL && ohe -> first != NULL)
+        {
+            *findHashEntry(oms,ohe -> key) = *ohe;
+            oms -> unused--;
+        }
+
+        ++ohe;
+    }
+
+    sip_api_free(old_tab);
+}
+
+
+/*
+ * Call a visitor function for every wrapper in a shard of a map.
+ */
+static void visit_shard(sipObjectMapShard *oms, sipWrapperVisitorFunc visitor,
+        void *closure)
+{
+    const sipHashEntry *he;
+    uintptr_t i;
+
+    for (he = oms->hash_array, i = 0; i < oms->size; ++i, ++he)
+    {
+        if (he->key != NULL)
+        {
+            sipSimpleWrapper *sw;
+
+            for (sw = he->first; sw != NULL; sw = next_wrapper(sw))
+                if (!is_alias(sw))
+                    visitor(sw, closure);
+        }
+    }
+}
+
+
+/*
+ * Add the statistics about a shard of a map.
+ */
+static void add_shard_stats(sipObjectMapShard *oms, sipObjectMapStats *stats)
+{
+    stats->implementation = "prime";
+    stats->size += oms->size;
+    stats->nr_entries += oms->size - oms->unused - oms->stale;
+    stats->nr_stale += oms->stale;
+}
+
+#else
+
+/*
+ * Initialise a shard of an object map.
+ */
+static void init_shard(sipObjectMapShard *oms)
+{
+    new_table(&oms->current, INITIAL_SIZE);
+
+    /* There is no resize in progress. */
+    oms->previous.size = 0;
+    oms->previous.keys = NULL;
+    oms->previous.firsts = NULL;
+    oms->migrated = 0;
+
+    init_stats(oms);
+}
+
+
+/*
+ * Finalise a shard of an object map.
+ */
+static void finalise_shard(sipObjectMapShard *oms)
+{
+    free_table(&oms->current);
+    free_table(&oms->previous);
+}
+
+
+/*
+ * Allocate and initialise a new hash table.  Return 0 if there was no error.
+ */
+static int new_table(sipHashTable *tab, uintptr_t size)
+{
+    void **keys;
+    sipSimpleWrapper **firsts;
+
+    sipStatsInc(sipStatAllocObjectMap);
+
+    if ((keys = sip_api_malloc(sizeof (void *) * size)) == NULL)
+        return -1;
+
+    if ((firsts = sip_api_malloc(sizeof (sipSimpleWrapper *) * size)) == NULL)
+    {
+        sip_api_free(keys);
+        return -1;
+    }
+
+    memset(keys, 0, sizeof (void *) * size);
+    memset(firsts, 0, sizeof (sipSimpleWrapper *) * size);
+
+    tab->size = tab->unused = size;
+    tab->stale = 0;
+    tab->keys = keys;
+    tab->firsts = firsts;
+
+    return 0;
+}
+
+
+/*
+ * Free the memory used by a hash table.
+ */
+static void free_table(sipHashTable *tab)
+{
+    if (tab->keys != NULL)
+    {
+        sip_api_free(tab->keys);
+        sip_api_free(tab->firsts);
+
+        tab->size = 0;
+        tab->keys = NULL;
+        tab->firsts = NULL;
+    }
+}
+
+
+/*
+ * Return the index of the slot of a table that is used, or should be used, for
+ * the given C/C++ address.
+ */
+static uintptr_t probe_table(sipObjectMapShard *oms, const sipHashTable *tab,
+        void *key)
+{
+    uintptr_t mask = tab->size - 1;
+    uintptr_t idx = hash_address(key) & mask;
+    unsigned long nr_probes = 1;
+    void *k;
+
+    while ((k = tab->keys[idx]) != NULL && k != key)
+    {
+        idx = (idx + 1) & mask;
+        ++nr_probes;
+    }
+
+    update_stats(oms, nr_probes);
+
+    return idx;
+}
+
+
+/*
+ * Return the list of wrappers for a C/C++ address or NULL if there isn't one.
+ */
+static sipSimpleWrapper **find_bucket(sipObjectMapShard *oms, void *key)
+{
+    uintptr_t idx;
+
+    idx = probe_table(oms, &oms->current, key);
+
+    if (oms->current.keys[idx] != NULL)
+        return &oms->current.firsts[idx];
+
+    /* It may not have been migrated yet. */
+    if (oms->previous.keys != NULL)
+    {
+        idx = probe_table(oms, &oms->previous, key);
+
+        if (oms->previous.keys[idx] != NULL)
+            return &oms->previous.firsts[idx];
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Return the list of wrappers for a C/C++ address, creating it if necessary.
+ * NULL is returned if there was no memory.
+ */
+static sipSimpleWrapper **add_bucket(sipObjectMapShard *oms, void *key)
+{
+    sipHashTable *tab = &oms->current;
+    uintptr_t idx;
+
+    /* Continue any resize that is in progress. */
+    if (oms->previous.keys != NULL)
+        migrate_slots(oms, MIGRATE_STEP);
+
+    idx = probe_table(oms, tab, key);
+
+    if (tab->keys[idx] == NULL)
+    {
+        sipSimpleWrapper *first = NULL;
+
+        /* Make sure there will still be space after this one. */
+        if (tab->unused <= tab->size >> 2)
+        {
+            if (resize_map(oms) < 0 && tab->unused <= 1)
+                return NULL;
+
+            idx = probe_table(oms, tab, key);
+        }
+
+        /* If there is a resize in progress then migrate any existing entry. */
+        if (oms->previous.keys != NULL)
+        {
+            uintptr_t prev_idx = probe_table(oms, &oms->previous, key);
+
+            if (oms->previous.keys[prev_idx] != NULL)
+            {
+                first = oms->previous.firsts[prev_idx];
+                oms->previous.firsts[prev_idx] = NULL;
+            }
+        }
+
+        tab->keys[idx] = key;
+        tab->firsts[idx] = first;
+        tab->unused--;
+    }
+    else if (tab->firsts[idx] == NULL)
+    {
+        /* The bucket was stale. */
+        tab->stale--;
+    }
+
+    return &tab->firsts[idx];
+}
+
+
+/*
+ * Note that the list of wrappers for a C/C++ address is now empty.
+ */
+static void bucket_emptied(sipObjectMapShard *oms, sipSimpleWrapper **bucket)
+{
+    sipHashTable *tab = &oms->current;
+
+    /*
+     * Note that we do not NULL the key and count it as unused because that
+     * might throw out the search for another entry that wanted to go here,
+     * found it already occupied, and was put somewhere else.  In other words,
+     * searches must be repeatable until we resize the table.  Stale entries in
+     * the previous table are simply not migrated.
+     */
+    if (bucket >= tab->firsts && bucket < tab->firsts + tab->size)
+        tab->stale++;
+}
+
+
+/*
+ * Start to resize a map that is running short of space.  Return 0 if there
+ * was no error.
+ */
+static int resize_map(sipObjectMapShard *oms)
+{
+    sipHashTable *tab = &oms->current;
+    uintptr_t size = tab->size;
+
+    /* Finish any resize that is already in progress. */
+    if (oms->previous.keys != NULL)
+        migrate_slots(oms, oms->previous.size);
+
+    /*
+     * If resizing (ie. making the stale buckets unused) using the same sized
+     * table would make 50% available then do that.  Otherwise use a bigger
+     * table.
+     */
+    if (tab->unused + tab->stale < size >> 1)
+        size <<= 1;
+
+    ++oms->nr_resizes;
+
+    oms->previous = *tab;
+    oms->migrated = 0;
+
+    if (new_table(tab, size) < 0)
+    {
+        *tab = oms->previous;
+        oms->previous.keys = NULL;
+        oms->previous.firsts = NULL;
+
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Migrate a number of slots from the previous table to the current one.
+ */
+static void migrate_slots(sipObjectMapShard *oms, uintptr_t nr_slots)
+{
+    sipHashTable *prev = &oms->previous, *tab = &oms->current;
+
+    while (nr_slots-- != 0 && oms->migrated < prev->size)
+    {
+        uintptr_t i = oms->migrated++;
+
+        if (prev->keys[i] != NULL && prev->firsts[i] != NULL)
+        {
+            uintptr_t idx = probe_table(oms, tab, prev->keys[i]);
+
+            tab->keys[idx] = prev->keys[i];
+            tab->firsts[idx] = prev->firsts[i];
+            tab->unused--;
+        }
+    }
+
+    /* See if the migration is complete. */
+    if (oms->migrated == prev->size)
+        free_table(prev);
+}
+
 
-    while ((hek = om -> hash_array[hash].key) != NULL && hek != key)
-        hash = (hash + inc) % om -> size;
+/*
+ * Call a visitor function for every wrapper in a shard of a map.
+ */
+static void visit_shard(sipObjectMapShard *oms, sipWrapperVisitorFunc visitor,
+        void *closure)
+{
+    const sipHashTable *tabs[2];
+    int t;
+
+    tabs[0] = &oms->current;
+    tabs[1] = &oms->previous;
+
+    for (t = 0; t < 2; ++t)
+    {
+        const sipHashTable *tab = tabs[t];
+        uintptr_t i;
+
+        if (tab->keys == NULL)
+            continue;
 
-    return &om -> hash_array[hash];
+        for (i = 0; i < tab->size; ++i)
+        {
+            sipSimpleWrapper *sw;
+
+            for (sw = tab->firsts[i]; sw != NULL; sw = next_wrapper(sw))
+                if (!is_alias(sw))
+                    visitor(sw, closure);
+        }
+    }
 }
 
 
 /*
- * Return the wrapped Python object of a specific type for a C/C++ address or
- * NULL if it wasn't found.
+ * Add the statistics about a shard of a map.
+ */
+static void add_shard_stats(sipObjectMapShard *oms, sipObjectMapStats *stats)
+{
+    const sipHashTable *tab = &oms->current;
+
+    stats->implementation = "power-of-2";
+    stats->size += tab->size;
+    stats->nr_entries += tab->size - tab->unused - tab->stale;
+    stats->nr_stale += tab->stale;
+
+    /* Include the entries that haven't been migrated yet. */
+    if (oms->previous.keys != NULL)
+    {
+        uintptr_t i;
+
+        stats->resizing = TRUE;
+        stats->size += oms->previous.size;
+
+        for (i = oms->migrated; i < oms->previous.size; ++i)
+            if (oms->previous.firsts[i] != NULL)
+                ++stats->nr_entries;
+    }
+}
+
+#endif
+
+
+/*
+ * Initialise an object map.
+ */
+void sipOMInit(sipObjectMap *om)
+{
+    int i;
+
+    for (i = 0; i < SIP_OM_NR_SHARDS; ++i)
+    {
+        sipObjectMapShard *oms = &om->shards[i];
+
+#if defined(Py_GIL_DISABLED)
+        memset(&oms->mutex, 0, sizeof (PyMutex));
+#endif
+
+        init_shard(oms);
+
+        oms->alias_slabs = NULL;
+        oms->alias_slab_used = 0;
+        oms->free_aliases = NULL;
+        oms->nr_aliases = 0;
+    }
+}
+
+
+/*
+ * Finalise an object map.
+ */
+void sipOMFinalise(sipObjectMap *om)
+{
+    int i;
+
+    for (i = 0; i < SIP_OM_NR_SHARDS; ++i)
+    {
+        finalise_shard(&om->shards[i]);
+        free_alias_pool(&om->shards[i]);
+    }
+}
+
+
+/*
+ * Call a visitor function for every wrapper in a map.  Note that the visitor
+ * must not add wrappers to, or remove wrappers from, the map.
+ */
+void sipOMVisitWrappers(sipObjectMap *om, sipWrapperVisitorFunc visitor,
+        void *closure)
+{
+    int i;
+
+    for (i = 0; i < SIP_OM_NR_SHARDS; ++i)
+    {
+        sipObjectMapShard *oms = &om->shards[i];
+
+        lock_shard(oms);
+        visit_shard(oms, visitor, closure);
+        unlock_shard(oms);
+    }
+}
+
+
+/*
+ * Get the statistics about a map.
+ */
+void sipOMGetStats(sipObjectMap *om, sipObjectMapStats *stats)
+{
+    int i;
+
+    stats->size = 0;
+    stats->nr_entries = 0;
+    stats->nr_stale = 0;
+    stats->nr_lookups = 0;
+    stats->nr_probes = 0;
+    stats->max_probes = 0;
+    stats->nr_resizes = 0;
+    stats->resizing = FALSE;
+    stats->nr_shards = SIP_OM_NR_SHARDS;
+    stats->nr_aliases = 0;
+
+    for (i = 0; i < SIP_OM_NR_SHARDS; ++i)
+    {
+        sipObjectMapShard *oms = &om->shards[i];
+
+        lock_shard(oms);
+
+        add_shard_stats(oms, stats);
+
+        stats->nr_lookups += oms->nr_lookups;
+        stats->nr_probes += oms->nr_probes;
+        stats->nr_resizes += oms->nr_resizes;
+        stats->nr_aliases += oms->nr_aliases;
+
+        if (stats->max_probes < oms->max_probes)
+            stats->max_probes = oms->max_probes;
+
+        unlock_shard(oms);
+    }
+}
+
+
+/*
+ * Reset the statistics about the searches and resizes of a map.
+ */
+void sipOMResetStats(sipObjectMap *om)
+{
+    int i;
+
+    for (i = 0; i < SIP_OM_NR_SHARDS; ++i)
+    {
+        sipObjectMapShard *oms = &om->shards[i];
+
+        lock_shard(oms);
+        init_stats(oms);
+        unlock_shard(oms);
+    }
+}
+
+
+#if !defined(SIP_PRIME_OBJECT_MAP) || SIP_OM_NR_SHARDS > 1
+/*
+ * Return the hash of a C/C++ address.  It is used to choose the slot of a
+ * power-of-2 table and the shard of a map.  The bits of the address are mixed
+ * so that the low order bits (which are usually zero because of alignment)
+ * don't all end up in the same part of the table.
+ */
+static uintptr_t hash_address(void *key)
+{
+    uintptr_t hash = (uintptr_t)key;
+
+#if UINTPTR_MAX > 0xffffffffU
+    hash ^= hash >> 33;
+    hash *= (uintptr_t)0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+#else
+    hash ^= hash >> 16;
+    hash *= (uintptr_t)0x45d9f3bU;
+    hash ^= hash >> 16;
+#endif
+
+    return hash;
+}
+#endif
+
+
+/*
+ * Return the shard of a map that contains a C/C++ address.  The most
+ * significant bits of the hash are used as the least significant bits are
+ * used to choose the slot within the shard.
+ */
+static sipObjectMapShard *get_shard(sipObjectMap *om, void *key)
+{
+#if SIP_OM_NR_SHARDS > 1
+    uintptr_t hash = hash_address(key);
+
+    return &om->shards[(hash >> (sizeof (uintptr_t) * 8 - SIP_OM_SHARD_BITS)) & (SIP_OM_NR_SHARDS - 1)];
+#else
+    (void)key;
+
+    return &om->shards[0];
+#endif
+}
+
+
+/*
+ * Initialise the statistics of a shard of a map.
+ */
+static void init_stats(sipObjectMapShard *oms)
+{
+    oms->nr_lookups = 0;
+    oms->nr_probes = 0;
+    oms->max_probes = 0;
+    oms->nr_resizes = 0;
+}
+
+
+/*
+ * Update the statistics of a shard of a map after it has been searched.
+ */
+static void update_stats(sipObjectMapShard *oms, unsigned long nr_probes)
+{
+    ++oms->nr_lookups;
+    oms->nr_probes += nr_probes;
+
+    if (oms->max_probes < nr_probes)
+        oms->max_probes = nr_probes;
+}
+
+
+/*
+ * Return a new reference to the wrapped Python object of a specific type for
+ * a C/C++ address or NULL if it wasn't found.
  */
 sipSimpleWrapper *sipOMFindObject(sipObjectMap *om, void *key,
         const sipTypeDef *td)
 {
-    sipHashEntry *he = findHashEntry(om, key);
-    sipSimpleWrapper *sw;
-    PyTypeObject *py_type = sipTypeAsPyTypeObject(td);
+    sipObjectMapShard *oms = get_shard(om, key);
+    sipSimpleWrapper **bucket, *sw, *found = NULL;
 
-    /* Go through each wrapped object at this address. */
-    for (sw = he->first; sw != NULL; sw = sw->next)
+    lock_shard(oms);
+
+    if ((bucket = find_bucket(oms, key)) == NULL)
     {
-        sipSimpleWrapper *unaliased;
+        unlock_shard(oms);
+        return NULL;
+    }
 
-        unaliased = (sipIsAlias(sw) ? (sipSimpleWrapper *)sw->data : sw);
+    /* Go through each wrapped object at this address. */
+    for (sw = *bucket; sw != NULL; sw = next_wrapper(sw))
+    {
+        sipSimpleWrapper *unaliased = unaliased(sw);
 
         /*
          * If the reference count is 0 then it is in the process of being
@@ -133,11 +888,23 @@ sipSimpleWrapper *sipOMFindObject(sipObjectMap *om, void *key,
          * If this wrapped object is of the given type, or a sub-type of it,
          * then we assume it is the same C++ object.
          */
-        if (PyObject_TypeCheck(unaliased, py_type))
-            return unaliased;
+        if (sipTypeCheck(unaliased, td))
+        {
+            /*
+             * The reference must be taken before the shard is unlocked as
+             * that is what stops the wrapper from being deallocated.
+             */
+            if (!try_incref(unaliased))
+                continue;
+
+            found = unaliased;
+            break;
+        }
     }
 
-    return NULL;
+    unlock_shard(oms);
+
+    return found;
 }
 
 
@@ -149,12 +916,15 @@ void sipOMAddObject(sipObjectMap *om, sipSimpleWrapper *val)
     void *addr = getUnguardedPointer(val);
     const sipClassTypeDef *base_ctd;
 
+    /* Allow sipOMFindObject() to take a reference to the object. */
+    enable_try_incref(val);
+
     /* Add the object. */
-    add_object(om, addr, val);
+    add_object(om, addr, val, FALSE);
 
     /* Add any aliases. */
     base_ctd = (const sipClassTypeDef *)((sipWrapperType *)Py_TYPE(val))->wt_td;
-    add_aliases(om, addr, val, base_ctd, base_ctd);
+    add_aliases(om, addr, val, base_ctd);
 }
 
 
@@ -162,72 +932,126 @@ void sipOMAddObject(sipObjectMap *om, sipSimpleWrapper *val)
  * Add an alias for any address that is different when cast to a super-type.
  */
 static void add_aliases(sipObjectMap *om, void *addr, sipSimpleWrapper *val,
-        const sipClassTypeDef *base_ctd, const sipClassTypeDef *ctd)
+        const sipClassTypeDef *base_ctd)
 {
-    const sipEncodedTypeDef *sup;
+    const sipAncestorDef *an;
 
-    /* See if there are any super-classes. */
-    if ((sup = ctd->ctd_supers) != NULL)
+    for (an = sipClassAncestors(base_ctd); an->an_ctd != NULL; ++an)
     {
-        sipClassTypeDef *sup_ctd = sipGetGeneratedClassType(sup, ctd);
-
-        /* Recurse up the hierachy for the first super-class. */
-        add_aliases(om, addr, val, base_ctd, sup_ctd);
+        void *sup_addr;
 
         /*
-         * We only check for aliases for subsequent super-classes because the
-         * first one can never need one.
+         * We only check for aliases for ancestors that may have a different
+         * address.  An ancestor that is the first super-class of another
+         * ancestor shares that ancestor's address and so doesn't need one.
          */
-        while (!sup++->sc_flag)
-        {
-            void *sup_addr;
+        if (!an->an_needs_cast)
+            continue;
 
-            sup_ctd = sipGetGeneratedClassType(sup, ctd);
+        sup_addr = (*base_ctd->ctd_cast)(addr, (sipTypeDef *)an->an_ctd);
 
-            /* Recurse up the hierachy for the remaining super-classes. */
-            add_aliases(om, addr, val, base_ctd, sup_ctd);
+        if (sup_addr != addr)
+            add_object(om, sup_addr, val, TRUE);
+    }
+}
 
-            sup_addr = (*base_ctd->ctd_cast)(addr, (sipTypeDef *)sup_ctd);
 
-            if (sup_addr != addr)
-            {
-                sipSimpleWrapper *alias;
+/*
+ * Return a new alias of a wrapper from the pool of a shard, or NULL if there
+ * was an error.  The shard must be locked.
+ */
+static sipAlias *new_alias(sipObjectMapShard *oms, sipSimpleWrapper *val)
+{
+    sipAlias *alias;
 
-                /* Note that we silently ignore errors. */
-                if ((alias = sip_api_malloc(sizeof (sipSimpleWrapper))) != NULL)
-                {
-                    /*
-                     * An alias is basically a bit-wise copy of the Python
-                     * object but only to ensure the fields we are subverting
-                     * are in the right place.  An alias should never be passed
-                     * to the Python API.
-                     */
-                    *alias = *val;
-
-                    alias->sw_flags = (val->sw_flags & SIP_SHARE_MAP) | SIP_ALIAS;
-                    alias->data = val;
-                    alias->next = NULL;
-
-                    add_object(om, sup_addr, alias);
-                }
-            }
+    if ((alias = oms->free_aliases) != NULL)
+    {
+        oms->free_aliases = alias->u.next_free;
+    }
+    else
+    {
+        /* Allocate a new slab if needed. */
+        if (oms->alias_slabs == NULL || oms->alias_slab_used == SIP_OM_ALIAS_SLAB_SIZE)
+        {
+            sipAliasSlab *slab;
+
+            sipStatsInc(sipStatAllocAliases);
+
+            if ((slab = sip_api_malloc(sizeof (sipAliasSlab))) == NULL)
+                return NULL;
+
+            slab->next = oms->alias_slabs;
+            oms->alias_slabs = slab;
+            oms->alias_slab_used = 0;
         }
+
+        alias = &oms->alias_slabs->aliases[oms->alias_slab_used++];
+    }
+
+    alias->u.wrapper = val;
+    alias->next = NULL;
+
+    ++oms->nr_aliases;
+
+    return alias;
+}
+
+
+/*
+ * Return an alias to the pool of a shard.  The shard must be locked.
+ */
+static void free_alias(sipObjectMapShard *oms, sipAlias *alias)
+{
+    alias->u.next_free = oms->free_aliases;
+    oms->free_aliases = alias;
+
+    --oms->nr_aliases;
+}
+
+
+/*
+ * Free the pool of aliases of a shard.
+ */
+static void free_alias_pool(sipObjectMapShard *oms)
+{
+    while (oms->alias_slabs != NULL)
+    {
+        sipAliasSlab *slab = oms->alias_slabs;
+
+        oms->alias_slabs = slab->next;
+        sip_api_free(slab);
     }
+
+    oms->alias_slab_used = 0;
+    oms->free_aliases = NULL;
+    oms->nr_aliases = 0;
 }
 
 
 /*
- * Add a wrapper (which may be an alias) to the map.
+ * Add a wrapper, or an alias of it, to the map.
  */
-static void add_object(sipObjectMap *om, void *addr, sipSimpleWrapper *val)
+static void add_object(sipObjectMap *om, void *addr, sipSimpleWrapper *val,
+        int alias)
 {
-    sipHashEntry *he = findHashEntry(om, addr);
+    sipObjectMapShard *oms = get_shard(om, addr);
+    sipSimpleWrapper **bucket;
+    sipAlias *new_a;
+
+    lock_shard(oms);
+
+    /* Note that we silently ignore errors. */
+    if ((bucket = add_bucket(oms, addr)) == NULL)
+    {
+        unlock_shard(oms);
+        return;
+    }
 
     /*
      * If the bucket is in use then we appear to have several objects at the
      * same address.
      */
-    if (he->first != NULL)
+    if (*bucket != NULL)
     {
         /*
          * This can happen for three reasons.  A variable of one class can be
@@ -246,100 +1070,80 @@ static void add_object(sipObjectMap *om, void *addr, sipSimpleWrapper *val)
          */
         if (!(val->sw_flags & SIP_SHARE_MAP))
         {
-            sipSimpleWrapper *sw = he->first;
+            sipSimpleWrapper *sw = *bucket, *stale = NULL;
 
-            he->first = NULL;
+            *bucket = NULL;
+            bucket_emptied(oms, bucket);
 
+            /* Free any aliases and keep a list of the wrappers. */
             while (sw != NULL)
             {
-                sipSimpleWrapper *next = sw->next;
+                sipSimpleWrapper *next = next_wrapper(sw);
 
-                if (sipIsAlias(sw))
+                if (is_alias(sw))
                 {
-                    sip_api_free(sw);
+                    free_alias(oms, as_alias(sw));
                 }
                 else
                 {
-                    /*
-                     * We are removing it from the map here.  We first have to
-                     * call the destructor as the destructor itself might end
-                     * up trying to remove the wrapper and its aliases from the
-                     * map.
-                     */
-                    sip_api_instance_destroyed(sw);
+                    sw->next = stale;
+                    stale = sw;
                 }
 
                 sw = next;
             }
-        }
-
-        val->next = he->first;
-        he->first = val;
-
-        return;
-    }
-
-    /* See if the bucket was unused or stale. */
-    if (he->key == NULL)
-    {
-        he->key = addr;
-        om->unused--;
-    }
-    else
-    {
-        om->stale--;
-    }
-
-    /* Add the rest of the new value. */
-    he->first = val;
-    val->next = NULL;
-
-    reorganiseMap(om);
-}
 
+            /* The destructors may need to use the map. */
+            unlock_shard(oms);
 
-/*
- * Reorganise a map if it is running short of space.
- */
-static void reorganiseMap(sipObjectMap *om)
-{
-    uintptr_t old_size, i;
-    sipHashEntry *ohe, *old_tab;
-
-    /* Don't bother if it still has more than 12% available. */
-    if (om -> unused > om -> size >> 3)
-        return;
+            while (stale != NULL)
+            {
+                sipSimpleWrapper *next = stale->next;
 
-    /*
-     * If reorganising (ie. making the stale buckets unused) using the same
-     * sized table would make 25% available then do that.  Otherwise use a
-     * bigger table (if possible).
-     */
-    if (om -> unused + om -> stale < om -> size >> 2 && hash_primes[om -> primeIdx + 1] != 0)
-        om -> primeIdx++;
+                /*
+                 * We are removing it from the map here.  We first have to
+                 * call the destructor as the destructor itself might end up
+                 * trying to remove the wrapper and its aliases from the map.
+                 */
+                sip_api_instance_destroyed(stale);
 
-    old_size = om -> size;
-    old_tab = om -> hash_array;
+                stale = next;
+            }
 
-    om -> unused = om -> size = hash_primes[om -> primeIdx];
-    om -> stale = 0;
-    om -> hash_array = newHashTable(om -> size);
+            lock_shard(oms);
 
-    /* Transfer the entries from the old table to the new one. */
-    ohe = old_tab;
+            /*
+             * The destructors may have added to the map so the bucket may
+             * have moved.
+             */
+            if ((bucket = add_bucket(oms, addr)) == NULL)
+            {
+                unlock_shard(oms);
+                return;
+            }
+        }
+    }
 
-    for (i = 0; i < old_size; ++i)
+    if (alias)
     {
-        if (ohe -> key != NULL && ohe -> first != NULL)
+        /* Note that we silently ignore errors. */
+        if ((new_a = new_alias(oms, val)) != NULL)
         {
-            *findHashEntry(om,ohe -> key) = *ohe;
-            om -> unused--;
+            new_a->next = *bucket;
+            *bucket = tag_alias(new_a);
         }
-
-        ++ohe;
+        else if (*bucket == NULL)
+        {
+            bucket_emptied(oms, bucket);
+        }
+    }
+    else
+    {
+        val->next = *bucket;
+        *bucket = val;
     }
 
-    sip_api_free(old_tab);
+    unlock_shard(oms);
 }
 
 
@@ -352,8 +1156,8 @@ int sipOMRemoveObject(sipObjectMap *om, sipSimpleWrapper *val)
     void *addr;
     const sipClassTypeDef *base_ctd;
 
-    /* Handle the trivial case. */
-    if (sipNotInMap(val))
+    /* Handle the trivial cases. */
+    if (sipNotInMap(val) || sipIsUnmapped(val))
         return 0;
 
     if ((addr = getUnguardedPointer(val)) == NULL)
@@ -361,7 +1165,7 @@ int sipOMRemoveObject(sipObjectMap *om, sipSimpleWrapper *val)
 
     /* Remove any aliases. */
     base_ctd = (const sipClassTypeDef *)((sipWrapperType *)Py_TYPE(val))->wt_td;
-    remove_aliases(om, addr, val, base_ctd, base_ctd);
+    remove_aliases(om, addr, val, base_ctd);
 
     /* Remove the object. */
     return remove_object(om, addr, val);
@@ -372,36 +1176,21 @@ int sipOMRemoveObject(sipObjectMap *om, sipSimpleWrapper *val)
  * Remove an alias for any address that is different when cast to a super-type.
  */
 static void remove_aliases(sipObjectMap *om, void *addr, sipSimpleWrapper *val,
-        const sipClassTypeDef *base_ctd, const sipClassTypeDef *ctd)
+        const sipClassTypeDef *base_ctd)
 {
-    const sipEncodedTypeDef *sup;
+    const sipAncestorDef *an;
 
-    /* See if there are any super-classes. */
-    if ((sup = ctd->ctd_supers) != NULL)
+    for (an = sipClassAncestors(base_ctd); an->an_ctd != NULL; ++an)
     {
-        sipClassTypeDef *sup_ctd = sipGetGeneratedClassType(sup, ctd);
+        void *sup_addr;
 
-        /* Recurse up the hierachy for the first super-class. */
-        remove_aliases(om, addr, val, base_ctd, sup_ctd);
-
-        /*
-         * We only check for aliases for subsequent super-classes because the
-         * first one can never need one.
-         */
-        while (!sup++->sc_flag)
-        {
-            void *sup_addr;
-
-            sup_ctd = sipGetGeneratedClassType(sup, ctd);
-
-            /* Recurse up the hierachy for the remaining super-classes. */
-            remove_aliases(om, addr, val, base_ctd, sup_ctd);
+        if (!an->an_needs_cast)
+            continue;
 
-            sup_addr = (*base_ctd->ctd_cast)(addr, (sipTypeDef *)sup_ctd);
+        sup_addr = (*base_ctd->ctd_cast)(addr, (sipTypeDef *)an->an_ctd);
 
-            if (sup_addr != addr)
-                remove_object(om, sup_addr, val);
-        }
+        if (sup_addr != addr)
+            remove_object(om, sup_addr, val);
     }
 }
 
@@ -411,53 +1200,56 @@ static void remove_aliases(sipObjectMap *om, void *addr, sipSimpleWrapper *val,
  */
 static int remove_object(sipObjectMap *om, void *addr, sipSimpleWrapper *val)
 {
-    sipHashEntry *he = findHashEntry(om, addr);
-    sipSimpleWrapper **swp;
+    sipObjectMapShard *oms = get_shard(om, addr);
+    sipSimpleWrapper **bucket, **swp;
+
+    lock_shard(oms);
 
-    for (swp = &he->first; *swp != NULL; swp = &(*swp)->next)
+    if ((bucket = find_bucket(oms, addr)) == NULL)
     {
-        sipSimpleWrapper *sw, *next;
-        int do_remove;
+        unlock_shard(oms);
+        return -1;
+    }
 
-        sw = *swp;
-        next = sw->next;
+    for (swp = bucket; *swp != NULL; )
+    {
+        sipSimpleWrapper *sw = *swp;
 
-        if (sipIsAlias(sw))
+        if (is_alias(sw))
         {
-            if (sw->data == val)
-            {
-                sip_api_free(sw);
-                do_remove = TRUE;
-            }
-            else
+            sipAlias *alias = as_alias(sw);
+
+            if (alias->u.wrapper != val)
             {
-                do_remove = FALSE;
+                swp = &alias->next;
+                continue;
             }
+
+            *swp = alias->next;
+            free_alias(oms, alias);
         }
         else
         {
-            do_remove = (sw == val);
+            if (sw != val)
+            {
+                swp = &sw->next;
+                continue;
+            }
+
+            *swp = sw->next;
         }
 
-        if (do_remove)
-        {
-            *swp = next;
+        /* If the bucket is now empty then count it as stale. */
+        if (*bucket == NULL)
+            bucket_emptied(oms, bucket);
 
-            /*
-             * If the bucket is now empty then count it as stale.  Note that we
-             * do not NULL the key and count it as unused because that might
-             * throw out the search for another entry that wanted to go here,
-             * found it already occupied, and was put somewhere else.  In other
-             * words, searches must be repeatable until we reorganise the
-             * table.
-             */
-            if (he->first == NULL)
-                om->stale++;
+        unlock_shard(oms);
 
-            return 0;
-        }
+        return 0;
     }
 
+    unlock_shard(oms);
+
     return -1;
 }
 
@@ -0,0 +1,113 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+
+/*
+ * The runtime statistics for the SIP library.  Each thread counts in its own
+ * set of counters and the sets are only combined when the statistics are
+ * asked for.
+ *
+ * Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+ */
+
+
+#include <string.h>
+
+#include "sip_core.h"
+
+
+#if defined(SIP_STATS)
+
+#if defined(Py_GIL_DISABLED)
+static PyMutex stats_mutex;         /* The lock for the list of all threads. */
+#define lock_stats()        PyMutex_Lock(&stats_mutex)
+#define unlock_stats()      PyMutex_Unlock(&stats_mutex)
+#else
+#define lock_stats()
+#define unlock_stats()
+#endif
+
+/*
+ * The counters of the current thread.  Without thread-local variables all
+ * threads share the same counters.
+ */
+#if defined(SIP_THREAD_LOCAL)
+SIP_THREAD_LOCAL sipThreadStats *sip_thread_stats = NULL;
+#else
+sipThreadStats *sip_thread_stats = NULL;
+#endif
+
+/*
+ * The counters of all threads.  They are never freed so that the counts of
+ * threads that have terminated are not lost.
+ */
+static sipThreadStats *all_thread_stats = NULL;
+
+
+/*
+ * Create the counters of the current thread.  NULL is returned if there was no
+ * memory, in which case the count is simply lost.
+ */
+sipThreadStats *sip_stats_new_thread(void)
+{
+    sipThreadStats *ts;
+
+    /* Use the raw allocator as this may be called without an exception. */
+    if ((ts = PyMem_RawCalloc(1, sizeof (sipThreadStats))) == NULL)
+        return NULL;
+
+    lock_stats();
+    ts->next = all_thread_stats;
+    all_thread_stats = ts;
+    unlock_stats();
+
+    sip_thread_stats = ts;
+
+    return ts;
+}
+
+#endif
+
+
+/*
+ * Get the counts, summed over all threads.  They are all zero if the
+ * statistics are not enabled.
+ */
+void sip_stats_get(unsigned long *counts)
+{
+    memset(counts, 0, sizeof (unsigned long) * sipStatNrStats);
+
+#if defined(SIP_STATS)
+    {
+        sipThreadStats *ts;
+
+        lock_stats();
+
+        for (ts = all_thread_stats; ts != NULL; ts = ts->next)
+        {
+            int i;
+
+            for (i = 0; i < sipStatNrStats; ++i)
+                counts[i] += ts->counts[i];
+        }
+
+        unlock_stats();
+    }
+#endif
+}
+
+
+/*
+ * Reset the counts of all threads.
+ */
+void sip_stats_reset(void)
+{
+#if defined(SIP_STATS)
+    sipThreadStats *ts;
+
+    lock_stats();
+
+    for (ts = all_thread_stats; ts != NULL; ts = ts->next)
+        memset(ts->counts, 0, sizeof (ts->counts));
+
+    unlock_stats();
+#endif
+}
@@ -24,21 +24,17 @@ typedef struct _pendingDef {
 
 #ifdef WITH_THREAD
 
-#include <pythread.h>
-
-
 /*
- * The per thread data we need to maintain.
+ * The pending data is held in thread-local storage.  If the compiler supports
+ * it then it is a thread-local variable which is freed automatically when the
+ * thread terminates.  Otherwise it is allocated and the address held using
+ * Python's thread specific storage API.
  */
-typedef struct _threadDef {
-    long thr_ident;                 /* The thread identifier. */
-    pendingDef pending;             /* An object waiting to be wrapped. */
-    struct _threadDef *next;        /* Next in the list. */
-} threadDef;
-
-static threadDef *threads = NULL;   /* Linked list of threads. */
-
-static threadDef *currentThreadDef(int auto_alloc);
+#if defined(SIP_THREAD_LOCAL)
+static SIP_THREAD_LOCAL pendingDef pending;     /* The thread's pending data. */
+#else
+static Py_tss_t pending_key = Py_tss_NEEDS_INIT;    /* The pending data key. */
+#endif
 
 #endif
 
@@ -120,18 +116,19 @@ PyObject *sipWrapInstance(void *cpp, PyTypeObject *py_type, PyObject *args,
 
 
 /*
- * Handle the termination of a thread.
+ * Handle the termination of a thread.  This is only needed if the pending data
+ * had to be allocated as thread-local variables are freed automatically.
  */
 void sip_api_end_thread(void)
 {
-#ifdef WITH_THREAD
-    threadDef *thread;
-    PyGILState_STATE gil = PyGILState_Ensure();
-
-    if ((thread = currentThreadDef(FALSE)) != NULL)
-        thread->thr_ident = 0;
+#if defined(WITH_THREAD) && !defined(SIP_THREAD_LOCAL)
+    pendingDef *pd;
 
-    PyGILState_Release(gil);
+    if (PyThread_tss_is_created(&pending_key) && (pd = PyThread_tss_get(&pending_key)) != NULL)
+    {
+        PyThread_tss_set(&pending_key, NULL);
+        sip_api_free(pd);
+    }
 #endif
 }
 
@@ -142,67 +139,47 @@ void sip_api_end_thread(void)
  */
 static pendingDef *get_pending(int auto_alloc)
 {
-#ifdef WITH_THREAD
-    threadDef *thread;
-
-    if ((thread = currentThreadDef(auto_alloc)) == NULL)
-        return NULL;
-
-    return &thread->pending;
-#else
-    static pendingDef pending;
-
-    return &pending;
-#endif
-}
-
-
-#ifdef WITH_THREAD
-
-/*
- * Return the thread data for the current thread, allocating it if necessary,
- * or NULL if there was an error.
- */
-static threadDef *currentThreadDef(int auto_alloc)
-{
-    threadDef *thread, *empty = NULL;
-    long ident = PyThread_get_thread_ident();
+#if defined(WITH_THREAD) && !defined(SIP_THREAD_LOCAL)
+    pendingDef *pd;
 
-    /* See if we already know about the thread. */
-    for (thread = threads; thread != NULL; thread = thread->next)
+    if (!PyThread_tss_is_created(&pending_key))
     {
-        if (thread->thr_ident == ident)
-            return thread;
-
-        if (thread->thr_ident == 0)
-            empty = thread;
+        if (!auto_alloc)
+        {
+            /* This is not an error. */
+            return NULL;
+        }
+
+        if (PyThread_tss_create(&pending_key) != 0)
+        {
+            PyErr_NoMemory();
+            return NULL;
+        }
     }
 
-    if (!auto_alloc)
+    if ((pd = PyThread_tss_get(&pending_key)) == NULL && auto_alloc)
     {
-        /* This is not an error. */
-        return NULL;
-    }
+        if ((pd = sip_api_malloc(sizeof (pendingDef))) == NULL)
+            return NULL;
 
-    if (empty != NULL)
-    {
-        /* Use an empty entry in the list. */
-        thread = empty;
-    }
-    else if ((thread = sip_api_malloc(sizeof (threadDef))) == NULL)
-    {
-        return NULL;
-    }
-    else
-    {
-        thread->next = threads;
-        threads = thread;
+        if (PyThread_tss_set(&pending_key, pd) != 0)
+        {
+            sip_api_free(pd);
+            PyErr_NoMemory();
+            return NULL;
+        }
+
+        pd->cpp = NULL;
     }
 
-    thread->thr_ident = ident;
-    thread->pending.cpp = NULL;
+    return pd;
+#else
+#if !defined(WITH_THREAD)
+    static pendingDef pending;
+#endif
 
-    return thread;
-}
+    (void)auto_alloc;
 
+    return &pending;
 #endif
+}
@@ -63,21 +63,38 @@ static PyObject *sipVoidPtr_asarray(sipVoidPtrObject *v, PyObject *args,
         PyObject *kw)
 {
 #if PY_VERSION_HEX >= 0x030d0000
-    static char * const kwlist[] = {"size", NULL};
+    static char * const kwlist[] = {"size", "shape", "strides", NULL};
 #else
-    static char *kwlist[] = {"size", NULL};
+    static char *kwlist[] = {"size", "shape", "strides", NULL};
 #endif
 
     Py_ssize_t size = -1;
+    PyObject *shape = Py_None, *strides = Py_None, *array, *reshaped;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kw, "|n:asarray", kwlist, &size))
+    if (!PyArg_ParseTupleAndKeywords(args, kw, "|n$OO:asarray", kwlist, &size, &shape, &strides))
+        return NULL;
+
+    if (shape == Py_None && strides != Py_None)
+    {
+        PyErr_SetString(PyExc_TypeError,
+                "the strides cannot be given without the shape");
         return NULL;
+    }
 
     if ((size = get_size_from_arg(v, size)) < 0)
         return NULL;
 
-    return sip_api_convert_to_array(v->voidptr, "B", size,
+    array = sip_api_convert_to_array(v->voidptr, "B", size,
             (v->rw ? 0 : SIP_READ_ONLY));
+
+    if (array == NULL || array == Py_None || shape == Py_None)
+        return array;
+
+    /* Present the memory as a multi-dimensional array of bytes. */
+    reshaped = sip_array_reshape(array, shape, strides);
+    Py_DECREF(array);
+
+    return reshaped;
 }
 
 
@@ -0,0 +1,56 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+def precompile_headers(build_ext_cmd, ext):
+    """ Precompile the headers of an extension module that is about to be
+    built by a build_ext command.  The headers are taken from the extension's
+    'precompiled_headers' attribute.  A precompiled header is placed alongside
+    the header itself where GCC and Clang will find it.  Other compilers are
+    silently ignored.
+    """
+
+    headers = getattr(ext, 'precompiled_headers', None)
+    if not headers:
+        return
+
+    compiler = build_ext_cmd.compiler
+
+    if compiler.compiler_type != 'unix':
+        return
+
+    if (ext.language or compiler.detect_language(ext.sources)) == 'c++':
+        compiler_so = getattr(compiler, 'compiler_so_cxx',
+                compiler.compiler_so)
+        header_language = 'c++-header'
+    else:
+        compiler_so = compiler.compiler_so
+        header_language = 'c-header'
+
+    # The header must be compiled with the same preprocessor options as the
+    # sources that include it or the compiler will ignore it.
+    macros = list(compiler.macros)
+    macros.extend(ext.define_macros)
+    macros.extend([(undef, ) for undef in ext.undef_macros])
+
+    pp_opts = []
+
+    for macro in macros:
+        if len(macro) == 1:
+            pp_opts.append('-U' + macro[0])
+        elif macro[1] is None:
+            pp_opts.append('-D' + macro[0])
+        else:
+            pp_opts.append('-D{0}={1}'.format(*macro))
+
+    for include_dir in list(ext.include_dirs) + list(compiler.include_dirs):
+        pp_opts.append('-I' + include_dir)
+
+    if build_ext_cmd.debug:
+        pp_opts.append('-g')
+
+    for header in headers:
+        compiler.spawn(
+                compiler_so + ['-x', header_language] + pp_opts +
+                [header, '-o', header + '.gch'] + ext.extra_compile_args)
@@ -104,8 +104,18 @@ class Project(AbstractProject, Configurable):
                 help="disable all progress messages"),
         Option('verbose', option_type=bool,
                 help="enable verbose progress messages"),
+        Option('jobs', option_type=int,
+                help="generate the code using N worker processes",
+                metavar="N", tools=['build', 'install', 'wheel']),
+        Option('incremental', option_type=bool,
+                help="keep the contents of the build directory so that "
+                        "unchanged generated code isn't rebuilt",
+                tools=['build', 'install', 'wheel']),
         Option('name', help="the name used in sdist and wheel file names",
                 metavar="NAME", tools=['sdist', 'wheel']),
+        Option('parse_cache_dir',
+                help="cache the results of parsing .sip files in DIR",
+                metavar="DIR", tools=['build', 'install', 'wheel']),
         Option('build_dir', help="the build directory", metavar="DIR"),
         Option('build_tag', help="the build tag to be used in the wheel name",
                 metavar="TAG", tools=['wheel']),
@@ -611,11 +621,21 @@ class Project(AbstractProject, Configurable):
         if not self.verbose:
             warnings.simplefilter('ignore', UserWarning)
 
-        # Make sure we have a clean build directory and make it current.
+        # Make sure we have a clean build directory and make it current.  An
+        # incremental build keeps the existing contents so that the generated
+        # files that haven't changed keep their modification times.
         if self._temp_build_dir is None:
             self.build_dir = os.path.abspath(self.build_dir)
-            shutil.rmtree(self.build_dir, ignore_errors=True)
-            os.mkdir(self.build_dir)
+
+            if self.incremental:
+                os.makedirs(self.build_dir, exist_ok=True)
+            else:
+                shutil.rmtree(self.build_dir, ignore_errors=True)
+                os.mkdir(self.build_dir)
+
+        # The parse cache is relative to the project directory.
+        if self.parse_cache_dir:
+            self.parse_cache_dir = self.project_path(self.parse_cache_dir)
 
         os.chdir(self.build_dir)
 
@@ -6,11 +6,13 @@
 import os
 
 from setuptools import Extension, setup
+from setuptools.command.build_ext import build_ext
 
 from .buildable import BuildableModule
 from .builder import Builder
 from .exceptions import UserException
 from .installable import Installable
+from .precompiled_headers import precompile_headers
 
 
 class SetuptoolsBuilder(Builder):
@@ -120,16 +122,19 @@ class SetuptoolsBuilder(Builder):
 
         buildable.make_names_relative()
 
-        setup_args['ext_modules'] = [
-            Extension(buildable.fq_name, buildable.sources,
-                    define_macros=define_macros,
-                    extra_compile_args=buildable.extra_compile_args,
-                    extra_link_args=buildable.extra_link_args,
-                    extra_objects=buildable.extra_objects,
-                    include_dirs=buildable.include_dirs,
-                    libraries=buildable.libraries,
-                    library_dirs=buildable.library_dirs,
-                    py_limited_api=buildable.uses_limited_api)]
+        extension = Extension(buildable.fq_name, buildable.sources,
+                define_macros=define_macros,
+                extra_compile_args=buildable.extra_compile_args,
+                extra_link_args=buildable.extra_link_args,
+                extra_objects=buildable.extra_objects,
+                include_dirs=buildable.include_dirs,
+                libraries=buildable.libraries,
+                library_dirs=buildable.library_dirs,
+                py_limited_api=buildable.uses_limited_api)
+        extension.precompiled_headers = buildable.precompiled_headers
+
+        setup_args['ext_modules'] = [extension]
+        setup_args['cmdclass'] = {'build_ext': ExtensionCommand}
 
         project.progress(
                 "Compiling the '{0}' module".format(buildable.fq_name))
@@ -156,3 +161,14 @@ class SetuptoolsBuilder(Builder):
         buildable.installables.append(installable)
 
         os.chdir(saved_cwd)
+
+
+class ExtensionCommand(build_ext):
+    """ Extend the setuptools command to build an extension module. """
+
+    def build_extension(self, ext):
+        """ Reimplemented to precompile any headers first. """
+
+        precompile_headers(self, ext)
+
+        super().build_extension(ext)
@@ -0,0 +1,209 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+import array as py_array
+import hashlib
+
+from utils import SIPTestCase
+
+
+class ArraysTestCase(SIPTestCase):
+    """ Test sip.array. """
+
+    def test_create_basic(self):
+        """ Test creating arrays of basic types. """
+
+        from .arrays import array
+
+        a = array('i', 3)
+        self.assertEqual(len(a), 3)
+        self.assertEqual(list(a), [0, 0, 0])
+
+        a = array('d', [1.5, 2.5])
+        self.assertEqual(list(a), [1.5, 2.5])
+
+        a = array('h', (i for i in range(5)))
+        self.assertEqual(list(a), [0, 1, 2, 3, 4])
+
+        with self.assertRaises(ValueError):
+            array('q', 1)
+
+        with self.assertRaises(TypeError):
+            array('i', ['bad'])
+
+    def test_create_from_buffer(self):
+        """ Test creating an array of a basic type from a buffer. """
+
+        from .arrays import array
+
+        a = array('d', py_array.array('i', [1, 2, 3]))
+        self.assertEqual(list(a), [1.0, 2.0, 3.0])
+
+        a = array('B', b'\x01\x02')
+        self.assertEqual(list(a), [1, 2])
+
+        self.assertEqual(bytes(memoryview(array('B', [3, 4]))), b'\x03\x04')
+
+    def test_create_typed(self):
+        """ Test creating an array of a wrapped type from an iterable. """
+
+        from .arrays import array, Item
+
+        a = array(Item, [Item(3), Item(4)])
+        self.assertEqual([item.value() for item in a], [3, 4])
+
+        a = array(Item, 2)
+        self.assertEqual([item.value() for item in a], [0, 0])
+
+        with self.assertRaises(TypeError):
+            array(Item, [Item(1), 2])
+
+        with self.assertRaises(TypeError):
+            array(int, 2)
+
+    def test_assign_buffer(self):
+        """ Test assigning a buffer to a slice. """
+
+        from .arrays import array
+
+        a = array('i', 4)
+
+        # The same format.
+        a[1:3] = py_array.array('i', [5, 6])
+        self.assertEqual(list(a), [0, 5, 6, 0])
+
+        # A different format.
+        a[:] = py_array.array('h', [-1, -2, -3, -4])
+        self.assertEqual(list(a), [-1, -2, -3, -4])
+
+        # A strided buffer.
+        a[0:2] = memoryview(py_array.array('i', [7, 8, 9, 10]))[::2]
+        self.assertEqual(list(a[0:2]), [7, 9])
+
+        # Another sip.array.
+        a[2:4] = array('B', [1, 2])
+        self.assertEqual(list(a), [7, 9, 1, 2])
+
+        d = array('d', 2)
+        d[:] = py_array.array('f', [0.5, 1.5])
+        self.assertEqual(list(d), [0.5, 1.5])
+
+        with self.assertRaises(TypeError):
+            a[0:2] = py_array.array('d', [1.0, 2.0])
+
+        with self.assertRaises(TypeError):
+            a[0:2] = py_array.array('i', [1, 2, 3])
+
+        with self.assertRaises(TypeError):
+            a[0:2] = py_array.array('q', [1, 2])
+
+    def test_assign_overlapping(self):
+        """ Test assigning an overlapping buffer with a different format. """
+
+        from .arrays import array
+
+        a = array('B', [1, 2, 3, 4, 5, 6, 7, 8])
+        a[1:5] = memoryview(a).cast('b')[0:4]
+        self.assertEqual(list(a), [1, 1, 2, 3, 4, 6, 7, 8])
+
+    def test_assign_typed_slice(self):
+        """ Test assigning an array of a wrapped type to a slice. """
+
+        from .arrays import array, Item
+
+        a = array(Item, 3)
+        a[1:3] = array(Item, [Item(1), Item(2)])
+        self.assertEqual([item.value() for item in a], [0, 1, 2])
+
+    def test_strided_c_api(self):
+        """ Test a strided array created by sipConvertToStridedArray(). """
+
+        from .arrays import Image
+
+        image = Image(4, 3)
+        pixels = image.pixels()
+
+        self.assertEqual(len(pixels), 3)
+        self.assertEqual(list(pixels[1]), [4, 5, 6, 7])
+        self.assertEqual(pixels[2][3], 11)
+
+        m = memoryview(pixels)
+        self.assertEqual(m.ndim, 2)
+        self.assertEqual(m.shape, (3, 4))
+        self.assertEqual(m.strides, (image.stride(), 1))
+        self.assertFalse(m.c_contiguous)
+        self.assertEqual(m.tolist(),
+                [[0, 1, 2, 3], [4, 5, 6, 7], [8, 9, 10, 11]])
+
+        # The padding must not be visible.
+        self.assertEqual(m.tobytes(), bytes(range(12)))
+
+        # A consumer that can't handle strides is refused.
+        with self.assertRaises(BufferError):
+            hashlib.md5(pixels)
+
+        pixels[0][1] = 42
+        self.assertEqual(m[0, 1], 42)
+
+        with self.assertRaises(NotImplementedError):
+            pixels[0] = pixels[1]
+
+    def test_reshape(self):
+        """ Test reshaping an array. """
+
+        from .arrays import array, Item
+
+        a = array('i', range(12))
+
+        b = a.reshape((3, 4))
+        self.assertEqual(repr(b).split('(', 1)[1], 'int, (3, 4))')
+        self.assertEqual(memoryview(b).tolist(),
+                [list(range(0, 4)), list(range(4, 8)), list(range(8, 12))])
+        self.assertEqual(bytes(b), bytes(a))
+
+        # The memory is shared.
+        b[1][2] = -1
+        self.assertEqual(a[6], -1)
+
+        # A transposed view.
+        t = a.reshape((4, 3), (4, 16))
+        m = memoryview(t)
+        self.assertTrue(m.f_contiguous)
+        self.assertEqual(m[1, 2], a[9])
+
+        # Every other element.
+        r = a.reshape((6, ), (8, ))
+        self.assertEqual(list(r), [a[i] for i in range(0, 12, 2)])
+        self.assertEqual(list(r[1:3]), [a[2], a[4]])
+
+        with self.assertRaises(ValueError):
+            a.reshape((4, 4))
+
+        with self.assertRaises(ValueError):
+            a.reshape((3, 4), (16, 3))
+
+        with self.assertRaises(ValueError):
+            a.reshape((2, ), (-4, ))
+
+        with self.assertRaises(TypeError):
+            array(Item, 2).reshape((2, 1))
+
+    def test_voidptr_asarray_shape(self):
+        """ Test creating a multi-dimensional array from a voidptr. """
+
+        from .arrays import voidptr
+
+        data = bytearray(range(6))
+        v = voidptr(data)
+
+        m = memoryview(v.asarray(shape=(2, 3)))
+        self.assertEqual(m.shape, (2, 3))
+        self.assertEqual(m.tolist(), [[0, 1, 2], [3, 4, 5]])
+
+        m = memoryview(v.asarray(shape=(3, 2), strides=(1, 3)))
+        self.assertEqual(m.tolist(), [[0, 3], [1, 4], [2, 5]])
+
+        with self.assertRaises(TypeError):
+            v.asarray(strides=(1, ))
@@ -0,0 +1,141 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+# Run the benchmarks and write the results as JSON.  Run it from the test
+# directory, e.g. "python -m benchmarks --output results.json".  Use
+# "python -m benchmarks.compare" to compare two sets of results.
+
+
+import argparse
+import importlib
+import json
+import os
+import shutil
+import sys
+import tempfile
+
+from utils import build_module
+
+from .generator import run_generation_benchmark, run_import_benchmarks
+from .harness import Results
+from .runtime import (run_call_benchmarks, run_object_map_benchmarks,
+        run_overload_benchmarks, run_sequence_benchmarks,
+        run_virtual_benchmarks)
+
+
+# The groups of benchmarks.
+GROUPS = ('call', 'overload', 'object_map', 'virtual', 'sequence', 'import',
+        'generate')
+
+
+def main():
+    """ Run the benchmarks. """
+
+    parser = argparse.ArgumentParser(prog='python -m benchmarks',
+            description="Benchmark the sip module and the code generator.")
+
+    parser.add_argument('--abi-version', default='13.9',
+            help="the ABI version of the bindings [default: 13.9]")
+    parser.add_argument('--groups', type=lambda s: s.split(','),
+            default=list(GROUPS),
+            help="a comma separated list of the groups of benchmarks to run "
+                    "[default: {0}]".format(','.join(GROUPS)))
+    parser.add_argument('--max-objects', type=int, default=1000000,
+            help="the largest number of live objects for the object map "
+                    "benchmarks, 10**7 needs several GB [default: 1000000]")
+    parser.add_argument('--output',
+            help="the file to write the results to [default: stdout]")
+    parser.add_argument('--quick', action='store_true',
+            help="use fewer samples and smaller sizes")
+    parser.add_argument('--quiet', action='store_true',
+            help="don't report progress")
+    parser.add_argument('--repeat', type=int, default=5,
+            help="the number of samples of each benchmark [default: 5]")
+    parser.add_argument('--synthetic-classes', type=int, default=1000,
+            help="the number of classes in the synthetic specification used "
+                    "to time generation [default: 1000]")
+
+    args = parser.parse_args()
+
+    for group in args.groups:
+        if group not in GROUPS:
+            parser.error("unknown group '{0}'".format(group))
+
+    if args.quick:
+        args.repeat = min(args.repeat, 3)
+        args.max_objects = min(args.max_objects, 10000)
+        args.synthetic_classes = min(args.synthetic_classes, 100)
+
+    abi_version = args.abi_version
+    supports_13_9 = _abi_version_tuple(abi_version) >= (13, 9)
+
+    results = Results(abi_version, args.repeat, quiet=args.quiet)
+
+    with tempfile.TemporaryDirectory() as project_dir:
+        if {'call', 'overload', 'object_map', 'virtual', 'sequence', 'import'} & set(args.groups):
+            bindings_dir = os.path.join(os.path.dirname(__file__), 'bindings')
+            shutil.copy(os.path.join(bindings_dir, 'sipbench.sip'),
+                    project_dir)
+
+            _, sipbench_impl = build_module(project_dir,
+                    abi_version=abi_version, quiet=True)
+
+            sys.path.insert(0, project_dir)
+            sipbench = importlib.import_module('sipbench')
+
+        if 'call' in args.groups:
+            run_call_benchmarks(results, sipbench)
+
+        if 'overload' in args.groups:
+            run_overload_benchmarks(results, sipbench)
+
+        if 'object_map' in args.groups:
+            sizes = []
+            size = 1000
+
+            while size <= args.max_objects:
+                sizes.append(size)
+                size *= 10
+
+            run_object_map_benchmarks(results, sipbench, sizes)
+
+        if 'virtual' in args.groups:
+            run_virtual_benchmarks(results, sipbench,
+                    1000 if args.quick else 100000)
+
+        if 'sequence' in args.groups:
+            run_sequence_benchmarks(results, sipbench,
+                    1000 if args.quick else 100000, supports_13_9)
+
+        if 'import' in args.groups:
+            run_import_benchmarks(results, abi_version, sipbench_impl,
+                    max(args.synthetic_classes // 10, 10), 10, supports_13_9,
+                    args.repeat)
+
+        if 'generate' in args.groups:
+            run_generation_benchmark(results, abi_version,
+                    args.synthetic_classes, 10, args.repeat)
+
+    output = json.dumps(results.as_json_object(), indent=2) + '\n'
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(output)
+    else:
+        sys.stdout.write(output)
+
+    return 0
+
+
+def _abi_version_tuple(abi_version):
+    """ Return the major and minor numbers of an ABI version. """
+
+    parts = abi_version.split('.') + ['0']
+
+    return (int(parts[0]), int(parts[1]))
+
+
+if __name__ == '__main__':
+    sys.exit(main())
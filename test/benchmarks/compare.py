@@ -0,0 +1,97 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+# Compare two sets of results written by "python -m benchmarks", e.g. of
+# different ABI versions or Python versions.  The exit status is 1 if any
+# benchmark is slower by more than the threshold.
+
+
+import argparse
+import json
+import sys
+
+from .harness import RESULTS_FORMAT, result_key
+
+
+def main():
+    """ Compare two sets of results. """
+
+    parser = argparse.ArgumentParser(prog='python -m benchmarks.compare',
+            description="Compare two sets of benchmark results.")
+
+    parser.add_argument('--threshold', type=float, default=0.1,
+            help="the proportion by which a benchmark must be slower to be "
+                    "reported as a regression [default: 0.1]")
+    parser.add_argument('baseline', help="the file of the baseline results")
+    parser.add_argument('current', help="the file of the current results")
+
+    args = parser.parse_args()
+
+    baseline = _load_results(args.baseline)
+    current = _load_results(args.current)
+
+    for key in ('sip_version', 'abi_version', 'python_version'):
+        print('{0:<16} {1} -> {2}'.format(key + ':',
+                baseline['environment'].get(key),
+                current['environment'].get(key)))
+
+    print()
+
+    baseline_values = _values(baseline)
+    nr_regressions = 0
+
+    for key, result in _values(current).items():
+        base_result = baseline_values.get(key)
+
+        if base_result is None:
+            continue
+
+        ratio = result['value'] / base_result['value']
+
+        if ratio > 1.0 + args.threshold:
+            status = 'REGRESSION'
+            nr_regressions += 1
+        elif ratio < 1.0 - args.threshold:
+            status = 'improvement'
+        else:
+            status = ''
+
+        print('{0:<50} {1:>12.4g} {2:>12.4g} {3:>2} {4:>7.2f}x {5}'.format(
+                key, base_result['value'], result['value'], result['unit'],
+                ratio, status))
+
+    return 1 if nr_regressions else 0
+
+
+def _load_results(file_name):
+    """ Load a set of results. """
+
+    with open(file_name) as f:
+        results = json.load(f)
+
+    if results.get('format') != RESULTS_FORMAT:
+        sys.exit("{0}: unsupported results format".format(file_name))
+
+    return results
+
+
+def _values(results):
+    """ Return a dict of the results that weren't skipped keyed by the name
+    and parameters of the benchmark.
+    """
+
+    values = {}
+
+    for result in results['results']:
+        if 'skipped' in result:
+            continue
+
+        values[result_key(result['name'], result['params'])] = result
+
+    return values
+
+
+if __name__ == '__main__':
+    sys.exit(main())
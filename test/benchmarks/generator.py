@@ -0,0 +1,193 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+from utils import build_module
+
+
+def synthetic_spec(module_name, nr_classes, nr_methods):
+    """ Return the contents of a .sip file that defines a module containing a
+    number of classes, each with a number of methods.  The classes form
+    chains of sub-classes so that the generated code is representative of
+    real bindings.
+    """
+
+    header = []
+    spec = []
+
+    for c in range(nr_classes):
+        klass = 'Class{0}'.format(c)
+        base = 'Class{0}'.format(c - 1) if c % 5 != 0 else None
+        superclass = ' : public ' + base if base else ''
+        sip_superclass = ' : ' + base if base else ''
+
+        header.append('class {0}{1}\n{{\npublic:'.format(klass, superclass))
+        header.append('    {0}() {{}}'.format(klass))
+        header.append('    virtual ~{0}() {{}}'.format(klass))
+        header.append('    enum Kind{0} {{A{0}, B{0}, C{0}}};'.format(c))
+
+        spec.append('class {0}{1}\n{{\npublic:'.format(klass, sip_superclass))
+        spec.append('    {0}();'.format(klass))
+        spec.append('    virtual ~{0}();'.format(klass))
+        spec.append('    enum Kind{0} {{A{0}, B{0}, C{0}}};'.format(c))
+
+        for m in range(nr_methods):
+            signature, body = _METHODS[m % len(_METHODS)]
+            signature = _expand(signature, c, m)
+
+            header.append('    {0} {1}'.format(signature, _expand(body, c, m)))
+            spec.append('    {0};'.format(signature))
+
+        header.append('};\n')
+        spec.append('};\n')
+
+    return _SYNTHETIC_SIP.format(module_name=module_name,
+            header='\n'.join(header), spec='\n'.join(spec))
+
+
+def run_generation_benchmark(results, abi_version, nr_classes, nr_methods,
+        repeat):
+    """ Benchmark the time taken by sip-build to generate the code for a large
+    synthetic specification.  The times include the start-up of the
+    interpreter.
+    """
+
+    with tempfile.TemporaryDirectory() as project_dir:
+        with open(os.path.join(project_dir, 'pyproject.toml'), 'w') as f:
+            f.write(_PYPROJECT_TOML.format(module_name='synthetic',
+                    abi_version=abi_version))
+
+        with open(os.path.join(project_dir, 'synthetic.sip'), 'w') as f:
+            f.write(synthetic_spec('synthetic', nr_classes, nr_methods))
+
+        build_dir = os.path.join(project_dir, 'build')
+        cmd = [sys.executable, '-m', 'sipbuild.tools.build', '--quiet',
+                '--no-compile', '--build-dir', build_dir]
+
+        samples = []
+
+        for _ in range(repeat):
+            shutil.rmtree(build_dir, ignore_errors=True)
+
+            start = time.perf_counter()
+            subprocess.run(cmd, cwd=project_dir).check_returncode()
+            samples.append(time.perf_counter() - start)
+
+    results.add('generate.synthetic', samples, 's', classes=nr_classes,
+            methods=nr_methods)
+
+
+def run_import_benchmarks(results, abi_version, sipbench_impl, nr_classes,
+        nr_methods, supports_lazy_types, repeat):
+    """ Benchmark the time taken to import modules in a new interpreter. """
+
+    _time_import(results, 'import.sipbench', sipbench_impl, repeat)
+
+    configurations = [('import.synthetic', None)]
+
+    if supports_lazy_types:
+        configurations.append(
+                ('import.synthetic_lazy_types', {'lazy-types': True}))
+    else:
+        results.skip('import.synthetic_lazy_types',
+                "requires ABI v13.9 or later", classes=nr_classes,
+                methods=nr_methods)
+
+    for name, bindings_options in configurations:
+        with tempfile.TemporaryDirectory() as project_dir:
+            with open(os.path.join(project_dir, 'synthetic.sip'), 'w') as f:
+                f.write(synthetic_spec('synthetic', nr_classes, nr_methods))
+
+            _, module_impl = build_module(project_dir,
+                    abi_version=abi_version,
+                    bindings_options=bindings_options, quiet=True)
+
+            _time_import(results, name, module_impl, repeat,
+                    classes=nr_classes, methods=nr_methods)
+
+
+def _expand(template, c, m):
+    """ Return a template of a synthetic method after replacing the class
+    and method numbers.
+    """
+
+    return template.replace('{c}', str(c)).replace('{m}', str(m))
+
+
+def _time_import(results, name, module_impl, repeat, **params):
+    """ Time the import of an extension module in a new interpreter. """
+
+    module_dir, module_file = os.path.split(module_impl)
+    module_name = module_file.split('.')[0]
+
+    cmd = [sys.executable, '-S', '-c',
+            _IMPORT_SCRIPT.format(module_dir=module_dir,
+                    module_name=module_name)]
+
+    samples = []
+
+    for _ in range(repeat):
+        output = subprocess.run(cmd, capture_output=True, text=True,
+                check=True).stdout
+        samples.append(float(output))
+
+    results.add(name, samples, 's', **params)
+
+
+# The methods of a synthetic class as a sequence of a signature and an inline
+# implementation.
+_METHODS = (
+    ('int method{m}(int a) const', '{return a;}'),
+    ('double method{m}(double a, int b = 0)', '{return a + b;}'),
+    ('void method{m}(const char *)', '{}'),
+    ('virtual int method{m}(int a, int b)', '{return a + b;}'),
+    ('bool method{m}(Kind{c} k) const', '{return k == A{c};}'),
+    ('static int method{m}(long a)', '{return (int)a;}'),
+)
+
+
+# The script that reports the time taken to import a module.
+_IMPORT_SCRIPT = """
+import sys, time
+sys.path.insert(0, {module_dir!r})
+start = time.perf_counter()
+import {module_name}
+print(time.perf_counter() - start)
+"""
+
+
+# The pyproject.toml file of the synthetic project.
+_PYPROJECT_TOML = """
+[build-system]
+requires = ["sip >=6"]
+build-backend = "sipbuild.api"
+
+[project]
+name = "{module_name}"
+
+[tool.sip.project]
+abi-version = "{abi_version}"
+"""
+
+
+# The prototype .sip file of the synthetic project.
+_SYNTHETIC_SIP = """// A synthetic module for benchmarking.
+
+%Module(name={module_name})
+
+
+%ModuleHeaderCode
+{header}
+%End
+
+
+{spec}
+"""
@@ -0,0 +1,143 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+import datetime
+import os
+import platform
+import statistics
+import sys
+import sysconfig
+import time
+import timeit
+
+from sipbuild.version import SIP_VERSION_STR
+
+
+# The version of the format of the results.  It should be incremented when
+# the meaning of an existing field changes.
+RESULTS_FORMAT = 1
+
+
+class Results:
+    """ Encapsulate the results of a run of the benchmarks. """
+
+    def __init__(self, abi_version, repeat, quiet=False):
+        """ Initialise the results. """
+
+        self.repeat = repeat
+        self.quiet = quiet
+
+        self._abi_version = abi_version
+        self._results = []
+
+    def as_json_object(self):
+        """ Return the results as an object that can be serialised as JSON.
+        """
+
+        environment = {
+            'sip_version': SIP_VERSION_STR,
+            'abi_version': self._abi_version,
+            'python_version': platform.python_version(),
+            'python_implementation': platform.python_implementation(),
+            'free_threaded': bool(sysconfig.get_config_var('Py_GIL_DISABLED')),
+            'platform': sys.platform,
+            'machine': platform.machine(),
+            'processor': platform.processor(),
+            'cpu_count': os.cpu_count(),
+            'timestamp': datetime.datetime.now(
+                    datetime.timezone.utc).isoformat(timespec='seconds'),
+        }
+
+        return {
+            'format': RESULTS_FORMAT,
+            'environment': environment,
+            'results': self._results,
+        }
+
+    def add(self, name, samples, unit, ops=1, **params):
+        """ Add the result of a benchmark given the elapsed time of each of a
+        number of samples.  Each sample performed ops operations.  unit is
+        either 'ns' if the result is the time of a single operation or 's' if
+        the result is the time of a sample.
+        """
+
+        scale = 1e9 / ops if unit == 'ns' else 1.0
+        values = [s * scale for s in samples]
+
+        result = {
+            'name': name,
+            'params': params,
+            'unit': unit,
+            'value': min(values),
+            'median': statistics.median(values),
+            'samples': values,
+            'ops': ops,
+        }
+
+        self._results.append(result)
+
+        self._progress(
+                '{0:<50} {1:>12.4g} {2}'.format(result_key(name, params),
+                        result['value'], unit))
+
+    def skip(self, name, reason, **params):
+        """ Record that a benchmark was skipped. """
+
+        self._results.append({'name': name, 'params': params,
+                'skipped': reason})
+
+        self._progress(
+                '{0:<50} skipped: {1}'.format(result_key(name, params),
+                        reason))
+
+    def time_statement(self, name, stmt, namespace, setup='pass', **params):
+        """ Time a statement and add the time of a single execution of it.  The
+        number of executions per sample is chosen so that a sample takes at
+        least 0.2 seconds.
+        """
+
+        timer = timeit.Timer(stmt, setup=setup, globals=namespace)
+        number, _ = timer.autorange()
+        samples = timer.repeat(repeat=self.repeat, number=number)
+
+        self.add(name, samples, 'ns', ops=number, **params)
+
+    def time_callable(self, name, func, ops=1, unit='ns', repeat=None,
+            **params):
+        """ Time a callable that performs a number of operations and add the
+        result.  It is called once before any samples are taken.
+        """
+
+        if repeat is None:
+            repeat = self.repeat
+
+        func()
+
+        samples = []
+
+        for _ in range(repeat):
+            start = time.perf_counter()
+            func()
+            samples.append(time.perf_counter() - start)
+
+        self.add(name, samples, unit, ops=ops, **params)
+
+    def _progress(self, line):
+        """ Report progress. """
+
+        if not self.quiet:
+            print(line, file=sys.stderr, flush=True)
+
+
+def result_key(name, params):
+    """ Return the string that identifies a benchmark with particular
+    parameters.
+    """
+
+    if not params:
+        return name
+
+    return '{0}[{1}]'.format(name,
+            ','.join(['{0}={1}'.format(k, v) for k, v in params.items()]))
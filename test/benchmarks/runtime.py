@@ -0,0 +1,200 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+import array as py_array
+import gc
+import time
+
+
+def run_call_benchmarks(results, sipbench):
+    """ Benchmark the overhead of calls for each kind of argument and result.
+    """
+
+    value = sipbench.Value(1)
+
+    namespace = {
+        'm': sipbench,
+        'value': value,
+        'red': sipbench.Colour.Red,
+        'obj': object(),
+    }
+
+    for name, stmt in (
+            ('no_args', 'm.noArgs()'),
+            ('int', 'm.intArg(1)'),
+            ('double', 'm.doubleArg(1.5)'),
+            ('bool', 'm.boolArg(True)'),
+            ('bytes', "m.strArg(b'sip')"),
+            ('enum', 'm.enumArg(red)'),
+            ('class_ref', 'm.refArg(value)'),
+            ('class_ptr', 'm.ptrArg(value)'),
+            ('object', 'm.objectArg(obj)'),
+            ('many_args', "m.manyArgs(1, 1.5, True, b'sip', red, value)"),
+            ('keyword_args', 'm.keywordArgs(1, c=2)'),
+            ('method', 'value.value()'),
+            ('int_result', 'm.intResult()'),
+            ('bytes_result', 'm.strResult()'),
+            ('value_result', 'm.valueResult()')):
+        results.time_statement('call.' + name, stmt, namespace)
+
+
+def run_overload_benchmarks(results, sipbench):
+    """ Benchmark the dispatch of overloaded functions and ctors. """
+
+    namespace = {'m': sipbench, 'value': sipbench.Value(1)}
+
+    for name, stmt in (
+            ('first', 'm.overloaded(value)'),
+            ('last', 'm.overloaded(1)'),
+            ('ctor_first', 'm.Value(1)'),
+            ('ctor_last', 'm.Value(1.5)'),
+            ('no_match', _NO_MATCH)):
+        results.time_statement('overload.' + name, stmt, namespace)
+
+
+def run_object_map_benchmarks(results, sipbench, sizes):
+    """ Benchmark wrapping and unwrapping C++ instances as the number of live
+    wrappers (and so the size of the object map) grows.  The times are of a
+    single instance.
+    """
+
+    namespace = {'m': sipbench}
+
+    results.time_statement('wrapper.create', 'm.Value()', namespace)
+
+    node = sipbench.Pool(1).at(0)
+    namespace['node'] = node
+    results.time_statement('wrapper.unwrap', 'm.nodeId(node)', namespace)
+
+    for size in sizes:
+        pool = sipbench.Pool(size)
+        at = pool.at
+        node_id = sipbench.nodeId
+        indexes = range(size)
+        repeat = _repeat_for_size(results.repeat, size)
+
+        wrap = []
+        lookup = []
+        unwrap = []
+        release = []
+
+        # Garbage collection would dominate the larger sizes.
+        gc_enabled = gc.isenabled()
+        gc.disable()
+
+        try:
+            for _ in range(repeat):
+                # Each instance is wrapped for the first time.
+                start = time.perf_counter()
+                nodes = [at(i) for i in indexes]
+                wrap.append(time.perf_counter() - start)
+
+                # Each instance is found in the object map.
+                start = time.perf_counter()
+                found = [at(i) for i in indexes]
+                lookup.append(time.perf_counter() - start)
+                del found
+
+                start = time.perf_counter()
+                for n in nodes:
+                    node_id(n)
+                unwrap.append(time.perf_counter() - start)
+
+                # Each wrapper is destroyed and removed from the object map.
+                start = time.perf_counter()
+                del nodes
+                release.append(time.perf_counter() - start)
+        finally:
+            if gc_enabled:
+                gc.enable()
+
+        del pool
+
+        for name, samples in (('wrap', wrap), ('lookup', lookup),
+                ('unwrap', unwrap), ('release', release)):
+            results.add('object_map.' + name, samples, 'ns', ops=size,
+                    live_objects=size)
+
+
+def run_virtual_benchmarks(results, sipbench, nr_calls):
+    """ Benchmark calls of C++ virtuals from C++.  The times are of a single
+    call.
+    """
+
+    class Reimplemented(sipbench.Callback):
+        def compute(self, v):
+            return v
+
+    class NotReimplemented(sipbench.Callback):
+        pass
+
+    for name, obj, meth in (
+            ('python', Reimplemented(), 'callCompute'),
+            ('not_reimplemented', NotReimplemented(), 'callUnused'),
+            ('cpp', sipbench.Callback(), 'callCompute')):
+        call = getattr(obj, meth)
+        results.time_callable('virtual.' + name, lambda: call(nr_calls),
+                ops=nr_calls)
+
+
+def run_sequence_benchmarks(results, sipbench, nr_items, supports_buffers):
+    """ Benchmark the bulk conversion of sequences and sip.array.  The times
+    are of a single item.
+    """
+
+    points = [(float(i), float(-i)) for i in range(nr_items)]
+    results.time_callable('sequence.points_list',
+            lambda: sipbench.sumPoints(points), ops=nr_items)
+
+    if supports_buffers:
+        buffer = py_array.array('d', [c for p in points for c in p])
+        results.time_callable('sequence.points_buffer',
+                lambda: sipbench.sumPoints(buffer), ops=nr_items)
+    else:
+        results.skip('sequence.points_buffer',
+                "requires ABI v13.9 or later")
+
+    values = [sipbench.Value(i) for i in range(nr_items)]
+    results.time_callable('sequence.values_list',
+            lambda: sipbench.sumValues(values), ops=nr_items)
+
+    sip_array = sipbench.intArray(nr_items)
+    results.time_callable('array.create',
+            lambda: sipbench.intArray(nr_items), ops=nr_items)
+    results.time_callable('array.to_list', lambda: list(sip_array),
+            ops=nr_items)
+    results.time_callable('array.buffer_copy',
+            lambda: memoryview(sip_array).tobytes(), ops=nr_items)
+
+    if supports_buffers:
+        ints = list(range(nr_items))
+        results.time_callable('array.from_list',
+                lambda: sipbench.array('i', ints), ops=nr_items)
+    else:
+        results.skip('array.from_list', "requires ABI v13.9 or later")
+
+
+def _repeat_for_size(repeat, size):
+    """ Return the number of samples to take for a benchmark of a particular
+    size so that the largest ones don't take too long.
+    """
+
+    if size >= 1000000:
+        return min(repeat, 2)
+
+    if size >= 100000:
+        return min(repeat, 3)
+
+    return repeat
+
+
+# The statement that calls a function with an argument that matches none of
+# its overloads.
+_NO_MATCH = """
+try:
+    m.overloaded(None)
+except TypeError:
+    pass
+"""
@@ -0,0 +1,173 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+import glob
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+
+
+class ConcatenationTestCase(unittest.TestCase):
+    """ Test the concatenation of the generated code. """
+
+    def test_weighted_parts(self):
+        """ Test that a large class is given a part of its own rather than
+        being concatenated with the small ones.
+        """
+
+        parts = self._build('--no-compile')
+
+        self.assertEqual(len(parts), 2)
+
+        part0 = parts['sipbalancedpart0.cpp']
+        part1 = parts['sipbalancedpart1.cpp']
+
+        self.assertNotIn(_type_def('Heavy'), part0)
+        self.assertIn(_type_def('Heavy'), part1)
+
+        for light in ('Light1', 'Light2', 'Light3', 'Light4'):
+            self.assertIn(_type_def(light), part0)
+            self.assertNotIn(_type_def(light), part1)
+
+    def test_precompiled_header(self):
+        """ Test that the internal API header is precompiled. """
+
+        if sys.platform == 'win32':
+            self.skipTest("precompiled headers require GCC or Clang")
+
+        self._build('--precompiled-header', pch=True)
+
+    def _build(self, *args, pch=False):
+        """ Build the project with some additional arguments using two parts
+        and return a dict of the contents of each part.
+        """
+
+        with tempfile.TemporaryDirectory() as project_dir:
+            with open(os.path.join(project_dir, 'pyproject.toml'), 'w') as f:
+                f.write(_PYPROJECT_TOML)
+
+            with open(os.path.join(project_dir, 'balanced.sip'), 'w') as f:
+                f.write(_BALANCED_SIP)
+
+            cmd = [sys.executable, '-m', 'sipbuild.tools.build', '--quiet',
+                    '--build-dir', 'build', '--concatenate', '2']
+            cmd.extend(args)
+
+            subprocess.run(cmd, cwd=project_dir).check_returncode()
+
+            build_dir = os.path.join(project_dir, 'build', 'balanced')
+
+            if pch:
+                self.assertTrue(
+                        os.path.isfile(
+                                os.path.join(build_dir,
+                                        'sipAPIbalanced.h.gch')))
+
+            parts = {}
+
+            part_names = os.path.join(build_dir, 'sipbalancedpart*')
+
+            for source_name in glob.glob(part_names):
+                with open(source_name) as f:
+                    parts[os.path.basename(source_name)] = f.read()
+
+        return parts
+
+
+def _type_def(klass):
+    """ Return the start of the definition of the type structure of a class.
+    """
+
+    return 'sipClassTypeDef sipTypeDef_balanced_' + klass
+
+
+# The pyproject.toml file.
+_PYPROJECT_TOML = """
+[build-system]
+requires = ["sip >=6"]
+build-backend = "sipbuild.api"
+
+[project]
+name = "balanced"
+
+[tool.sip.project]
+abi-version = "13.9"
+"""
+
+
+# The .sip file containing one class that is much larger than the others.
+_BALANCED_SIP = """
+%Module(name=balanced)
+
+%ModuleHeaderCode
+class Heavy
+{
+public:
+    Heavy() {}
+    virtual ~Heavy() {}
+    int m0() const {return 0;}
+    int m1() const {return 1;}
+    int m2() const {return 2;}
+    int m3() const {return 3;}
+    int m4() const {return 4;}
+    int m5() const {return 5;}
+    int m6() const {return 6;}
+    int m7() const {return 7;}
+    int m8() const {return 8;}
+    int m9() const {return 9;}
+    virtual int v0() const {return 0;}
+    virtual int v1() const {return 1;}
+};
+
+struct Light1 {};
+struct Light2 {};
+struct Light3 {};
+struct Light4 {};
+%End
+
+class Heavy
+{
+public:
+    Heavy();
+    int m0() const;
+    int m1() const;
+    int m2() const;
+    int m3() const;
+    int m4() const;
+    int m5() const;
+    int m6() const;
+    int m7() const;
+    int m8() const;
+    int m9() const;
+    virtual int v0() const;
+    virtual int v1() const;
+};
+
+class Light1
+{
+public:
+    Light1();
+};
+
+class Light2
+{
+public:
+    Light2();
+};
+
+class Light3
+{
+public:
+    Light3();
+};
+
+class Light4
+{
+public:
+    Light4();
+};
+"""
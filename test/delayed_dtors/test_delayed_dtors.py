@@ -0,0 +1,41 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+import os
+import subprocess
+import sys
+
+from utils import SIPTestCase
+
+
+class DelayedDtorsTestCase(SIPTestCase):
+    """ Test the support for delayed destructors. """
+
+    def test_delayed_dtors(self):
+        """ Test that the destructors of all garbage collected instances are
+        delayed until the interpreter exits.
+        """
+
+        # More instances than will fit into a single chunk of storage.
+        nr_instances = 200
+
+        script = f"""
+from delayed_dtors.delayed_dtors import AlsoDelayed, Delayed
+
+instances = [Delayed(i) for i in range({nr_instances})]
+instances.extend([AlsoDelayed(i) for i in range({nr_instances})])
+del instances
+"""
+
+        test_dir = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+        result = subprocess.run([sys.executable, '-c', script],
+                cwd=test_dir, capture_output=True, text=True)
+        result.check_returncode()
+
+        nr_total = nr_instances * 2
+        id_total = nr_instances * (nr_instances - 1)
+
+        self.assertEqual(result.stdout.strip(), f'{nr_total} {id_total}')
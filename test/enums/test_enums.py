@@ -193,6 +193,46 @@ class EnumsTestCase(SIPTestCase):
         with self.assertRaises(TypeError):
             self.int_fixture.named_var = 50
 
+    def test_named_repeated_conversions(self):
+        """ Repeated conversions of named enum members. """
+
+        from .enums import Colour, colour_from_value, colour_value
+
+        for _ in range(3):
+            for member in Colour:
+                self.assertEqual(colour_value(member), member.value)
+                self.assertIs(colour_from_value(member.value), member)
+
+        # A value that isn't a member is always converted to the same
+        # pseudo-member.
+        missing = colour_from_value(10)
+        self.assertEqual(missing.value, 10)
+        self.assertIs(colour_from_value(10), missing)
+        self.assertEqual(colour_value(missing), 10)
+
+    def test_flag_combinations(self):
+        """ Repeated conversions of combinations of flags. """
+
+        from .enums import Alignment, alignment_from_value, alignment_value
+
+        combination = Alignment.AlignLeft | Alignment.AlignTop
+        self.assertEqual(alignment_value(combination), 0x21)
+        self.assertEqual(alignment_from_value(0x21), combination)
+
+        for _ in range(2):
+            for value in range(0x80):
+                # Only use the values that are combinations of the members.
+                if value & 0x1c:
+                    continue
+
+                flags = alignment_from_value(value)
+                self.assertIsInstance(flags, Alignment)
+                self.assertEqual(flags.value, value)
+                self.assertEqual(alignment_value(flags), value)
+
+        with self.assertRaises(TypeError):
+            alignment_value(0x21)
+
     ###########################################################################
     # The following test scoped enums.
     ###########################################################################
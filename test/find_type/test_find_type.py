@@ -0,0 +1,48 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+from utils import SIPTestCase
+
+
+class FindTypeTestCase(SIPTestCase):
+    """ Test finding types by name. """
+
+    def test_class(self):
+        """ Test finding a class. """
+
+        from .find_type import findType
+
+        self.assertEqual(findType('Klass'), 'Klass')
+        self.assertEqual(findType('Outer::Inner'), 'Outer::Inner')
+
+    def test_spaces(self):
+        """ Test that spaces in a name are ignored. """
+
+        from .find_type import findType
+
+        self.assertEqual(findType('Holder<int>'), 'Holder<int>')
+        self.assertEqual(findType('Holder< int >'), 'Holder<int>')
+        self.assertEqual(findType(' Klass '), 'Klass')
+
+    def test_pointers_and_references(self):
+        """ Test finding the type of a pointer or a reference. """
+
+        from .find_type import findType
+
+        self.assertEqual(findType('Klass*'), 'Klass')
+        self.assertEqual(findType('Klass &'), 'Klass')
+        self.assertEqual(findType('Klass **'), 'Klass')
+        self.assertEqual(findType('Holder<int> *'), 'Holder<int>')
+
+    def test_missing(self):
+        """ Test that an unknown type isn't found. """
+
+        from .find_type import findType
+
+        self.assertIsNone(findType('Missing'))
+        self.assertIsNone(findType('Klas'))
+        self.assertIsNone(findType('Klass2'))
+        self.assertIsNone(findType('*'))
+        self.assertIsNone(findType(''))
@@ -0,0 +1,109 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+import gc
+import weakref
+
+from utils import SIPTestCase
+
+
+class GCUntrackedTestCase(SIPTestCase):
+    """ Test the support for instances that aren't tracked by the garbage
+    collector.
+    """
+
+    def test_untracked(self):
+        """ Test that new instances aren't tracked. """
+
+        from .gc_untracked import make_point, Point
+
+        self.assertFalse(gc.is_tracked(Point(1)))
+        self.assertFalse(gc.is_tracked(make_point(2)))
+
+    def test_not_annotated(self):
+        """ Test that instances of a type without the annotation are tracked.
+        """
+
+        from .gc_untracked import Tracked
+
+        self.assertTrue(gc.is_tracked(Tracked()))
+
+    def test_traverse_code(self):
+        """ Test that instances of a type with %GCTraverseCode are tracked. """
+
+        from .gc_untracked import Traversed
+
+        self.assertTrue(gc.is_tracked(Traversed()))
+
+    def test_sub_class(self):
+        """ Test that instances of a Python sub-class are tracked. """
+
+        from .gc_untracked import Point
+
+        class SubPoint(Point):
+            pass
+
+        self.assertTrue(gc.is_tracked(SubPoint()))
+
+    def test_attribute(self):
+        """ Test that an instance is tracked when an attribute is set. """
+
+        from .gc_untracked import Point
+
+        point = Point()
+        point.attr = None
+
+        self.assertTrue(gc.is_tracked(point))
+
+    def test_dict(self):
+        """ Test that an instance is tracked when its dictionary is created. """
+
+        from .gc_untracked import Point
+
+        point = Point()
+        point.__dict__
+
+        self.assertTrue(gc.is_tracked(point))
+
+    def test_kept_reference(self):
+        """ Test that an instance is tracked when it keeps a reference. """
+
+        from .gc_untracked import Holder, Point
+
+        holder = Holder()
+        self.assertFalse(gc.is_tracked(holder))
+
+        holder.hold(Point())
+        self.assertTrue(gc.is_tracked(holder))
+
+    def test_owner(self):
+        """ Test that an instance is tracked when it owns another. """
+
+        from .gc_untracked import Owned, Owner
+
+        owner = Owner()
+        self.assertFalse(gc.is_tracked(owner))
+
+        owned = Owned(owner)
+        self.assertTrue(gc.is_tracked(owner))
+
+    def test_cycle(self):
+        """ Test that a reference cycle involving an instance is collected. """
+
+        from .gc_untracked import Point
+
+        class Marker:
+            pass
+
+        point = Point()
+        marker = Marker()
+        point.marker = marker
+        marker.point = point
+        marker_ref = weakref.ref(marker)
+
+        del point, marker
+        gc.collect()
+
+        self.assertIsNone(marker_ref())
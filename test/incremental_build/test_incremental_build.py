@@ -0,0 +1,124 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+
+
+class IncrementalBuildTestCase(unittest.TestCase):
+    """ Test that an incremental build only writes the generated files that
+    have changed.
+    """
+
+    def setUp(self):
+        """ Create the project. """
+
+        self._temp_dir = tempfile.TemporaryDirectory()
+        self._project_dir = self._temp_dir.name
+
+        with open(os.path.join(self._project_dir, 'pyproject.toml'), 'w') as f:
+            f.write(_PYPROJECT_TOML)
+
+        self._write_sip('int value() const;')
+
+    def tearDown(self):
+        """ Remove the project. """
+
+        self._temp_dir.cleanup()
+
+    def test_incremental(self):
+        """ Test that an unchanged file keeps its modification time. """
+
+        self._build('--incremental')
+        self._backdate()
+
+        self._write_sip('int value() const;\n    void setValue(int v);')
+        self._build('--incremental')
+
+        self.assertEqual(self._mtime('sipincrementalA.cpp'), _BACKDATED)
+        self.assertEqual(self._mtime('sip_core.c'), _BACKDATED)
+        self.assertNotEqual(self._mtime('sipincrementalB.cpp'), _BACKDATED)
+
+    def test_not_incremental(self):
+        """ Test that all files are written by a normal build. """
+
+        self._build()
+        self._backdate()
+
+        self._build()
+
+        self.assertNotEqual(self._mtime('sipincrementalA.cpp'), _BACKDATED)
+
+    def _backdate(self):
+        """ Set the modification time of every generated file to a time in the
+        past.
+        """
+
+        build_dir = os.path.join(self._project_dir, 'build', 'incremental')
+
+        for name in os.listdir(build_dir):
+            os.utime(os.path.join(build_dir, name), (_BACKDATED, _BACKDATED))
+
+    def _build(self, *args):
+        """ Generate the code for the project. """
+
+        subprocess.run(
+                [sys.executable, '-m', 'sipbuild.tools.build', '--quiet',
+                        '--no-compile'] + list(args),
+                cwd=self._project_dir).check_returncode()
+
+    def _mtime(self, name):
+        """ Return the modification time of a generated file. """
+
+        return os.stat(
+                os.path.join(self._project_dir, 'build', 'incremental',
+                        name)).st_mtime
+
+    def _write_sip(self, b_methods):
+        """ Write the .sip file with the given methods of class B. """
+
+        with open(os.path.join(self._project_dir, 'incremental.sip'), 'w') as f:
+            f.write(_INCREMENTAL_SIP.format(b_methods=b_methods))
+
+
+# The modification time given to the generated files.
+_BACKDATED = 1000000000
+
+
+# The pyproject.toml file.
+_PYPROJECT_TOML = """
+[build-system]
+requires = ["sip >=6"]
+build-backend = "sipbuild.api"
+
+[project]
+name = "incremental"
+
+[tool.sip.project]
+abi-version = "13.9"
+"""
+
+
+# The prototype .sip file.
+_INCREMENTAL_SIP = """
+%Module(name=incremental)
+
+class A
+{{
+public:
+    A();
+    int value() const;
+}};
+
+class B
+{{
+public:
+    B();
+    {b_methods}
+}};
+"""
@@ -1207,3 +1207,60 @@ class IntConvertorsTestCase(SIPTestCase):
         """ bool instance variable with a zero value. """
 
         self.zero_fixture.bool_var = 0
+
+    ###########################################################################
+    # The following test the conversion of many values in a single call.
+    ###########################################################################
+
+    def test_int_array_sequence(self):
+        """ int array from a sequence. """
+
+        from .int_convertors import int_array_sum
+
+        self.assertEqual(int_array_sum([1, 2, 3]), 6)
+        self.assertEqual(int_array_sum((self.INT_LOWER, self.INT_UPPER)),
+                self.INT_LOWER + self.INT_UPPER)
+        self.assertEqual(int_array_sum(range(100)), 4950)
+        self.assertEqual(int_array_sum([True, 2]), 3)
+        self.assertEqual(int_array_sum([]), 0)
+
+    def test_int_array_buffer(self):
+        """ int array from a buffer. """
+
+        import array
+
+        from .int_convertors import int_array_sum, unsigned_short_array
+
+        self.assertEqual(int_array_sum(array.array('i', [-1, 5, 7])), 11)
+
+        # A buffer with a different format is treated as a sequence.
+        self.assertEqual(int_array_sum(array.array('b', [-1, 5, 7])), 11)
+
+        self.assertEqual(unsigned_short_array(array.array('H', [1, 65535])),
+                [1, 65535])
+        self.assertEqual(unsigned_short_array(b'\x01\x02'), [1, 2])
+
+    def test_int_array_overflow(self):
+        """ int array with a value that overflows. """
+
+        from .int_convertors import int_array_sum, unsigned_short_array
+
+        with self.assertRaises(OverflowError):
+            int_array_sum([1, self.INT_UPPER + 1])
+
+        with self.assertRaises(OverflowError):
+            int_array_sum([1 << 100])
+
+        with self.assertRaises(OverflowError):
+            unsigned_short_array([-1])
+
+    def test_int_array_invalid(self):
+        """ int array with an invalid value. """
+
+        from .int_convertors import int_array_sum
+
+        with self.assertRaises(TypeError):
+            int_array_sum([1, '2'])
+
+        with self.assertRaises(TypeError):
+            int_array_sum(1)
@@ -0,0 +1,114 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+import gc
+import weakref
+
+from utils import SIPTestCase
+
+
+class KeepReferenceTestCase(SIPTestCase):
+    """ Test keeping extra references to objects. """
+
+    def test_kept(self):
+        """ Test that a reference is kept. """
+
+        from .keep_reference import Holder, Item
+
+        h = Holder()
+        i = Item()
+        r = weakref.ref(i)
+
+        h.setA(i)
+        del i
+        self.assertIsNotNone(r())
+
+        del h
+        self.assertIsNone(r())
+
+    def test_replaced(self):
+        """ Test that a reference is released when it is replaced. """
+
+        from .keep_reference import Holder, Item
+
+        h = Holder()
+        i1 = Item()
+        r1 = weakref.ref(i1)
+        i2 = Item()
+        r2 = weakref.ref(i2)
+
+        h.setA(i1)
+        h.setA(i2)
+        del i1, i2
+        self.assertIsNone(r1())
+        self.assertIsNotNone(r2())
+
+        h.setA(None)
+        self.assertIsNone(r2())
+
+    def test_many_keys(self):
+        """ Test that more references than the initial capacity are kept. """
+
+        from .keep_reference import Holder, Item
+
+        h = Holder()
+        names = ('setA', 'setB', 'setC', 'setD', 'setE')
+        items = [Item() for _ in names]
+        refs = [weakref.ref(i) for i in items]
+
+        for name, item in zip(names, items):
+            getattr(h, name)(item)
+
+        del item
+
+        del items
+        self.assertTrue(all(r() is not None for r in refs))
+
+        # Replace one after the storage has grown.
+        h.setC(None)
+        self.assertIsNone(refs[2]())
+        self.assertTrue(all(r() is not None for i, r in enumerate(refs) if i != 2))
+
+        del h
+        self.assertTrue(all(r() is None for r in refs))
+
+    def test_cycle(self):
+        """ Test that a cycle through a kept reference is collected. """
+
+        from .keep_reference import Holder, Item
+
+        h = Holder()
+        i = Item()
+        i.holder = h
+        h.setA(i)
+        r = weakref.ref(h)
+
+        del h, i
+        gc.collect()
+        self.assertIsNone(r())
+
+    def test_extra_refs_dict(self):
+        """ Test that the extra_refs dict used by handwritten code is left
+        alone.
+        """
+
+        from .keep_reference import Holder, Item
+
+        h = Holder()
+        i = Item()
+        h.setA(i)
+        self.assertTrue(h.extraRefsIsDict())
+
+        d = Item()
+        r = weakref.ref(d)
+        h.setInDict(d)
+        del d
+        self.assertIsNotNone(r())
+        self.assertTrue(h.extraRefsIsDict())
+        self.assertIs(h.getReference(-200), r())
+        self.assertIs(h.getReference(-1), i)
+
+        del h
+        self.assertIsNone(r())
@@ -0,0 +1,98 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+from utils import SIPTestCase
+
+
+class LazyTypesTestCase(SIPTestCase):
+    """ Test the lazy creation of Python type objects. """
+
+    bindings_options = {'lazy-types': True}
+
+    def test_created_when_accessed(self):
+        """ Test that a type object is only created when it is accessed. """
+
+        from . import lazy_types
+
+        self.assertNotIn('Unused', lazy_types.__dict__)
+        self.assertIn('Unused', dir(lazy_types))
+
+        self.assertEqual(lazy_types.Unused.__name__, 'Unused')
+        self.assertIn('Unused', lazy_types.__dict__)
+
+    def test_inplace_slot(self):
+        """ Test that an in-place slot checks the type of self. """
+
+        from .lazy_types import Counter
+
+        c = Counter(1)
+        c += 2
+        self.assertEqual(c.value, 3)
+
+    def test_type_check(self):
+        """ Test that checking the type of an argument doesn't create the type
+        object.
+        """
+
+        from . import lazy_types
+
+        with self.assertRaises(TypeError):
+            lazy_types.is_checked(lazy_types.Outer())
+
+        self.assertFalse(lazy_types.is_checked(None))
+        self.assertNotIn('Checked', lazy_types.__dict__)
+
+    def test_enums(self):
+        """ Test that the members of enums created out of order are correct.
+        """
+
+        from .lazy_types import First, Second
+
+        self.assertEqual(Second.SecondA.value, 10)
+        self.assertEqual(Second.SecondB.value, 11)
+        self.assertEqual(First.FirstA.value, 0)
+        self.assertEqual(First.FirstB.value, 1)
+
+    def test_enum_result(self):
+        """ Test that converting an enum result creates the enum. """
+
+        from .lazy_types import make_second, Second
+
+        self.assertIs(make_second(), Second.SecondB)
+
+    def test_ints(self):
+        """ Test that ints that aren't enum members are still available. """
+
+        from .lazy_types import Answer
+
+        self.assertEqual(Answer, 42)
+
+    def test_missing_attribute(self):
+        """ Test that looking up a missing attribute raises an exception. """
+
+        from . import lazy_types
+
+        with self.assertRaises(AttributeError):
+            lazy_types.Missing
+
+    def test_nested(self):
+        """ Test that a nested type is created when its scope is. """
+
+        from .lazy_types import Outer
+
+        self.assertEqual(Outer.Inner().value(), 42)
+
+    def test_sub_class_convertor(self):
+        """ Test that a sub-class convertor creates the type it converts to.
+        """
+
+        from . import lazy_types
+
+        self.assertNotIn('Derived', lazy_types.__dict__)
+
+        derived = lazy_types.make_derived()
+
+        self.assertIs(type(derived), lazy_types.Derived)
+        self.assertEqual(derived.kind(), 1)
@@ -0,0 +1,153 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+from utils import SIPTestCase
+
+
+class ObjectMapTestCase(SIPTestCase):
+    """ Test the map of C++ addresses to wrapped objects. """
+
+    def test_lookup(self):
+        """ Test that the same wrapper is found for a C++ address while the
+        map is being resized.
+        """
+
+        from .object_map import Node
+
+        nodes = [Node.make(i) for i in range(20000)]
+
+        for i, node in enumerate(nodes):
+            self.assertIs(Node.same(node), node)
+            self.assertEqual(node.value(), i)
+
+    def test_aliases(self):
+        """ Test that a wrapper is found from the address of a super-class
+        that is different.
+        """
+
+        from .object_map import Both
+
+        both = Both(3)
+        self.assertIs(Both.asOther(both), both)
+
+    def test_deep_aliases(self):
+        """ Test that a wrapper is found from the addresses of all super-classes
+        of a deeper hierarchy and that the aliases are removed when it is
+        garbage collected.
+        """
+
+        from .object_map import Deep, Node, objectmapstats
+
+        stats = objectmapstats()
+        entries = stats['entries']
+        aliases = stats['aliases']
+
+        deep = Deep(4)
+        self.assertIs(Deep.asNode(deep), deep)
+        self.assertIs(Deep.asOther(deep), deep)
+        self.assertIs(Deep.asExtra(deep), deep)
+        self.assertEqual(Deep.asNode(deep).value(), 4)
+
+        # Both and Other have different addresses.  Node has the same address
+        # as Both and so doesn't need an alias of its own.
+        stats = objectmapstats()
+        self.assertGreater(stats['entries'], entries)
+        self.assertEqual(stats['aliases'], aliases + 2)
+
+        del deep
+
+        stats = objectmapstats()
+        self.assertEqual(stats['entries'], entries)
+        self.assertEqual(stats['aliases'], aliases)
+
+    def test_shared_aliases(self):
+        """ Test that an existing C++ instance only has aliases for the
+        addresses of super-classes that are different.
+        """
+
+        from .object_map import Deep, objectmapstats
+
+        aliases = objectmapstats()['aliases']
+
+        deep = Deep.instance()
+        self.assertEqual(objectmapstats()['aliases'], aliases + 2)
+        self.assertIs(Deep.asNode(deep), deep)
+        self.assertIs(Deep.asOther(deep), deep)
+
+        del deep
+        self.assertEqual(objectmapstats()['aliases'], aliases)
+
+    def test_many_aliases(self):
+        """ Test that the pool of aliases handles many aliases. """
+
+        from .object_map import Both, objectmapstats
+
+        aliases = objectmapstats()['aliases']
+
+        boths = [Both(i) for i in range(1000)]
+        self.assertEqual(objectmapstats()['aliases'], aliases + 1000)
+
+        for both in boths:
+            self.assertIs(Both.asOther(both), both)
+
+        del boths[::2]
+        self.assertEqual(objectmapstats()['aliases'], aliases + 500)
+
+        # Reuse the freed aliases.
+        boths.extend(Both(i) for i in range(500))
+        self.assertEqual(objectmapstats()['aliases'], aliases + 1000)
+
+        for both in boths:
+            self.assertIs(Both.asOther(both), both)
+
+        del boths, both
+        self.assertEqual(objectmapstats()['aliases'], aliases)
+
+    def test_stats(self):
+        """ Test the map statistics. """
+
+        from .object_map import Node, objectmapstats
+
+        stats = objectmapstats()
+        self.assertIn(stats['implementation'], ('power-of-2', 'prime'))
+        self.assertGreaterEqual(stats['shards'], 1)
+
+        nodes = [Node(i) for i in range(5000)]
+        stats = objectmapstats()
+        self.assertGreaterEqual(stats['entries'], 5000)
+        self.assertLessEqual(stats['load_factor'], 1.0)
+        self.assertGreaterEqual(stats['probes'], stats['lookups'])
+        self.assertGreaterEqual(stats['max_probe_length'], 1)
+
+        entries = stats['entries']
+        del nodes
+        self.assertLessEqual(objectmapstats()['entries'], entries - 5000)
+
+    def test_threads(self):
+        """ Test wrapping C++ instances on several threads at once. """
+
+        import threading
+
+        from .object_map import Node
+
+        failures = []
+
+        def wrap(base):
+            for i in range(base, base + 2000):
+                node = Node.make(i)
+
+                if Node.same(node) is not node or node.value() != i:
+                    failures.append(i)
+
+        threads = [threading.Thread(target=wrap, args=(t * 2000, ))
+                for t in range(8)]
+
+        for thread in threads:
+            thread.start()
+
+        for thread in threads:
+            thread.join()
+
+        self.assertEqual(failures, [])
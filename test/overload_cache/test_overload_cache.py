@@ -0,0 +1,74 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+from utils import SIPTestCase
+
+
+class OverloadCacheTestCase(SIPTestCase):
+    """ Test the support for overload caches. """
+
+    def test_functions(self):
+        """ Test the overloads of a function are resolved consistently. """
+
+        from .overload_cache import Rect, describe
+
+        for _ in range(3):
+            self.assertEqual(describe(Rect()), 1)
+            self.assertEqual(describe(1), 0)
+            self.assertEqual(describe(Rect()), 1)
+            self.assertEqual(describe(1, 'a'), 2)
+            self.assertEqual(describe(v=1), 0)
+
+        with self.assertRaises(TypeError):
+            describe(None)
+
+        with self.assertRaises(TypeError):
+            describe('a')
+
+    def test_methods(self):
+        """ Test the overloads of a method are resolved consistently. """
+
+        from .overload_cache import Rect, Shape
+
+        r = Rect()
+
+        for _ in range(3):
+            self.assertEqual(r.kind(Shape.Circle), 2)
+            self.assertEqual(r.kind(None), 1)
+            self.assertEqual(r.kind(1), 0)
+            self.assertEqual(r.kind(r), 1)
+            self.assertEqual(Rect.kind(r, Shape.Square), 2)
+
+    def test_ctors(self):
+        """ Test the overloads of a ctor are resolved consistently. """
+
+        from .overload_cache import Rect, Shape
+
+        for _ in range(3):
+            self.assertEqual(Rect(2, 3).area(), 6)
+            self.assertEqual(Rect(Shape.Circle).area(), 2)
+            self.assertEqual(Rect().area(), 0)
+
+        with self.assertRaises(TypeError):
+            Rect(1)
+
+    def test_stats(self):
+        """ Test the cache statistics. """
+
+        from .overload_cache import describe, named, overloadcachestats
+
+        describe(1)
+        hits, misses = overloadcachestats()
+
+        describe(1)
+        self.assertEqual(overloadcachestats(), (hits + 1, misses))
+
+        describe(1.0, 2.0)
+        self.assertEqual(overloadcachestats(), (hits + 1, misses + 1))
+
+        # Functions that have a string overload cannot use a cache.
+        named(1)
+        named('a')
+        self.assertEqual(overloadcachestats(), (hits + 1, misses + 1))
@@ -0,0 +1,104 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+import glob
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+
+
+class ParallelGenerationTestCase(unittest.TestCase):
+    """ Test the generation of code using worker processes. """
+
+    def test_same_code(self):
+        """ Test that the code generated in parallel is the same as that
+        generated serially, including the keys of kept references.
+        """
+
+        if sys.platform == 'win32':
+            self.skipTest("worker processes are only used if they can fork")
+
+        self.assertEqual(self._generate(4), self._generate(1))
+
+    def _generate(self, jobs):
+        """ Generate the code using a number of jobs and return a dict of the
+        contents of each generated file.
+        """
+
+        with tempfile.TemporaryDirectory() as project_dir:
+            with open(os.path.join(project_dir, 'pyproject.toml'), 'w') as f:
+                f.write(_PYPROJECT_TOML)
+
+            with open(os.path.join(project_dir, 'keys.sip'), 'w') as f:
+                f.write(_KEYS_SIP)
+
+            subprocess.run(
+                    [sys.executable, '-m', 'sipbuild.tools.build', '--quiet',
+                            '--no-compile', '--jobs', str(jobs)],
+                    cwd=project_dir).check_returncode()
+
+            build_dir = os.path.join(project_dir, 'build', 'keys')
+            contents = {}
+
+            for source_name in glob.glob(os.path.join(build_dir, 'sipkeys*')):
+                with open(source_name) as f:
+                    contents[os.path.basename(source_name)] = f.read()
+
+        self.assertIn('sipkeysD.cpp', contents)
+
+        return contents
+
+
+# The pyproject.toml file.
+_PYPROJECT_TOML = """
+[build-system]
+requires = ["sip >=6"]
+build-backend = "sipbuild.api"
+
+[project]
+name = "keys"
+
+[tool.sip.project]
+abi-version = "13.9"
+"""
+
+
+# The .sip file where kept references are allocated keys from several
+# interface files.
+_KEYS_SIP = """
+%Module(name=keys)
+
+class A
+{
+public:
+    A();
+    virtual A *make() /KeepReference/;
+    void keep(A *a /KeepReference/);
+};
+
+class B
+{
+public:
+    B();
+    A a;
+    virtual A *make() /KeepReference/;
+};
+
+class C : B
+{
+public:
+    C();
+    B b;
+};
+
+class D
+{
+public:
+    D();
+    C c;
+};
+"""
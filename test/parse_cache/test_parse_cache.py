@@ -0,0 +1,247 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+import os
+import tempfile
+import unittest
+
+from sipbuild.generator import ParseCache, parse, resolve
+from sipbuild.generator.specification import ArgumentType
+from sipbuild.version import SIP_VERSION
+
+
+class ParseCacheTestCase(unittest.TestCase):
+    """ Test the cache of the results of parsing .sip files. """
+
+    def setUp(self):
+        """ Create the .sip files and the cache directory. """
+
+        self._temp_dir = tempfile.TemporaryDirectory()
+
+        self._sip_dir = os.path.join(self._temp_dir.name, 'sip')
+        os.mkdir(self._sip_dir)
+
+        self._write('imported.sip', _IMPORTED_SIP)
+        self._write('main.sip', _MAIN_SIP)
+
+        self._cache = ParseCache(os.path.join(self._temp_dir.name, 'cache'))
+
+    def tearDown(self):
+        """ Remove the .sip files and the cache directory. """
+
+        self._temp_dir.cleanup()
+
+    def test_hit(self):
+        """ Test that an unchanged specification is loaded from the cache. """
+
+        spec, modules, sip_files = self._parse()
+        self.assertFalse(self._cache.hit)
+
+        spec, modules, sip_files = self._parse()
+        self.assertTrue(self._cache.hit)
+
+        self.assertIs(spec.module, modules[0])
+        self.assertEqual([m.fq_py_name.name for m in modules],
+                ['main', 'imported'])
+        self.assertEqual(sip_files,
+                [os.path.join(self._sip_dir, 'main.sip')])
+
+        # The cached specification must be resolvable.
+        resolve(spec, modules)
+        self.assertEqual(
+                sorted(str(k.iface_file.fq_cpp_name) for k in spec.classes),
+                ['Base', 'Derived'])
+
+    def test_changed_main(self):
+        """ Test that an imported module is loaded from the cache when only the
+        main module has changed.
+        """
+
+        self._parse()
+
+        self._write('main.sip', _MAIN_SIP + '\nclass Extra : Base {};\n')
+
+        spec, modules, _ = self._parse()
+        self.assertFalse(self._cache.hit)
+        self.assertEqual(self._cache.imports_reused, 1)
+
+        self.assertIs(spec.module, modules[0])
+        self.assertEqual([m.fq_py_name.name for m in modules],
+                ['main', 'imported'])
+        self.assertEqual(modules[0].imports, [modules[1]])
+
+        # The restored classes must be the ones used by the main module.
+        resolve(spec, modules)
+        classes = {str(k.iface_file.fq_cpp_name): k for k in spec.classes}
+        self.assertEqual(sorted(classes), ['Base', 'Derived', 'Extra'])
+        self.assertIs(classes['Extra'].superclasses[0], classes['Base'])
+        self.assertIs(classes['Base'].iface_file.module, modules[1])
+
+    def test_import_hit_then_imports(self):
+        """ Test that a main module that %Imports further modules and defines
+        types that refer to an imported module restored from the cache is the
+        same as when it isn't cached.
+        """
+
+        self._write('other.sip', _OTHER_SIP)
+        self._write('main.sip', _MAIN_SIP + _MAIN_EXTRA_SIP)
+
+        self._parse()
+
+        # Change the module %Imported after the one that will be restored from
+        # the cache.
+        self._write('other.sip',
+                _OTHER_SIP + '\nclass OtherExtra : Base {};\n')
+
+        spec, modules, _ = self._parse()
+        self.assertFalse(self._cache.hit)
+        self.assertEqual(self._cache.imports_reused, 1)
+        resolve(spec, modules)
+
+        uncached_spec, uncached_modules, _ = self._parse(use_cache=False)
+        resolve(uncached_spec, uncached_modules)
+
+        self.assertEqual(self._summary(spec, modules),
+                self._summary(uncached_spec, uncached_modules))
+
+        # The types must refer to the restored classes.
+        classes = {str(k.iface_file.fq_cpp_name): k for k in spec.classes}
+        self.assertIs(classes['Other'].superclasses[0], classes['Base'])
+
+        make = [o for o in classes['User'].overloads
+                if o.cpp_name == 'make'][0]
+        self.assertIs(make.py_signature.result.definition, classes['Base'])
+
+    def test_changed_import(self):
+        """ Test that changing an imported .sip file invalidates the entry. """
+
+        self._parse()
+
+        self._write('imported.sip', _IMPORTED_SIP + '\nclass Other {};\n')
+
+        spec, _, _ = self._parse()
+        self.assertFalse(self._cache.hit)
+        self.assertEqual(self._cache.imports_reused, 0)
+        self.assertIn('Other',
+                [str(k.iface_file.fq_cpp_name) for k in spec.classes])
+
+        self._parse()
+        self.assertTrue(self._cache.hit)
+
+    def test_new_file(self):
+        """ Test that creating an optional .sip file that didn't exist
+        invalidates the entry.
+        """
+
+        self._parse()
+
+        self._write('optional.sip', 'class Optional {};\n')
+
+        spec, _, _ = self._parse()
+        self.assertFalse(self._cache.hit)
+        self.assertIn('Optional',
+                [str(k.iface_file.fq_cpp_name) for k in spec.classes])
+
+    def test_tags(self):
+        """ Test that different tags use different entries. """
+
+        self._parse()
+
+        self._parse(tags=['Tag'])
+        self.assertFalse(self._cache.hit)
+
+        self._parse()
+        self.assertTrue(self._cache.hit)
+
+    def _parse(self, tags=None, use_cache=True):
+        """ Parse the main .sip file. """
+
+        return parse(os.path.join(self._sip_dir, 'main.sip'), SIP_VERSION,
+                'UTF-8', '13.9', [] if tags is None else tags, [], True,
+                [self._sip_dir], 'sip',
+                cache=self._cache if use_cache else None)
+
+    @staticmethod
+    def _summary(spec, modules):
+        """ Return a comparable summary of a resolved specification. """
+
+        summary = [(m.fq_py_name.name, [i.fq_py_name.name for i in m.imports])
+                for m in modules]
+
+        for klass in spec.classes:
+            summary.append((str(klass.iface_file.fq_cpp_name),
+                    klass.iface_file.module.fq_py_name.name,
+                    [str(k.iface_file.fq_cpp_name) for k in klass.mro],
+                    [(o.cpp_name, _arg_summary(o.py_signature.result),
+                            [_arg_summary(a) for a in o.py_signature.args])
+                            for o in klass.overloads]))
+
+        return summary
+
+    def _write(self, name, contents):
+        """ Write a .sip file. """
+
+        with open(os.path.join(self._sip_dir, name), 'w') as f:
+            f.write(contents)
+
+
+def _arg_summary(arg):
+    """ Return a comparable summary of an argument. """
+
+    if arg.type is ArgumentType.CLASS:
+        definition = str(arg.definition.iface_file.fq_cpp_name)
+    else:
+        definition = None
+
+    return (arg.type.name, definition, list(arg.derefs))
+
+
+
+_IMPORTED_SIP = """
+%Module(name=imported)
+
+class Base
+{
+public:
+    Base();
+};
+"""
+
+_MAIN_SIP = """
+%Module(name=main)
+
+%Import imported.sip
+%Include(name=optional.sip, optional=True)
+
+class Derived : Base
+{
+public:
+    Derived();
+};
+"""
+
+_OTHER_SIP = """
+%Module(name=other)
+
+%Import imported.sip
+
+class Other : Base
+{
+public:
+    Other();
+};
+"""
+
+_MAIN_EXTRA_SIP = """
+%Import other.sip
+
+class User : Base
+{
+public:
+    User();
+    void take(Other *other);
+    Base *make();
+};
+"""
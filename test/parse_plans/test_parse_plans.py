@@ -0,0 +1,110 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+from utils import SIPTestCase
+
+
+class ParsePlansTestCase(SIPTestCase):
+    """ Test the support for precompiled argument parse plans. """
+
+    def test_ctor(self):
+        """ Test calling a ctor. """
+
+        from .parse_plans import Point
+
+        p = Point(1.5, y=2.5)
+        self.assertEqual(p.x(), 1.5)
+        self.assertEqual(p.y(), 2.5)
+
+        self.assertEqual(Point().x(), 0.0)
+
+        with self.assertRaises(TypeError):
+            Point('bad')
+
+        with self.assertRaises(TypeError):
+            Point(1.0, 2.0, 3.0)
+
+        with self.assertRaises(TypeError):
+            Point(1.0, x=2.0)
+
+    def test_methods(self):
+        """ Test calling methods with instance arguments. """
+
+        from .parse_plans import Point
+
+        p = Point(1.0, 2.0).translated(Point(3.0, 4.0))
+        self.assertEqual((p.x(), p.y()), (4.0, 6.0))
+
+        p = Point(1.0, 2.0).translated(scale=2.0, offset=Point(3.0, 4.0))
+        self.assertEqual((p.x(), p.y()), (7.0, 10.0))
+
+        # Call the unbound method.
+        p = Point.translated(Point(1.0, 1.0), Point(1.0, 1.0))
+        self.assertEqual((p.x(), p.y()), (2.0, 2.0))
+
+        with self.assertRaises(TypeError):
+            Point().translated(None)
+
+        self.assertTrue(Point.is_null(None))
+        self.assertFalse(Point.is_null(Point()))
+        self.assertFalse(Point().is_null(Point()))
+
+    def test_scalars(self):
+        """ Test the conversion of scalar arguments. """
+
+        from .parse_plans import negate, to_float, to_long_long, to_ushort
+
+        self.assertEqual(to_ushort(65535), 65535)
+        self.assertEqual(to_long_long(-(1 << 40)), -(1 << 40))
+        self.assertEqual(to_float(0.5), 0.5)
+        self.assertIs(negate(False), True)
+
+        with self.assertRaises(OverflowError):
+            to_ushort(65536)
+
+        with self.assertRaises(TypeError):
+            to_float('bad')
+
+    def test_enums(self):
+        """ Test the conversion of enum arguments. """
+
+        from .parse_plans import Colour, colour_value
+
+        self.assertEqual(colour_value(), 1)
+        self.assertEqual(colour_value(Colour.Blue), 2)
+        self.assertEqual(colour_value(c=Colour.Red), 0)
+
+        with self.assertRaises(TypeError):
+            colour_value(2)
+
+    def test_mapped_types(self):
+        """ Test the conversion of mapped type arguments. """
+
+        from .parse_plans import area, handle_value, make_handle, make_size
+
+        self.assertEqual(area((3, 4)), 12)
+        self.assertEqual(area(s=(2, 5)), 10)
+        self.assertEqual(make_size(1, 2), (1, 2))
+
+        with self.assertRaises(TypeError):
+            area('bad')
+
+        # A mapped type without %ConvertToTypeCode can't be an argument.
+        self.assertEqual(make_handle(7), 7)
+
+        with self.assertRaises(TypeError):
+            handle_value(7)
+
+    def test_overloads(self):
+        """ Test the resolution of overloads. """
+
+        from .parse_plans import Colour, Point, describe
+
+        self.assertEqual(describe(1), 0)
+        self.assertEqual(describe(Colour.Red), 1)
+        self.assertEqual(describe(Point()), 2)
+
+        with self.assertRaises(TypeError):
+            describe('bad')
@@ -0,0 +1,69 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+from utils import SIPTestCase
+
+
+class RuntimeStatsTestCase(SIPTestCase):
+    """ Test the support for runtime statistics. """
+
+    # The statistics are only maintained if the sip module is compiled with
+    # SIP_STATS defined.
+    bindings_options = {'define-macros': ['SIP_STATS']}
+
+    def test_enabled(self):
+        """ Test that the statistics are maintained. """
+
+        from .runtime_stats import stats
+
+        s = stats()
+
+        self.assertTrue(s['enabled'])
+        self.assertIn('resizes', s['object_map'])
+
+    def test_wrappers(self):
+        """ Test that wrapping and unwrapping instances are counted. """
+
+        from .runtime_stats import make_value, stats
+
+        before = stats()['wrappers']
+
+        self.assertEqual(make_value(3).value(), 3)
+
+        after = stats()['wrappers']
+
+        self.assertGreater(after['wraps'], before['wraps'])
+        self.assertGreater(after['unwraps'], before['unwraps'])
+
+    def test_failed_overloads(self):
+        """ Test that overloads that don't match the arguments are counted.
+        """
+
+        from .runtime_stats import Value, stats, twice
+
+        self.assertEqual(twice(Value(2)), 4)
+
+        before = stats()['overloads']['failed']
+
+        with self.assertRaises(TypeError):
+            twice('a')
+
+        # Each of the overloads is rejected.
+        self.assertEqual(stats()['overloads']['failed'], before + 2)
+
+    def test_reset(self):
+        """ Test that the statistics can be reset. """
+
+        from .runtime_stats import make_value, resetstats, stats
+
+        make_value(1)
+        resetstats()
+
+        s = stats()
+
+        self.assertEqual(s['wrappers']['wraps'], 0)
+        self.assertEqual(s['overloads']['failed'], 0)
+        self.assertEqual(s['overloads']['cache_hits'], 0)
+        self.assertEqual(s['object_map']['lookups'], 0)
@@ -0,0 +1,99 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+from array import array
+import contextlib
+import io
+import os
+
+from sipbuild.generator import parse
+from sipbuild.version import SIP_VERSION
+
+from utils import SIPTestCase
+
+
+class SequencesTestCase(SIPTestCase):
+    """ Test the conversion of sequences to and from arrays. """
+
+    def test_from_list(self):
+        """ Test converting a list and a tuple to an array. """
+
+        from .sequences import Summer
+
+        self.assertEqual(Summer.sum([(1.0, 2.0), (3.0, 4.0)]), 46.0)
+        self.assertEqual(Summer.sum(((1.0, 2.0), (3.0, 4.0))), 46.0)
+        self.assertEqual(Summer.sum([]), 0.0)
+
+    def test_from_sequence(self):
+        """ Test converting a sequence that isn't a list or tuple to an array.
+        """
+
+        from .sequences import Summer
+
+        class Points:
+            def __len__(self):
+                return 2
+
+            def __getitem__(self, i):
+                if i >= 2:
+                    raise IndexError(i)
+
+                return (float(i), 1.0)
+
+        self.assertEqual(Summer.sum(Points()), 12.0)
+
+    def test_from_buffer(self):
+        """ Test converting a buffer to an array of a plain old data type. """
+
+        from .sequences import Summer
+
+        points = array('d', [1.0, 2.0, 3.0, 4.0])
+        self.assertEqual(Summer.sum(points), 46.0)
+        self.assertEqual(Summer.sum(memoryview(points)), 46.0)
+
+        # The size of the buffer must be a multiple of the size of the type.
+        with self.assertRaises(TypeError):
+            Summer.sum(array('d', [1.0, 2.0, 3.0]))
+
+    def test_bad_element(self):
+        """ Test that a bad element is rejected. """
+
+        from .sequences import Summer
+
+        with self.assertRaises(TypeError):
+            Summer.sum([(1.0, 2.0), 'bad'])
+
+        with self.assertRaises(TypeError):
+            Summer.sum([(1.0, 2.0), ('bad', 3.0)])
+
+    def test_to_sequence(self):
+        """ Test converting an array to a sequence. """
+
+        from .sequences import Summer
+
+        class PySummer(Summer):
+            def total(self, points):
+                self.points = points
+                return float(len(points))
+
+        summer = PySummer()
+        self.assertEqual(summer.callTotal(3), 3.0)
+        self.assertEqual(summer.points, ((0.0, 0.0), (1.0, -1.0), (2.0, -2.0)))
+
+    def test_pod_type_old_abi(self):
+        """ Test that a warning is issued if /PODType/ is specified for an ABI
+        version that doesn't support it.
+        """
+
+        sip_dir = os.path.dirname(os.path.abspath(__file__))
+        stderr = io.StringIO()
+
+        with contextlib.redirect_stderr(stderr):
+            parse(os.path.join(sip_dir, 'sequences.sip'), SIP_VERSION,
+                    'UTF-8', '13.8', [], [], True, [sip_dir], 'sip')
+
+        self.assertIn(
+                "warning: /PODType/ is ignored for ABI versions earlier than v13.9",
+                stderr.getvalue())
@@ -0,0 +1,81 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+from utils import SIPTestCase
+
+
+class StringsTestCase(SIPTestCase):
+    """ Test the conversion of strings. """
+
+    def test_ascii(self):
+        """ Test ASCII strings. """
+
+        from .strings import echo_ascii
+
+        self.assertEqual(echo_ascii('hello'), 'hello')
+        self.assertEqual(echo_ascii(''), '')
+        self.assertEqual(echo_ascii(b'bytes'), 'bytes')
+        self.assertEqual(echo_ascii(None), '<null>')
+
+        with self.assertRaises(UnicodeEncodeError):
+            echo_ascii('caf\xe9')
+
+    def test_latin1(self):
+        """ Test Latin-1 strings. """
+
+        from .strings import echo_latin1
+
+        self.assertEqual(echo_latin1('hello'), 'hello')
+        self.assertEqual(echo_latin1('caf\xe9'), 'caf\xe9')
+        self.assertEqual(echo_latin1(b'caf\xe9'), 'caf\xe9')
+
+        with self.assertRaises(UnicodeEncodeError):
+            echo_latin1('€')
+
+    def test_utf8(self):
+        """ Test UTF-8 strings. """
+
+        from .strings import echo_utf8
+
+        self.assertEqual(echo_utf8('hello'), 'hello')
+        self.assertEqual(echo_utf8('caf\xe9 € \U0001f600'),
+                'caf\xe9 € \U0001f600')
+
+        # Repeated conversions of the same non-ASCII string.
+        s = '€' * 10
+        for _ in range(3):
+            self.assertEqual(echo_utf8(s), s)
+
+        with self.assertRaises(UnicodeEncodeError):
+            echo_utf8('\udc80')
+
+    def test_char(self):
+        """ Test characters. """
+
+        from .strings import echo_char_ascii, echo_char_latin1, echo_char_utf8
+
+        self.assertEqual(echo_char_ascii('a'), 'a')
+        self.assertEqual(echo_char_latin1('\xe9'), '\xe9')
+        self.assertEqual(echo_char_utf8('a'), 'a')
+        self.assertEqual(echo_char_utf8(b'z'), 'z')
+
+        with self.assertRaises(TypeError):
+            echo_char_ascii('ab')
+
+        with self.assertRaises(TypeError):
+            echo_char_utf8('\xe9')
+
+    def test_keep_reference(self):
+        """ Test that a borrowed string is kept alive. """
+
+        from .strings import Holder
+
+        h = Holder()
+
+        h.set(''.join(['kept ', 'alive']))
+        self.assertEqual(h.get(), 'kept alive')
+
+        h.set(''.join(['caf\xe9 ', '€']))
+        self.assertEqual(h.get(), 'caf\xe9 €')
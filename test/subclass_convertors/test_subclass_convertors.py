@@ -0,0 +1,89 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+import os
+import tempfile
+
+from sipbuild.exceptions import UserException
+from sipbuild.generator import parse, resolve
+from sipbuild.version import SIP_VERSION
+
+from utils import SIPTestCase
+
+
+class SubClassConvertorsTestCase(SIPTestCase):
+    """ Test sub-class convertors. """
+
+    def test_conversion(self):
+        """ Test that an instance is wrapped as its most specific type. """
+
+        from .subclass_convertors import Circle, newShape, Shape, Square
+
+        for _ in range(3):
+            self.assertIs(type(newShape(0)), Shape)
+            self.assertIs(type(newShape(1)), Circle)
+
+            # Square's Shape is not at the start of the object.
+            square = newShape(2)
+            self.assertIs(type(square), Square)
+            self.assertEqual(square.kind(), 2)
+            self.assertEqual(square.dummy, 0)
+
+    def test_cached(self):
+        """ Test that the results of the convertors are cached. """
+
+        from .subclass_convertors import newShape, nrConversions
+
+        # Make sure each dynamic type has been seen.
+        for kind in range(3):
+            newShape(kind)
+
+        nr_conversions = nrConversions()
+
+        for _ in range(10):
+            for kind in range(3):
+                newShape(kind)
+
+        self.assertEqual(nrConversions(), nr_conversions)
+
+    def test_not_polymorphic(self):
+        """ Test that caching is rejected for a class that isn't polymorphic.
+        """
+
+        with tempfile.TemporaryDirectory() as sip_dir:
+            sip_file = os.path.join(sip_dir, 'not_polymorphic.sip')
+
+            with open(sip_file, 'w') as f:
+                f.write(_NOT_POLYMORPHIC_SIP)
+
+            spec, modules, _ = parse(sip_file, SIP_VERSION, 'UTF-8', '13.9',
+                    [], [], True, [sip_dir], 'sip')
+
+            with self.assertRaises(UserException) as cm:
+                resolve(spec, modules)
+
+        self.assertIn("'Base' must be polymorphic", cm.exception.text)
+
+
+_NOT_POLYMORPHIC_SIP = """
+%Module(name=not_polymorphic)
+
+class Base /CacheSubClass/
+{
+%ConvertToSubClassCode
+    sipType = NULL;
+%End
+
+public:
+    Base();
+    ~Base();
+};
+
+class Derived : Base
+{
+public:
+    Derived();
+};
+"""
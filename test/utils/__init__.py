@@ -3,4 +3,5 @@
 # Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
 
 
+from .build_module import build_module
 from .sip_test_case import SIPTestCase
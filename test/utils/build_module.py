@@ -0,0 +1,123 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+import glob
+import os
+import shutil
+import subprocess
+import sys
+
+
+def build_module(project_dir, abi_version=None, bindings_options=None,
+        build_args=None, quiet=False):
+    """ Build the extension module defined by the single .sip file in a
+    directory and move it to the same directory.  abi_version is the ABI
+    version to use.  None implies the latest major version.  bindings_options
+    is an optional dict of the options of the bindings.  The values are
+    converted to TOML using repr(), with the exception of bools.  build_args
+    is an optional list of additional arguments to sip-build.  A 2-tuple of
+    the name of the module and the name of the file containing the module is
+    returned.
+    """
+
+    # Look for a .sip file in the directory.
+    sip_files = glob.glob(os.path.join(project_dir, '*.sip'))
+
+    if len(sip_files) != 1:
+        raise Exception(
+                "expected to find a single .sip file in '{0}'".format(
+                        project_dir))
+
+    module_name = os.path.basename(sip_files[0])[:-4]
+
+    # Create a pyproject.toml file.
+    pyproject_toml = os.path.join(project_dir, 'pyproject.toml')
+
+    with open(pyproject_toml, 'w') as f:
+        f.write(_PYPROJECT_TOML.format(module_name=module_name))
+
+        if abi_version is not None:
+            f.write(_ABI_VERSION.format(abi_version=abi_version))
+
+        if bindings_options:
+            f.write(_BINDINGS.format(module_name=module_name))
+
+            for name, value in bindings_options.items():
+                if isinstance(value, bool):
+                    value = 'true' if value else 'false'
+                else:
+                    value = repr(value)
+
+                f.write(f'{name} = {value}\n')
+
+    # Build the extension module.
+    cmd = [sys.executable, '-m', 'sipbuild.tools.build',
+            '--quiet' if quiet else '--verbose']
+
+    if build_args:
+        cmd.extend(build_args)
+
+    subprocess.run(cmd, cwd=project_dir).check_returncode()
+
+    # Move the extension module to the directory.
+    build_dir = os.path.join(project_dir, 'build')
+
+    # The distutils and setuptools builders leave the module in different
+    # places.
+    for subdirs in ((module_name, ), (module_name, 'build', 'lib*')):
+        module_pattern = [build_dir]
+        module_pattern.extend(subdirs)
+        module_pattern.append(
+                module_name + '*.pyd' if sys.platform == 'win32' else '*.so')
+
+        module_path = glob.glob(os.path.join(*module_pattern))
+        if len(module_path) != 0:
+            break
+    else:
+        raise Exception(
+                "no '{0}' extension module was built".format(module_name))
+
+    if len(module_path) != 1:
+        raise Exception(
+                "unable to determine file name of the '{0}' extension module".format(module_name))
+
+    module_path = module_path[0]
+    module_impl = os.path.join(project_dir, os.path.basename(module_path))
+
+    # On Windows the module may be lying around from a previous run.
+    try:
+        os.remove(module_impl)
+    except:
+        pass
+
+    os.rename(module_path, module_impl)
+
+    # Remove the build artifacts.
+    os.remove(pyproject_toml)
+    shutil.rmtree(build_dir, ignore_errors=True)
+
+    return module_name, module_impl
+
+
+# The prototype pyproject.toml file.
+_PYPROJECT_TOML = """
+[build-system]
+requires = ["sip >=6"]
+build-backend = "sipbuild.api"
+
+[project]
+name = "{module_name}"
+
+[tool.sip.project]
+minimum-macos-version = "10.9"
+"""
+
+_ABI_VERSION = """
+abi-version = "{abi_version}"
+"""
+
+_BINDINGS = """
+[tool.sip.bindings.{module_name}]
+"""
@@ -0,0 +1,88 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+from utils import SIPTestCase
+
+
+class ValueTypesTestCase(SIPTestCase):
+    """ Test value types and the reuse of released instances. """
+
+    def test_value_type_unmapped(self):
+        """ Test that instances of a value type owned by Python are not added
+        to the object map.
+        """
+
+        from .value_types import Node, Point, objectmapstats
+
+        entries = objectmapstats()['entries']
+
+        points = [Point(i, i) for i in range(100)]
+        points.extend(p.moved(1, 2) for p in list(points))
+        self.assertEqual(objectmapstats()['entries'], entries)
+        self.assertEqual(points[150].x(), 51)
+        self.assertEqual(points[150].y(), 52)
+
+        nodes = [Node(i) for i in range(100)]
+        self.assertEqual(objectmapstats()['entries'], entries + 100)
+
+        del points
+        del nodes
+        self.assertEqual(objectmapstats()['entries'], entries)
+
+    def test_value_type_transfer(self):
+        """ Test that an instance of a value type is added to the object map
+        when its ownership is transferred to C++.
+        """
+
+        from .value_types import Holder, Point
+
+        holder = Holder()
+        point = Point(3, 4)
+        holder.take(point)
+        self.assertIs(holder.point(), point)
+
+    def test_freelist(self):
+        """ Test that released instances are reused. """
+
+        from .value_types import Node, Point, setfreelistsize
+
+        self.assertEqual(setfreelistsize(Point, 4), 0)
+
+        try:
+            point = Point(1, 2)
+            point_id = id(point)
+            del point
+
+            point = Point(5, 6)
+            self.assertEqual(id(point), point_id)
+            self.assertEqual(point.x(), 5)
+            self.assertEqual(point.y(), 6)
+
+            points = [Point(i, -i) for i in range(10)]
+            del points
+
+            for i in range(10):
+                point = Point(i, -i)
+                self.assertEqual(point.x(), i)
+                self.assertEqual(point.y(), -i)
+                self.assertEqual(point.moved(1, 1).x(), i + 1)
+
+            # A Python sub-class doesn't use the freelist.
+            class SubPoint(Point):
+                pass
+
+            sub_point = SubPoint(7, 8)
+            self.assertEqual(sub_point.x(), 7)
+            del sub_point
+
+            self.assertEqual(setfreelistsize(Point, 0), 4)
+        finally:
+            setfreelistsize(Point, 0)
+
+        with self.assertRaises(ValueError):
+            setfreelistsize(Node, -1)
+
+        with self.assertRaises(TypeError):
+            setfreelistsize(int, 1)
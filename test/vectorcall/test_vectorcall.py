@@ -0,0 +1,142 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+from utils import SIPTestCase
+
+
+class VectorcallTestCase(SIPTestCase):
+    """ Test the support for the vectorcall protocol. """
+
+    def test_ctor(self):
+        """ Test calling a ctor. """
+
+        from .vectorcall import Klass
+
+        self.assertEqual(Klass().value(), 0)
+        self.assertEqual(Klass(2).value(), 2)
+        self.assertEqual(Klass(2, 3).value(), 6)
+        self.assertEqual(Klass(2, scale=4).value(), 8)
+        self.assertEqual(Klass(scale=4, value=3).value(), 12)
+
+    def test_ctor_errors(self):
+        """ Test calling a ctor with bad arguments. """
+
+        from .vectorcall import Klass
+
+        with self.assertRaises(TypeError):
+            Klass('bad')
+
+        with self.assertRaises(TypeError):
+            Klass(1, 2, 3)
+
+        with self.assertRaises(TypeError):
+            Klass(factor=2)
+
+        with self.assertRaises(TypeError):
+            Klass(1, value=2)
+
+    def test_subclass(self):
+        """ Test calling the ctor of a sub-class. """
+
+        from .vectorcall import Klass
+
+        class SubKlass(Klass):
+            def __init__(self, value):
+                super().__init__(value, scale=10)
+
+            def virt(self):
+                return -super().virt()
+
+        sub = SubKlass(2)
+
+        self.assertEqual(sub.value(), 20)
+        self.assertEqual(sub.get_virt(), -20)
+
+        with self.assertRaises(TypeError):
+            SubKlass(2, 3)
+
+    def test_method(self):
+        """ Test calling a method. """
+
+        from .vectorcall import Klass
+
+        k = Klass(10)
+
+        self.assertEqual(k.add(1), 11)
+        self.assertEqual(k.add(1, 2), 13)
+        self.assertEqual(k.add(1, b=3), 14)
+        self.assertEqual(k.add(b=3, a=1), 14)
+        self.assertEqual(Klass.add(k, 1, b=2), 13)
+
+        with self.assertRaises(TypeError):
+            k.add(c=1)
+
+        with self.assertRaises(TypeError):
+            k.add(1, a=1)
+
+    def test_static_method(self):
+        """ Test calling a static method. """
+
+        from .vectorcall import Klass
+
+        self.assertEqual(Klass.twice(4), 8)
+        self.assertEqual(Klass(1).twice(a=5), 10)
+
+    def test_function(self):
+        """ Test calling a function. """
+
+        from .vectorcall import sum
+
+        self.assertEqual(sum(1), 1)
+        self.assertEqual(sum(1, 2, 3), 6)
+        self.assertEqual(sum(1, c=3), 4)
+        self.assertEqual(sum(**{'a': 1, 'b': 2}), 3)
+
+        with self.assertRaises(TypeError):
+            sum()
+
+    def test_overloaded_function(self):
+        """ Test calling an overloaded function. """
+
+        from .vectorcall import overloaded
+
+        self.assertEqual(overloaded(3), 3)
+        self.assertEqual(overloaded('abc'), -3)
+
+        with self.assertRaises(TypeError):
+            overloaded(1.5)
+
+    def test_no_arg_parser(self):
+        """ Test that a function with no argument parser is still passed a
+        tuple.
+        """
+
+        from .vectorcall import all_args
+
+        self.assertEqual(all_args(1, 'a'), (1, 'a'))
+
+    def test_error_messages(self):
+        """ Test that the reasons why arguments didn't match any overload are
+        reported.
+        """
+
+        from .vectorcall import Klass, overloaded, sum
+
+        with self.assertRaisesRegex(TypeError,
+                r"^arguments did not match any overloaded call:\n  overloaded\(a: int\): argument 1 has unexpected type 'float'\n  overloaded\(s: Optional\[str\]\): argument 1 has unexpected type 'float'$"):
+            overloaded(1.5)
+
+        with self.assertRaisesRegex(TypeError,
+                r"'d' is not a valid keyword argument$"):
+            sum(1, d=2)
+
+        with self.assertRaisesRegex(TypeError, r"argument 1 has unexpected type 'str'$"):
+            Klass('bad')
+
+        with self.assertRaisesRegex(TypeError, r"argument 1 has unexpected type 'str'$"):
+            Klass(1).add('bad')
+
+        # A failure must not affect a subsequent successful call.
+        self.assertEqual(overloaded(3), 3)
@@ -0,0 +1,102 @@
+# SPDX-License-Identifier: BSD-2-Clause
+
+# Copyright (c) 2024 Phil Thompson <phil@riverbankcomputing.com>
+
+
+from utils import SIPTestCase
+
+
+class VirtualsTestCase(SIPTestCase):
+    """ Test Python reimplementations of C++ virtuals. """
+
+    def test_reimplementation(self):
+        """ Test that a reimplementation is called. """
+
+        from .virtuals import Base
+
+        class Derived(Base):
+            def value(self):
+                return 2
+
+        b = Base()
+        d = Derived()
+
+        for _ in range(3):
+            self.assertEqual(b.callValue(), 1)
+            self.assertEqual(d.callValue(), 2)
+            self.assertEqual(d.callOther(), 10)
+
+    def test_modified_type(self):
+        """ Test that modifying a type after a reimplementation has been found
+        is noticed.
+        """
+
+        from .virtuals import Base
+
+        class Middle(Base):
+            def value(self):
+                return 2
+
+        class Derived(Middle):
+            pass
+
+        d = Derived()
+        self.assertEqual(d.callValue(), 2)
+
+        Derived.value = lambda self: 3
+        self.assertEqual(d.callValue(), 3)
+
+        # Modify a super-type.
+        del Derived.value
+        Middle.value = lambda self: 4
+        self.assertEqual(d.callValue(), 4)
+
+    def test_instance_reimplementation(self):
+        """ Test that a reimplementation added to an instance is called. """
+
+        from .virtuals import Base
+
+        class Derived(Base):
+            def value(self):
+                return 2
+
+        d = Derived()
+        self.assertEqual(d.callValue(), 2)
+
+        d.value = lambda: 5
+        self.assertEqual(d.callValue(), 5)
+
+    def test_arguments(self):
+        """ Test that the arguments are passed to a reimplementation. """
+
+        from .virtuals import Base
+
+        class Derived(Base):
+            def scaled(self, v, f):
+                return -v * f
+
+        b = Base()
+        d = Derived()
+
+        self.assertEqual(b.callScaled(3, 0.5), 1.5)
+        self.assertEqual(d.callScaled(3, 0.5), -1.5)
+
+        d.scaled = lambda v, f: v + f
+        self.assertEqual(d.callScaled(3, 0.5), 3.5)
+
+    def test_many_arguments(self):
+        """ Test that a reimplementation with a large number of arguments is
+        called.
+        """
+
+        from .virtuals import Base
+
+        class Derived(Base):
+            def combine(self, *args):
+                return sum(a * a for a in args)
+
+        b = Base()
+        d = Derived()
+
+        self.assertEqual(b.callCombine(), 55)
+        self.assertEqual(d.callCombine(), 385)